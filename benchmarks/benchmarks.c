@@ -0,0 +1,203 @@
+#include "benchmarks.h"
+
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+
+static struct {
+    benchmark_entry_t entries[MAX_BENCHMARKS];
+    size_t count;
+} g_benchmarks = {
+    .count = 0,
+};
+
+void benchmark_register(const char* name, const benchmark_func_t func) {
+    if (g_benchmarks.count >= MAX_BENCHMARKS) {
+        fprintf(stderr, "[ERROR] Cannot add benchmark %s: Maximum number of benchmarks reached (%d)\n", name, MAX_BENCHMARKS);
+        return;
+    }
+
+    g_benchmarks.entries[g_benchmarks.count++] = (benchmark_entry_t) {
+        .name = name,
+        .func = func,
+    };
+}
+
+static uint64_t benchmark_now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (uint64_t) time.tv_sec * 1000000000ULL + (uint64_t) time.tv_nsec;
+}
+
+benchmark_loop_t benchmark_loop_start(const char* label, const size_t bytes) {
+    return (benchmark_loop_t) {
+        .label = label,
+        .bytes = bytes,
+        .iterations = 0,
+        .batch_size = 0,
+        .start_time = 0,
+    };
+}
+
+bool benchmark_loop_next(benchmark_loop_t* loop) {
+    // First call: warm up iteration, not measured
+    if (loop->batch_size == 0) {
+        loop->batch_size = 1;
+        return true;
+    }
+
+    if (loop->start_time == 0) {
+        loop->start_time = benchmark_now();
+        return true;
+    }
+
+    ++loop->iterations;
+
+    // Only read the clock once per batch, to limit the measure overhead on small operations
+    if (loop->iterations % loop->batch_size != 0) {
+        return true;
+    }
+
+    const uint64_t elapsed = benchmark_now() - loop->start_time;
+
+    if (elapsed < BENCHMARK_MIN_DURATION) {
+        if (loop->batch_size < 1024) {
+            loop->batch_size *= 2;
+        }
+
+        return true;
+    }
+
+    const double ns_per_op = (double) elapsed / (double) loop->iterations;
+    const double mb_per_s = (double) loop->bytes * 1000.0 / ns_per_op;
+
+    printf("  %-40s %12zu iterations %14.1f ns/op %10.1f MB/s\n", loop->label, loop->iterations, ns_per_op, mb_per_s);
+
+    return false;
+}
+
+typedef struct {
+    char* buffer;
+    size_t buffer_size;
+    size_t position;
+    bool pretty;
+    size_t depth;
+} benchmark_writer_t;
+
+static void benchmark_write(benchmark_writer_t* writer, const char* format, ...) {
+    if (writer->position >= writer->buffer_size) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    const int written = vsnprintf(writer->buffer + writer->position, writer->buffer_size - writer->position, format, args);
+    va_end(args);
+
+    writer->position = written < 0 ? writer->buffer_size : writer->position + (size_t) written;
+}
+
+static void benchmark_write_line(benchmark_writer_t* writer) {
+    if (!writer->pretty) {
+        return;
+    }
+
+    benchmark_write(writer, "\n%*s", (int) writer->depth * 4, "");
+}
+
+static void benchmark_write_open(benchmark_writer_t* writer, const char* open) {
+    benchmark_write(writer, "%s", open);
+    ++writer->depth;
+    benchmark_write_line(writer);
+}
+
+static void benchmark_write_close(benchmark_writer_t* writer, const char* close) {
+    --writer->depth;
+    benchmark_write_line(writer);
+    benchmark_write(writer, "%s", close);
+}
+
+static void benchmark_write_separator(benchmark_writer_t* writer) {
+    benchmark_write(writer, ",");
+    benchmark_write_line(writer);
+}
+
+static void benchmark_write_key(benchmark_writer_t* writer, const char* key) {
+    benchmark_write(writer, writer->pretty ? "\"%s\": " : "\"%s\":", key);
+}
+
+size_t benchmark_generate_records(char* buffer, const size_t buffer_size, const size_t record_count, const bool pretty) {
+    benchmark_writer_t writer = {
+        .buffer = buffer,
+        .buffer_size = buffer_size,
+        .position = 0,
+        .pretty = pretty,
+        .depth = 0,
+    };
+
+    benchmark_write_open(&writer, "[");
+
+    for (size_t i = 0; i < record_count; ++i) {
+        if (i > 0) {
+            benchmark_write_separator(&writer);
+        }
+
+        benchmark_write_open(&writer, "{");
+        benchmark_write_key(&writer, "id");
+        benchmark_write(&writer, "%zu", 1000000 + i * 7919);
+        benchmark_write_separator(&writer);
+        benchmark_write_key(&writer, "name");
+        benchmark_write(&writer, "\"user %zu with a \\\"quoted\\\" nickname\"", i);
+        benchmark_write_separator(&writer);
+        benchmark_write_key(&writer, "score");
+        benchmark_write(&writer, "%.4f", (double) (i % 1000) * 1.2345);
+        benchmark_write_separator(&writer);
+        benchmark_write_key(&writer, "active");
+        benchmark_write(&writer, i % 3 == 0 ? "true" : "false");
+        benchmark_write_separator(&writer);
+        benchmark_write_key(&writer, "manager");
+        benchmark_write(&writer, "null");
+        benchmark_write_separator(&writer);
+        benchmark_write_key(&writer, "tags");
+        benchmark_write_open(&writer, "[");
+        benchmark_write(&writer, "\"alpha\"");
+        benchmark_write_separator(&writer);
+        benchmark_write(&writer, "\"beta\"");
+        benchmark_write_separator(&writer);
+        benchmark_write(&writer, "%zu", i % 17);
+        benchmark_write_close(&writer, "]");
+        benchmark_write_separator(&writer);
+        benchmark_write_key(&writer, "address");
+        benchmark_write_open(&writer, "{");
+        benchmark_write_key(&writer, "city");
+        benchmark_write(&writer, "\"Paris\"");
+        benchmark_write_separator(&writer);
+        benchmark_write_key(&writer, "zip");
+        benchmark_write(&writer, "%zu", 75000 + i % 20);
+        benchmark_write_close(&writer, "}");
+        benchmark_write_close(&writer, "}");
+    }
+
+    benchmark_write_close(&writer, "]");
+
+    return writer.position < buffer_size ? writer.position : 0;
+}
+
+int main(const int argc, char* argv[]) {
+    setvbuf(stdout, nullptr, _IONBF, 0);
+
+    for (size_t i = 0; i < g_benchmarks.count; ++i) {
+        const benchmark_entry_t benchmark = g_benchmarks.entries[i];
+
+        // Only run the benchmarks whose name contains the first argument, if given
+        if (argc > 1 && strstr(benchmark.name, argv[1]) == nullptr) {
+            continue;
+        }
+
+        printf("[BENCH] %s\n", benchmark.name);
+        benchmark.func();
+    }
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+#ifndef JSON_BENCHMARKS_H
+#define JSON_BENCHMARKS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define MAX_BENCHMARKS 64
+
+/**
+ * Minimum duration of each measure, in nanoseconds.
+ */
+#define BENCHMARK_MIN_DURATION 200000000ULL
+
+#define BENCHMARK(benchmark_name) \
+    static void benchmark_func_##benchmark_name(void); \
+    __attribute__((constructor)) static void register_benchmark_##benchmark_name() { \
+        benchmark_register(#benchmark_name, benchmark_func_##benchmark_name); \
+    } \
+    static void benchmark_func_##benchmark_name(void)
+
+/**
+ * Repeat the following statement until the minimal duration is reached, then print the measure.
+ *
+ * @param label The label of the measure.
+ * @param bytes The number of bytes processed by each iteration, used to compute the throughput.
+ */
+#define BENCHMARK_LOOP(label, bytes) \
+    for (benchmark_loop_t loop = benchmark_loop_start(label, bytes); benchmark_loop_next(&loop);)
+
+typedef void (*benchmark_func_t)(void);
+
+typedef struct {
+    const char* name;
+    benchmark_func_t func;
+} benchmark_entry_t;
+
+typedef struct {
+    const char* label;
+    size_t bytes;
+    size_t iterations;
+    size_t batch_size;
+    uint64_t start_time;
+} benchmark_loop_t;
+
+void benchmark_register(const char* name, benchmark_func_t func);
+benchmark_loop_t benchmark_loop_start(const char* label, size_t bytes);
+bool benchmark_loop_next(benchmark_loop_t* loop);
+
+/**
+ * Prevent the compiler from optimizing out a computed value.
+ */
+#define BENCHMARK_USE(value) __asm__ volatile("" : : "g"(value) : "memory")
+
+/**
+ * Generate a JSON document containing an array of records with strings, numbers, booleans, null and nested values.
+ * The output is the same document, either minified or pretty-printed with a 4 spaces indentation.
+ *
+ * @return The length of the generated document, or 0 if the buffer is too small.
+ */
+size_t benchmark_generate_records(char* buffer, size_t buffer_size, size_t record_count, bool pretty);
+
+#endif //JSON_BENCHMARKS_H
@@ -0,0 +1,1288 @@
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "benchmarks.h"
+#include "../parser/file.h"
+#include "../parser/ndjson.h"
+#include "../parser/parser.h"
+#include "../parser/push_parser.h"
+#include "../parser/query.h"
+#include "../parser/reader.h"
+#include "../parser/tape.h"
+#include "../parser/value_parser.h"
+#include "../type/arena_pool.h"
+
+static json_parser_options_t benchmark_parser_options() {
+    return json_default_parser_options((json_parser_options_t) {
+        .max_depth = 32,
+        .max_struct_size = 1000000,
+    });
+}
+
+BENCHMARK(whitespace) {
+    constexpr size_t record_count = 10000;
+    constexpr size_t buffer_size = 8 * 1024 * 1024;
+    char* minified = malloc(buffer_size);
+    char* pretty = malloc(buffer_size);
+    const size_t minified_length = benchmark_generate_records(minified, buffer_size, record_count, false);
+    const size_t pretty_length = benchmark_generate_records(pretty, buffer_size, record_count, true);
+    json_parser_handler_t handler = {};
+
+    BENCHMARK_LOOP("json_parse minified", minified_length) {
+        BENCHMARK_USE(json_parse(minified_length, minified, &handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_parse pretty-printed", pretty_length) {
+        BENCHMARK_USE(json_parse(pretty_length, pretty, &handler, benchmark_parser_options()).code);
+    }
+
+    free(minified);
+    free(pretty);
+}
+
+BENCHMARK(indexed_parser) {
+    constexpr size_t record_count = 50000;
+    constexpr size_t buffer_size = 32 * 1024 * 1024;
+    char* minified = malloc(buffer_size);
+    char* pretty = malloc(buffer_size);
+    const size_t minified_length = benchmark_generate_records(minified, buffer_size, record_count, false);
+    const size_t pretty_length = benchmark_generate_records(pretty, buffer_size, record_count, true);
+    json_parser_handler_t handler = {};
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+
+    BENCHMARK_LOOP("json_parse minified", minified_length) {
+        BENCHMARK_USE(json_parse(minified_length, minified, &handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_parse_indexed minified", minified_length) {
+        BENCHMARK_USE(json_parse_indexed(minified_length, minified, &handler, benchmark_parser_options(), JSON_PARSER_STACK_SIZE(32), stack).code);
+    }
+
+    BENCHMARK_LOOP("json_parse pretty-printed", pretty_length) {
+        BENCHMARK_USE(json_parse(pretty_length, pretty, &handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_parse_indexed pretty-printed", pretty_length) {
+        BENCHMARK_USE(json_parse_indexed(pretty_length, pretty, &handler, benchmark_parser_options(), JSON_PARSER_STACK_SIZE(32), stack).code);
+    }
+
+    // Long strings, like log messages or base64 blobs
+    constexpr size_t string_count = 2000;
+    constexpr size_t string_length = 2000;
+    char* strings = malloc(string_count * (string_length + 3) + 2);
+    size_t strings_length = 0;
+
+    strings[strings_length++] = '[';
+
+    for (size_t i = 0; i < string_count; ++i) {
+        strings[strings_length++] = '"';
+
+        for (size_t j = 0; j < string_length; ++j) {
+            strings[strings_length++] = (char) ('A' + (i + j) % 26);
+        }
+
+        strings[strings_length++] = '"';
+        strings[strings_length++] = i + 1 < string_count ? ',' : ']';
+    }
+
+    const json_parser_options_t strings_options = json_default_parser_options((json_parser_options_t) {
+        .max_struct_size = 1000000,
+    });
+
+    BENCHMARK_LOOP("json_parse long strings", strings_length) {
+        BENCHMARK_USE(json_parse(strings_length, strings, &handler, strings_options).code);
+    }
+
+    BENCHMARK_LOOP("json_parse_indexed long strings", strings_length) {
+        BENCHMARK_USE(json_parse_indexed(strings_length, strings, &handler, strings_options, JSON_PARSER_STACK_SIZE(32), stack).code);
+    }
+
+    free(minified);
+    free(pretty);
+    free(strings);
+}
+
+BENCHMARK(iterative_parser) {
+    constexpr size_t record_count = 50000;
+    constexpr size_t buffer_size = 32 * 1024 * 1024;
+    char* records = malloc(buffer_size);
+    const size_t records_length = benchmark_generate_records(records, buffer_size, record_count, false);
+    json_parser_handler_t handler = {};
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+
+    BENCHMARK_LOOP("json_parse records", records_length) {
+        BENCHMARK_USE(json_parse(records_length, records, &handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_parse_iterative records", records_length) {
+        BENCHMARK_USE(json_parse_iterative(records_length, records, &handler, benchmark_parser_options(), JSON_PARSER_STACK_SIZE(32), stack).code);
+    }
+
+    // Deeply nested arrays, where the recursive parser pays a call chain per level
+    constexpr size_t nesting = 10000;
+    constexpr size_t nested_count = 100;
+    const size_t nested_length = 2 * nesting * nested_count + nested_count + 1;
+    char* nested = malloc(nested_length);
+    size_t position = 0;
+
+    nested[position++] = '[';
+
+    for (size_t i = 0; i < nested_count; ++i) {
+        memset(nested + position, '[', nesting);
+        memset(nested + position + nesting, ']', nesting);
+        position += 2 * nesting;
+        nested[position++] = i + 1 < nested_count ? ',' : ']';
+    }
+
+    const json_parser_options_t nested_options = json_default_parser_options((json_parser_options_t) {
+        .max_depth = 2 * nesting + 2,
+    });
+    json_parser_frame_t* nested_stack = malloc(JSON_PARSER_STACK_SIZE(nested_options.max_depth) * sizeof(json_parser_frame_t));
+
+    BENCHMARK_LOOP("json_parse nested", nested_length) {
+        BENCHMARK_USE(json_parse(nested_length, nested, &handler, nested_options).code);
+    }
+
+    BENCHMARK_LOOP("json_parse_iterative nested", nested_length) {
+        BENCHMARK_USE(json_parse_iterative(nested_length, nested, &handler, nested_options, JSON_PARSER_STACK_SIZE(nested_options.max_depth), nested_stack).code);
+    }
+
+    free(records);
+    free(nested);
+    free(nested_stack);
+}
+
+BENCHMARK(push_parser) {
+    constexpr size_t record_count = 50000;
+    constexpr size_t buffer_size = 32 * 1024 * 1024;
+    char* records = malloc(buffer_size);
+    const size_t records_length = benchmark_generate_records(records, buffer_size, record_count, false);
+    const json_parser_options_t options = json_default_parser_options(benchmark_parser_options());
+    json_parser_handler_t handler = {};
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+    char* token_buffer = malloc(JSON_PUSH_PARSER_BUFFER_SIZE(options.max_string_size));
+
+    BENCHMARK_LOOP("json_parse records", records_length) {
+        BENCHMARK_USE(json_parse(records_length, records, &handler, options).code);
+    }
+
+    // Chunks of the size of a TCP segment payload, and of a typical read buffer
+    const size_t chunk_sizes[] = { 1460, 16384 };
+
+    for (size_t i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++i) {
+        const size_t chunk_size = chunk_sizes[i];
+        char label[64];
+        snprintf(label, sizeof(label), "json_parser_feed records by %zu bytes", chunk_size);
+
+        BENCHMARK_LOOP(label, records_length) {
+            json_push_parser_t parser;
+            json_push_parser_init(&parser, &handler, options, JSON_PARSER_STACK_SIZE(32), stack, JSON_PUSH_PARSER_BUFFER_SIZE(options.max_string_size), token_buffer);
+
+            for (size_t position = 0; position < records_length; position += chunk_size) {
+                const size_t length = records_length - position < chunk_size ? records_length - position : chunk_size;
+                json_parser_feed(&parser, length, records + position);
+            }
+
+            BENCHMARK_USE(json_parser_finish(&parser).code);
+        }
+    }
+
+    free(records);
+    free(token_buffer);
+}
+
+static double benchmark_number_sum;
+
+static json_parser_result_t benchmark_on_number(json_parser_handler_t* self, const double value) {
+    benchmark_number_sum += value;
+
+    return json_create_success_result();
+}
+
+BENCHMARK(numbers) {
+    constexpr size_t number_count = 200000;
+    constexpr size_t buffer_size = 8 * 1024 * 1024;
+    char* numbers = malloc(buffer_size);
+    size_t numbers_length = 0;
+
+    // Mix of integers, decimals like coordinates or prices, and numbers in scientific notation
+    srand(42);
+    numbers[numbers_length++] = '[';
+
+    for (size_t i = 0; i < number_count; ++i) {
+        const char* separator = i + 1 < number_count ? "," : "]";
+
+        switch (i % 4) {
+            case 0:
+                numbers_length += snprintf(numbers + numbers_length, buffer_size - numbers_length, "%d%s", rand() - RAND_MAX / 2, separator);
+                break;
+
+            case 1:
+                numbers_length += snprintf(numbers + numbers_length, buffer_size - numbers_length, "%.2f%s", rand() / 1000.0, separator);
+                break;
+
+            case 2:
+                numbers_length += snprintf(numbers + numbers_length, buffer_size - numbers_length, "%.17g%s", rand() / (double) RAND_MAX * 360.0 - 180.0, separator);
+                break;
+
+            default:
+                numbers_length += snprintf(numbers + numbers_length, buffer_size - numbers_length, "%.6e%s", rand() * 1e-20 * (double) (rand() % 1000), separator);
+                break;
+        }
+    }
+
+    json_parser_handler_t handler = { .on_number = benchmark_on_number };
+    json_parser_handler_t empty_handler = {};
+
+    BENCHMARK_LOOP("json_parse numbers", numbers_length) {
+        BENCHMARK_USE(json_parse(numbers_length, numbers, &handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_parse numbers without on_number", numbers_length) {
+        BENCHMARK_USE(json_parse(numbers_length, numbers, &empty_handler, benchmark_parser_options()).code);
+    }
+
+    // Reference: conversion of the same numbers with strtod(), without any JSON parsing
+    BENCHMARK_LOOP("strtod numbers", numbers_length) {
+        char* current = numbers + 1;
+
+        while (current < numbers + numbers_length) {
+            benchmark_number_sum += strtod(current, &current);
+            ++current;
+        }
+    }
+
+    BENCHMARK_USE(benchmark_number_sum);
+
+    free(numbers);
+}
+
+static int64_t benchmark_integer_sum;
+
+static json_parser_result_t benchmark_on_integer(json_parser_handler_t* self, const int64_t value) {
+    benchmark_integer_sum += value;
+
+    return json_create_success_result();
+}
+
+BENCHMARK(integers) {
+    constexpr size_t number_count = 200000;
+    constexpr size_t buffer_size = 8 * 1024 * 1024;
+    char* numbers = malloc(buffer_size);
+    size_t numbers_length = 0;
+
+    // Large identifiers, like database keys or snowflake ids
+    srand(42);
+    numbers[numbers_length++] = '[';
+
+    for (size_t i = 0; i < number_count; ++i) {
+        const int64_t id = ((int64_t) rand() << 31 | rand()) & INT64_MAX;
+        numbers_length += snprintf(numbers + numbers_length, buffer_size - numbers_length, "%lld%s", (long long) id, i + 1 < number_count ? "," : "]");
+    }
+
+    json_parser_handler_t number_handler = { .on_number = benchmark_on_number };
+    json_parser_handler_t integer_handler = { .on_number = benchmark_on_number, .on_integer = benchmark_on_integer };
+
+    BENCHMARK_LOOP("json_parse ids with on_number", numbers_length) {
+        BENCHMARK_USE(json_parse(numbers_length, numbers, &number_handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_parse ids with on_integer", numbers_length) {
+        BENCHMARK_USE(json_parse(numbers_length, numbers, &integer_handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_USE(benchmark_number_sum);
+    BENCHMARK_USE(benchmark_integer_sum);
+
+    free(numbers);
+}
+
+static size_t benchmark_event_count;
+
+static json_parser_result_t benchmark_on_event(json_parser_handler_t* self) {
+    ++benchmark_event_count;
+
+    return json_create_success_result();
+}
+
+static json_parser_result_t benchmark_on_bool_event(json_parser_handler_t* self, const bool value) {
+    return benchmark_on_event(self);
+}
+
+static json_parser_result_t benchmark_on_number_event(json_parser_handler_t* self, const double value) {
+    return benchmark_on_event(self);
+}
+
+static json_parser_result_t benchmark_on_integer_event(json_parser_handler_t* self, const int64_t value) {
+    return benchmark_on_event(self);
+}
+
+static json_parser_result_t benchmark_on_string_event(json_parser_handler_t* self, const json_raw_string_t value) {
+    return benchmark_on_event(self);
+}
+
+BENCHMARK(reader) {
+    constexpr size_t record_count = 50000;
+    constexpr size_t buffer_size = 32 * 1024 * 1024;
+    char* records = malloc(buffer_size);
+    const size_t records_length = benchmark_generate_records(records, buffer_size, record_count, false);
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+
+    // Count all the events, so both interfaces do the same work for each of them
+    json_parser_handler_t handler = {
+        .on_null = benchmark_on_event,
+        .on_bool = benchmark_on_bool_event,
+        .on_number = benchmark_on_number_event,
+        .on_integer = benchmark_on_integer_event,
+        .on_string = benchmark_on_string_event,
+        .on_array_start = benchmark_on_event,
+        .on_array_end = benchmark_on_event,
+        .on_object_start = benchmark_on_event,
+        .on_object_property = benchmark_on_string_event,
+        .on_object_end = benchmark_on_event,
+    };
+
+    BENCHMARK_LOOP("json_parse records", records_length) {
+        BENCHMARK_USE(json_parse(records_length, records, &handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_parse_iterative records", records_length) {
+        BENCHMARK_USE(json_parse_iterative(records_length, records, &handler, benchmark_parser_options(), JSON_PARSER_STACK_SIZE(32), stack).code);
+    }
+
+    BENCHMARK_LOOP("json_reader_next records", records_length) {
+        json_reader_t reader;
+        json_token_t token;
+        json_reader_init(&reader, records_length, records, benchmark_parser_options(), JSON_PARSER_STACK_SIZE(32), stack);
+
+        while (json_reader_next(&reader, &token) > JSON_TOKEN_END) {
+            ++benchmark_event_count;
+        }
+    }
+
+    BENCHMARK_USE(benchmark_event_count);
+
+    free(records);
+}
+
+#define JSON_PARSER_NAME benchmark_count_events
+#define JSON_PARSER_HANDLER_TYPE size_t
+#define JSON_PARSER_ON_NULL(count) (++*(count), json_create_success_result())
+#define JSON_PARSER_ON_BOOL(count, value) (++*(count), json_create_success_result())
+#define JSON_PARSER_ON_NUMBER(count, value) (++*(count), json_create_success_result())
+#define JSON_PARSER_ON_STRING(count, value) (++*(count), json_create_success_result())
+#define JSON_PARSER_ON_ARRAY_START(count) (++*(count), json_create_success_result())
+#define JSON_PARSER_ON_ARRAY_END(count) (++*(count), json_create_success_result())
+#define JSON_PARSER_ON_OBJECT_START(count) (++*(count), json_create_success_result())
+#define JSON_PARSER_ON_OBJECT_PROPERTY(count, key) (++*(count), json_create_success_result())
+#define JSON_PARSER_ON_OBJECT_END(count) (++*(count), json_create_success_result())
+#define JSON_PARSER_ON_INTEGER(count, value) (++*(count), json_create_success_result())
+#define JSON_PARSER_MAX_DEPTH 32
+#define JSON_PARSER_MAX_STRUCT_SIZE 1000000
+#include "../parser/parser_template.h"
+
+#define JSON_PARSER_NAME benchmark_count_integers
+#define JSON_PARSER_HANDLER_TYPE size_t
+#define JSON_PARSER_ON_INTEGER(count, value) (++*(count), json_create_success_result())
+#define JSON_PARSER_MAX_DEPTH 32
+#define JSON_PARSER_MAX_STRUCT_SIZE 1000000
+#include "../parser/parser_template.h"
+
+BENCHMARK(parser_template) {
+    constexpr size_t record_count = 50000;
+    constexpr size_t buffer_size = 32 * 1024 * 1024;
+    char* records = malloc(buffer_size);
+    const size_t records_length = benchmark_generate_records(records, buffer_size, record_count, false);
+
+    json_parser_handler_t handler = {
+        .on_null = benchmark_on_event,
+        .on_bool = benchmark_on_bool_event,
+        .on_number = benchmark_on_number_event,
+        .on_integer = benchmark_on_integer_event,
+        .on_string = benchmark_on_string_event,
+        .on_array_start = benchmark_on_event,
+        .on_array_end = benchmark_on_event,
+        .on_object_start = benchmark_on_event,
+        .on_object_property = benchmark_on_string_event,
+        .on_object_end = benchmark_on_event,
+    };
+    json_parser_handler_t integer_handler = { .on_integer = benchmark_on_integer_event };
+
+    BENCHMARK_LOOP("json_parse all events", records_length) {
+        BENCHMARK_USE(json_parse(records_length, records, &handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("specialized parser all events", records_length) {
+        BENCHMARK_USE(benchmark_count_events(records_length, records, &benchmark_event_count, (json_parser_options_t) {}).code);
+    }
+
+    BENCHMARK_LOOP("json_parse integers only", records_length) {
+        BENCHMARK_USE(json_parse(records_length, records, &integer_handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("specialized parser integers only", records_length) {
+        BENCHMARK_USE(benchmark_count_integers(records_length, records, &benchmark_event_count, (json_parser_options_t) {}).code);
+    }
+
+    BENCHMARK_USE(benchmark_event_count);
+
+    free(records);
+}
+
+static double benchmark_sum_scores_value(const json_value_t* records) {
+    double sum = 0;
+
+    for (const json_member_entry_t* record = records->array_value.head; record != nullptr; record = record->next) {
+        for (const json_member_entry_t* property = record->value->object_value.head; property != nullptr; property = property->next) {
+            if (property->key_int == 5 && memcmp(property->key_str, "score", 5) == 0) {
+                sum += property->value->number_value;
+                break;
+            }
+        }
+    }
+
+    return sum;
+}
+
+static double benchmark_sum_scores_tape(const json_tape_t* tape) {
+    double sum = 0;
+
+    for (size_t record = 1; json_tape_type(tape, record) != JSON_TAPE_ARRAY_END; record = json_tape_next(tape, record)) {
+        sum += json_tape_number(tape, json_tape_object_get(tape, record, "score", 5));
+    }
+
+    return sum;
+}
+
+BENCHMARK(tape) {
+    constexpr size_t record_count = 50000;
+    constexpr size_t buffer_size = 32 * 1024 * 1024;
+    char* records = malloc(buffer_size);
+    const size_t records_length = benchmark_generate_records(records, buffer_size, record_count, false);
+
+    // Each record has 16 values and 15 members
+    const size_t string_pool_size = records_length;
+    const size_t value_pool_size = record_count * 16 + 1;
+    const size_t key_pool_size = record_count * 16;
+    const size_t arena_size = json_arena_size(string_pool_size, value_pool_size, key_pool_size);
+    json_arena_t* arena = malloc(arena_size);
+    json_value_t* stack[32];
+    json_value_t* value = nullptr;
+
+    uint64_t* words = malloc(JSON_TAPE_SIZE(records_length) * sizeof(uint64_t));
+    char* strings = malloc(JSON_TAPE_STRINGS_SIZE(records_length));
+    json_tape_number_t* numbers = malloc(JSON_TAPE_NUMBERS_SIZE(records_length) * sizeof(json_tape_number_t));
+    json_tape_t tape;
+    json_tape_init(&tape, JSON_TAPE_SIZE(records_length), words, JSON_TAPE_STRINGS_SIZE(records_length), strings, JSON_TAPE_NUMBERS_SIZE(records_length), numbers);
+
+    BENCHMARK_LOOP("json_parse_value records", records_length) {
+        json_arena_init(arena, arena_size, string_pool_size, value_pool_size, key_pool_size);
+        const json_value_parser_result_t result = json_parse_value(records_length, records, arena, 32, stack, benchmark_parser_options());
+        value = result.value;
+        BENCHMARK_USE(result.result.code);
+    }
+
+    BENCHMARK_LOOP("json_parse_to_tape records", records_length) {
+        BENCHMARK_USE(json_parse_to_tape(records_length, records, &tape, benchmark_parser_options()).code);
+    }
+
+    if (value == nullptr || tape.used == 0 || benchmark_sum_scores_value(value) != benchmark_sum_scores_tape(&tape)) {
+        printf("  Invalid parsing result\n");
+    }
+
+    BENCHMARK_LOOP("sum scores on json_value_t", records_length) {
+        BENCHMARK_USE(benchmark_sum_scores_value(value));
+    }
+
+    BENCHMARK_LOOP("sum scores on tape", records_length) {
+        BENCHMARK_USE(benchmark_sum_scores_tape(&tape));
+    }
+
+    free(records);
+    free(arena);
+    free(words);
+    free(strings);
+    free(numbers);
+}
+
+/**
+ * Convert the array of records to NDJSON, by replacing the separators of the root array by line feeds
+ */
+static size_t benchmark_records_to_ndjson(char* records, const size_t length) {
+    size_t depth = 0;
+    size_t ndjson_length = 0;
+    bool in_string = false;
+
+    for (size_t i = 0; i < length; ++i) {
+        const char c = records[i];
+
+        if (in_string) {
+            if (c == '\\') {
+                records[ndjson_length++] = records[i++];
+            } else if (c == '"') {
+                in_string = false;
+            }
+        } else if (c == '"') {
+            in_string = true;
+        } else if (c == '[' || c == '{') {
+            if (depth++ == 0) {
+                continue;
+            }
+        } else if (c == ']' || c == '}') {
+            if (--depth == 0) {
+                continue;
+            }
+        } else if (c == ',' && depth == 1) {
+            records[ndjson_length++] = '\n';
+            continue;
+        }
+
+        records[ndjson_length++] = records[i];
+    }
+
+    return ndjson_length;
+}
+
+typedef struct {
+    json_ndjson_handler_t handler;
+    size_t count;
+} benchmark_ndjson_handler_t;
+
+static json_parser_result_t benchmark_on_record(json_ndjson_handler_t* self, const json_ndjson_record_t* record) {
+    ((benchmark_ndjson_handler_t*) self)->count += record->result.result.code == JSON_PARSE_SUCCESS;
+
+    return json_create_success_result();
+}
+
+BENCHMARK(ndjson) {
+    constexpr size_t record_count = 50000;
+    constexpr size_t buffer_size = 32 * 1024 * 1024;
+    constexpr size_t max_workers = 4;
+    constexpr size_t batch_size = 1024;
+    char* records = malloc(buffer_size);
+    const size_t records_length = benchmark_records_to_ndjson(records, benchmark_generate_records(records, buffer_size, record_count, false));
+
+    // Each record has 16 values and 15 members
+    const size_t string_pool_size = records_length;
+    const size_t value_pool_size = batch_size * 16;
+    const size_t key_pool_size = batch_size * 16;
+    const size_t arena_size = json_arena_size(string_pool_size, value_pool_size, key_pool_size);
+    json_arena_t* arenas[max_workers];
+    json_ndjson_record_t* ndjson_records = malloc(JSON_NDJSON_RECORDS_SIZE(max_workers, batch_size) * sizeof(json_ndjson_record_t));
+    json_value_t* stacks[JSON_NDJSON_STACKS_SIZE(max_workers, 32)];
+    benchmark_ndjson_handler_t handler = { .handler = { benchmark_on_record } };
+
+    for (size_t i = 0; i < max_workers; ++i) {
+        arenas[i] = malloc(arena_size);
+        json_arena_init(arenas[i], arena_size, string_pool_size, value_pool_size, key_pool_size);
+    }
+
+    BENCHMARK_LOOP("json_parse_value line by line", records_length) {
+        json_value_t* stack[32];
+        size_t count = 0;
+
+        for (size_t position = 0; position < records_length;) {
+            const char* line_end = memchr(records + position, '\n', records_length - position);
+            const size_t end = line_end == nullptr ? records_length : (size_t) (line_end - records);
+
+            json_arena_reset(arenas[0]);
+            count += json_parse_value(end - position, records + position, arenas[0], 32, stack, benchmark_parser_options()).result.code == JSON_PARSE_SUCCESS;
+            position = end + 1;
+        }
+
+        BENCHMARK_USE(count);
+    }
+
+    for (size_t worker_count = 1; worker_count <= max_workers; worker_count *= 2) {
+        char label[64];
+        snprintf(label, sizeof(label), "json_parse_ndjson %zu worker(s)", worker_count);
+
+        BENCHMARK_LOOP(label, records_length) {
+            handler.count = 0;
+            BENCHMARK_USE(json_parse_ndjson(records_length, records, &handler.handler, benchmark_parser_options(), worker_count, arenas, 32, stacks, batch_size, ndjson_records).code);
+        }
+
+        if (handler.count != record_count) {
+            printf("  Invalid parsing result\n");
+        }
+    }
+
+    for (size_t i = 0; i < max_workers; ++i) {
+        free(arenas[i]);
+    }
+
+    free(ndjson_records);
+    free(records);
+}
+
+BENCHMARK(parallel_value) {
+    constexpr size_t record_count = 50000;
+    constexpr size_t buffer_size = 32 * 1024 * 1024;
+    constexpr size_t max_workers = 4;
+    char* records = malloc(buffer_size);
+    const size_t records_length = benchmark_generate_records(records, buffer_size, record_count, false);
+
+    // Each record has 16 values and 15 members: each arena can hold the whole document
+    const size_t string_pool_size = records_length;
+    const size_t value_pool_size = record_count * 16 + 1;
+    const size_t key_pool_size = record_count * 16;
+    const size_t arena_size = json_arena_size(string_pool_size, value_pool_size, key_pool_size);
+    json_arena_t* arenas[max_workers];
+    json_value_t* stacks[JSON_VALUE_PARSER_STACKS_SIZE(max_workers, 32)];
+
+    for (size_t i = 0; i < max_workers; ++i) {
+        arenas[i] = malloc(arena_size);
+    }
+
+    BENCHMARK_LOOP("json_parse_value records", records_length) {
+        json_value_t* stack[32];
+        json_arena_init(arenas[0], arena_size, string_pool_size, value_pool_size, key_pool_size);
+        BENCHMARK_USE(json_parse_value(records_length, records, arenas[0], 32, stack, benchmark_parser_options()).result.code);
+    }
+
+    for (size_t worker_count = 1; worker_count <= max_workers; worker_count *= 2) {
+        char label[64];
+        size_t length = 0;
+        snprintf(label, sizeof(label), "json_parse_value_parallel %zu thread(s)", worker_count);
+
+        BENCHMARK_LOOP(label, records_length) {
+            for (size_t i = 0; i < worker_count; ++i) {
+                json_arena_init(arenas[i], arena_size, string_pool_size, value_pool_size, key_pool_size);
+            }
+
+            const json_value_parser_result_t result = json_parse_value_parallel(records_length, records, worker_count, arenas, 32, stacks, benchmark_parser_options());
+            length = result.value == nullptr ? 0 : result.value->array_value.length;
+        }
+
+        if (length != record_count) {
+            printf("  Invalid parsing result\n");
+        }
+    }
+
+    for (size_t i = 0; i < max_workers; ++i) {
+        free(arenas[i]);
+    }
+
+    free(records);
+}
+
+BENCHMARK(validate) {
+    constexpr size_t record_count = 50000;
+    constexpr size_t buffer_size = 32 * 1024 * 1024;
+    char* minified = malloc(buffer_size);
+    char* pretty = malloc(buffer_size);
+    const size_t minified_length = benchmark_generate_records(minified, buffer_size, record_count, false);
+    const size_t pretty_length = benchmark_generate_records(pretty, buffer_size, record_count, true);
+    json_parser_handler_t handler = {};
+
+    if (json_validate(minified_length, minified, benchmark_parser_options()).code != JSON_PARSE_SUCCESS) {
+        printf("  Invalid validation result\n");
+    }
+
+    BENCHMARK_LOOP("json_parse minified", minified_length) {
+        BENCHMARK_USE(json_parse(minified_length, minified, &handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_validate minified", minified_length) {
+        BENCHMARK_USE(json_validate(minified_length, minified, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_parse pretty-printed", pretty_length) {
+        BENCHMARK_USE(json_parse(pretty_length, pretty, &handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_validate pretty-printed", pretty_length) {
+        BENCHMARK_USE(json_validate(pretty_length, pretty, benchmark_parser_options()).code);
+    }
+
+    // Long strings with some multi-byte characters, which must be checked by the validator
+    constexpr size_t string_count = 2000;
+    constexpr size_t string_length = 2000;
+    char* strings = malloc(string_count * (string_length + 3) + 2);
+    size_t strings_length = 0;
+
+    strings[strings_length++] = '[';
+
+    for (size_t i = 0; i < string_count; ++i) {
+        strings[strings_length++] = '"';
+
+        for (size_t j = 0; j < string_length; j += 50) {
+            memset(strings + strings_length, 'A' + (i + j) % 26, 48);
+            strings_length += 48;
+            // U+00E9
+            strings[strings_length++] = (char) 0xC3;
+            strings[strings_length++] = (char) 0xA9;
+        }
+
+        strings[strings_length++] = '"';
+        strings[strings_length++] = i + 1 < string_count ? ',' : ']';
+    }
+
+    const json_parser_options_t strings_options = json_default_parser_options((json_parser_options_t) {
+        .max_struct_size = 1000000,
+    });
+
+    BENCHMARK_LOOP("json_parse long strings", strings_length) {
+        BENCHMARK_USE(json_parse(strings_length, strings, &handler, strings_options).code);
+    }
+
+    BENCHMARK_LOOP("json_validate long strings", strings_length) {
+        BENCHMARK_USE(json_validate(strings_length, strings, strings_options).code);
+    }
+
+    free(minified);
+    free(pretty);
+    free(strings);
+}
+
+/**
+ * Fill the buffer with an array of strings, repeating the given text
+ */
+static size_t benchmark_generate_strings(char* buffer, const size_t string_count, const size_t string_length, const char* text) {
+    const size_t text_length = strlen(text);
+    size_t length = 0;
+
+    buffer[length++] = '[';
+
+    for (size_t i = 0; i < string_count; ++i) {
+        buffer[length++] = '"';
+
+        for (size_t j = 0; j < string_length; j += text_length) {
+            memcpy(buffer + length, text, text_length);
+            length += text_length;
+        }
+
+        buffer[length++] = '"';
+        buffer[length++] = i + 1 < string_count ? ',' : ']';
+    }
+
+    return length;
+}
+
+BENCHMARK(utf8) {
+    constexpr size_t string_count = 2000;
+    constexpr size_t string_length = 2000;
+    char* strings = malloc(string_count * (string_length + 64) + 2);
+    json_parser_handler_t handler = {};
+    const json_parser_options_t options = json_default_parser_options((json_parser_options_t) {
+        .max_struct_size = 1000000,
+    });
+    const struct {
+        const char* name;
+        const char* text;
+    } texts[] = {
+        { "ASCII", "The quick brown fox jumps over the lazy dog. " },
+        // 2 bytes sequences between ASCII words
+        { "latin", "L'\xC3\xA9t\xC3\xA9 \xC3\xA0 la for\xC3\xAAt, o\xC3\xB9 le ma\xC3\xAEtre " },
+        // 3 bytes sequences only
+        { "CJK", "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E\xE3\x81\xAE\xE6\x96\x87\xE7\xAB\xA0" },
+    };
+
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i) {
+        const size_t strings_length = benchmark_generate_strings(strings, string_count, string_length, texts[i].text);
+        char name[64];
+
+        if (json_parse(strings_length, strings, &handler, options).code != JSON_PARSE_SUCCESS) {
+            printf("  Invalid parsing result\n");
+        }
+
+        snprintf(name, sizeof(name), "json_parse %s strings", texts[i].name);
+
+        BENCHMARK_LOOP(name, strings_length) {
+            BENCHMARK_USE(json_parse(strings_length, strings, &handler, options).code);
+        }
+
+        snprintf(name, sizeof(name), "json_validate %s strings", texts[i].name);
+
+        BENCHMARK_LOOP(name, strings_length) {
+            BENCHMARK_USE(json_validate(strings_length, strings, options).code);
+        }
+    }
+
+    free(strings);
+}
+
+/**
+ * Only keep the "id" and "score" properties of the records, and skip the other values
+ */
+static json_parser_result_t benchmark_on_property_skip(json_parser_handler_t* self, const json_raw_string_t key) {
+    ++benchmark_event_count;
+
+    if ((key.length == 4 && memcmp(key.value, "\"id\"", 4) == 0) || (key.length == 7 && memcmp(key.value, "\"score\"", 7) == 0)) {
+        return json_create_success_result();
+    }
+
+    return json_create_skip_result();
+}
+
+BENCHMARK(skip) {
+    constexpr size_t record_count = 50000;
+    constexpr size_t buffer_size = 32 * 1024 * 1024;
+    char* minified = malloc(buffer_size);
+    char* pretty = malloc(buffer_size);
+    const size_t minified_length = benchmark_generate_records(minified, buffer_size, record_count, false);
+    const size_t pretty_length = benchmark_generate_records(pretty, buffer_size, record_count, true);
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+
+    json_parser_handler_t handler = {
+        .on_number = benchmark_on_number_event,
+        .on_integer = benchmark_on_integer_event,
+        .on_object_property = benchmark_on_string_event,
+    };
+    json_parser_handler_t skip_handler = {
+        .on_number = benchmark_on_number_event,
+        .on_integer = benchmark_on_integer_event,
+        .on_object_property = benchmark_on_property_skip,
+    };
+
+    if (json_parse(minified_length, minified, &skip_handler, benchmark_parser_options()).code != JSON_PARSE_SUCCESS) {
+        printf("  Invalid parsing result\n");
+    }
+
+    BENCHMARK_LOOP("json_parse all properties", minified_length) {
+        BENCHMARK_USE(json_parse(minified_length, minified, &handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_parse skip properties", minified_length) {
+        BENCHMARK_USE(json_parse(minified_length, minified, &skip_handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_parse_indexed skip properties", minified_length) {
+        BENCHMARK_USE(json_parse_indexed(minified_length, minified, &skip_handler, benchmark_parser_options(), JSON_PARSER_STACK_SIZE(32), stack).code);
+    }
+
+    BENCHMARK_LOOP("json_parse_iterative skip properties", minified_length) {
+        BENCHMARK_USE(json_parse_iterative(minified_length, minified, &skip_handler, benchmark_parser_options(), JSON_PARSER_STACK_SIZE(32), stack).code);
+    }
+
+    BENCHMARK_LOOP("json_parse all properties pretty-printed", pretty_length) {
+        BENCHMARK_USE(json_parse(pretty_length, pretty, &handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_parse skip properties pretty-printed", pretty_length) {
+        BENCHMARK_USE(json_parse(pretty_length, pretty, &skip_handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_USE(benchmark_event_count);
+
+    free(minified);
+    free(pretty);
+}
+
+BENCHMARK(extract) {
+    constexpr size_t record_count = 50000;
+    constexpr size_t buffer_size = 32 * 1024 * 1024;
+    char* records = malloc(buffer_size);
+    const size_t records_length = benchmark_generate_records(records, buffer_size, record_count, false);
+    json_parser_handler_t handler = {};
+    json_raw_string_t value;
+
+    if (json_extract(records_length, records, "/49999/address/zip", benchmark_parser_options(), &value).code != JSON_PARSE_SUCCESS || value.value == nullptr) {
+        printf("  Invalid extraction result\n");
+    }
+
+    // The throughput is relative to the whole document, to compare with a full parsing
+    BENCHMARK_LOOP("json_parse whole document", records_length) {
+        BENCHMARK_USE(json_parse(records_length, records, &handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_extract first record", records_length) {
+        BENCHMARK_USE(json_extract(records_length, records, "/0/name", benchmark_parser_options(), &value).code);
+    }
+
+    BENCHMARK_LOOP("json_extract middle record", records_length) {
+        BENCHMARK_USE(json_extract(records_length, records, "/25000/tags/2", benchmark_parser_options(), &value).code);
+    }
+
+    BENCHMARK_LOOP("json_extract last record", records_length) {
+        BENCHMARK_USE(json_extract(records_length, records, "/49999/address/zip", benchmark_parser_options(), &value).code);
+    }
+
+    free(records);
+}
+
+static json_parser_result_t benchmark_on_query_match(json_query_handler_t*, const size_t, const json_token_t*) {
+    ++benchmark_event_count;
+
+    return json_create_success_result();
+}
+
+BENCHMARK(query) {
+    constexpr size_t record_count = 50000;
+    constexpr size_t buffer_size = 32 * 1024 * 1024;
+    char* records = malloc(buffer_size);
+    const size_t records_length = benchmark_generate_records(records, buffer_size, record_count, false);
+    const char* paths[] = { "/*/id", "/*/score", "/*/address/zip" };
+    json_query_node_t nodes[8];
+    json_query_frame_t frames[3];
+    uint32_t active[8];
+    json_query_t query;
+    json_query_runner_t runner;
+    json_query_handler_t match_handler = { .on_match = benchmark_on_query_match };
+
+    json_parser_handler_t handler = {
+        .on_number = benchmark_on_number_event,
+        .on_integer = benchmark_on_integer_event,
+        .on_object_property = benchmark_on_string_event,
+    };
+    json_parser_handler_t skip_handler = {
+        .on_number = benchmark_on_number_event,
+        .on_integer = benchmark_on_integer_event,
+        .on_object_property = benchmark_on_property_skip,
+    };
+
+    if (json_query_compile(&query, 2, paths, 8, nodes).code != JSON_PARSE_SUCCESS
+        || json_query_runner_init(&runner, &query, &match_handler, 3, frames, 8, active).code != JSON_PARSE_SUCCESS
+        || json_parse_query(&runner, records_length, records, benchmark_parser_options()).code != JSON_PARSE_SUCCESS) {
+        printf("  Invalid query result\n");
+    }
+
+    BENCHMARK_LOOP("json_parse all properties", records_length) {
+        BENCHMARK_USE(json_parse(records_length, records, &handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_parse handwritten skip of id and score", records_length) {
+        BENCHMARK_USE(json_parse(records_length, records, &skip_handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_parse_query id and score", records_length) {
+        BENCHMARK_USE(json_parse_query(&runner, records_length, records, benchmark_parser_options()).code);
+    }
+
+    json_query_compile(&query, 3, paths, 8, nodes);
+    json_query_runner_init(&runner, &query, &match_handler, 3, frames, 8, active);
+
+    BENCHMARK_LOOP("json_parse_query id, score and address zip", records_length) {
+        BENCHMARK_USE(json_parse_query(&runner, records_length, records, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_USE(benchmark_event_count);
+
+    free(records);
+}
+
+/**
+ * Read the whole file into a new buffer, like callers do without json_parse_file()
+ */
+static char* benchmark_read_file(const char* path, size_t* length) {
+    const int fd = open(path, O_RDONLY);
+    const off_t size = lseek(fd, 0, SEEK_END);
+    char* buffer = malloc((size_t) size);
+    *length = 0;
+
+    while (*length < (size_t) size) {
+        const ssize_t count = pread(fd, buffer + *length, (size_t) size - *length, (off_t) *length);
+
+        if (count <= 0) {
+            break;
+        }
+
+        *length += (size_t) count;
+    }
+
+    close(fd);
+
+    return buffer;
+}
+
+BENCHMARK(file) {
+    constexpr size_t record_count = 100000;
+    constexpr size_t buffer_size = 64 * 1024 * 1024;
+    char* records = malloc(buffer_size);
+    const size_t records_length = benchmark_generate_records(records, buffer_size, record_count, false);
+    char path[] = "/tmp/json_benchmark_XXXXXX";
+    const int fd = mkstemp(path);
+
+    if (fd < 0 || write(fd, records, records_length) != (ssize_t) records_length) {
+        printf("  Cannot write the records file\n");
+    }
+
+    close(fd);
+    free(records);
+
+    // Each record has 16 values and 15 members
+    const size_t string_pool_size = records_length;
+    const size_t value_pool_size = record_count * 16 + 1;
+    const size_t key_pool_size = record_count * 16;
+    const size_t arena_size = json_arena_size(string_pool_size, value_pool_size, key_pool_size);
+    json_arena_t* arena = malloc(arena_size);
+    json_value_t* stack[32];
+    json_parser_handler_t handler = {
+        .on_number = benchmark_on_number_event,
+        .on_integer = benchmark_on_integer_event,
+        .on_object_property = benchmark_on_string_event,
+    };
+
+    if (json_parse_file(path, &handler, benchmark_parser_options()).code != JSON_PARSE_SUCCESS) {
+        printf("  Invalid parsing result\n");
+    }
+
+    BENCHMARK_LOOP("read() + json_parse", records_length) {
+        size_t length;
+        char* buffer = benchmark_read_file(path, &length);
+        BENCHMARK_USE(json_parse(length, buffer, &handler, benchmark_parser_options()).code);
+        free(buffer);
+    }
+
+    BENCHMARK_LOOP("json_parse_file", records_length) {
+        BENCHMARK_USE(json_parse_file(path, &handler, benchmark_parser_options()).code);
+    }
+
+    BENCHMARK_LOOP("json_parse_fd 4 KiB blocks", records_length) {
+        char buffer[JSON_PARSE_FD_BUFFER_SIZE(JSON_DEFAULT_MAX_STRING_SIZE, 4096)];
+        json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+        const int file = open(path, O_RDONLY);
+        BENCHMARK_USE(json_parse_fd(file, &handler, benchmark_parser_options(), JSON_PARSER_STACK_SIZE(32), stack, sizeof(buffer), buffer).code);
+        close(file);
+    }
+
+    BENCHMARK_LOOP("json_parse_fd 64 KiB blocks", records_length) {
+        char buffer[JSON_PARSE_FD_BUFFER_SIZE(JSON_DEFAULT_MAX_STRING_SIZE, 65536)];
+        json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+        const int file = open(path, O_RDONLY);
+        BENCHMARK_USE(json_parse_fd(file, &handler, benchmark_parser_options(), JSON_PARSER_STACK_SIZE(32), stack, sizeof(buffer), buffer).code);
+        close(file);
+    }
+
+    BENCHMARK_LOOP("read() + json_parse_value", records_length) {
+        size_t length;
+        char* buffer = benchmark_read_file(path, &length);
+        json_arena_init(arena, arena_size, string_pool_size, value_pool_size, key_pool_size);
+        BENCHMARK_USE(json_parse_value(length, buffer, arena, 32, stack, benchmark_parser_options()).result.code);
+        free(buffer);
+    }
+
+    BENCHMARK_LOOP("json_parse_value_file", records_length) {
+        json_arena_init(arena, arena_size, string_pool_size, value_pool_size, key_pool_size);
+        BENCHMARK_USE(json_parse_value_file(path, arena, 32, stack, benchmark_parser_options()).result.code);
+    }
+
+    BENCHMARK_USE(benchmark_event_count);
+
+    unlink(path);
+    free(arena);
+}
+
+BENCHMARK(measure) {
+    constexpr size_t record_count = 50000;
+    constexpr size_t buffer_size = 32 * 1024 * 1024;
+    char* records = malloc(buffer_size);
+    const size_t records_length = benchmark_generate_records(records, buffer_size, record_count, false);
+    json_value_t* stack[32];
+
+    // Each record has 16 values and 15 members
+    const size_t string_pool_size = records_length;
+    const size_t value_pool_size = record_count * 16 + 1;
+    const size_t key_pool_size = record_count * 16;
+    const size_t arena_size = json_arena_size(string_pool_size, value_pool_size, key_pool_size);
+    json_arena_t* arena = malloc(arena_size);
+
+    const json_measure_result_t measure = json_measure(records_length, records);
+    printf("  Measured pools: %zu string bytes, %zu values, %zu keys\n", measure.string_pool_size, measure.value_pool_size, measure.key_pool_size);
+
+    BENCHMARK_LOOP("json_measure", records_length) {
+        BENCHMARK_USE(json_measure(records_length, records).value_pool_size);
+    }
+
+    BENCHMARK_LOOP("json_parse_value with a preallocated arena", records_length) {
+        json_arena_init(arena, arena_size, string_pool_size, value_pool_size, key_pool_size);
+        BENCHMARK_USE(json_parse_value(records_length, records, arena, 32, stack, benchmark_parser_options()).result.code);
+    }
+
+    BENCHMARK_LOOP("json_measure + malloc + json_parse_value", records_length) {
+        const json_measure_result_t sizes = json_measure(records_length, records);
+        const size_t exact_size = json_arena_size(sizes.string_pool_size, sizes.value_pool_size, sizes.key_pool_size);
+        json_arena_t* exact_arena = malloc(exact_size);
+        json_arena_init(exact_arena, exact_size, sizes.string_pool_size, sizes.value_pool_size, sizes.key_pool_size);
+        BENCHMARK_USE(json_parse_value(records_length, records, exact_arena, 32, stack, benchmark_parser_options()).result.code);
+        free(exact_arena);
+    }
+
+    free(arena);
+    free(records);
+}
+
+static void* benchmark_allocate(void* context, const size_t size) {
+    (void) context;
+    return malloc(size);
+}
+
+static void benchmark_release(void* context, void* block, const size_t size) {
+    (void) context;
+    (void) size;
+    free(block);
+}
+
+BENCHMARK(chained_arena) {
+    constexpr size_t record_count = 50000;
+    constexpr size_t buffer_size = 32 * 1024 * 1024;
+    char* records = malloc(buffer_size);
+    const size_t records_length = benchmark_generate_records(records, buffer_size, record_count, false);
+    json_value_t* stack[32];
+
+    // Each record has 16 values and 15 members
+    const size_t string_pool_size = records_length;
+    const size_t value_pool_size = record_count * 16 + 1;
+    const size_t key_pool_size = record_count * 16;
+    const size_t arena_size = json_arena_size(string_pool_size, value_pool_size, key_pool_size);
+    json_arena_t* arena = malloc(arena_size);
+
+    constexpr size_t chained_arena_size = 64 * 1024;
+    json_arena_t* chained_arena = malloc(chained_arena_size);
+    json_arena_init_chained(chained_arena, chained_arena_size, (json_arena_allocator_t) { benchmark_allocate, benchmark_release, nullptr, 1024 * 1024 });
+
+    BENCHMARK_LOOP("fixed pools", records_length) {
+        json_arena_init(arena, arena_size, string_pool_size, value_pool_size, key_pool_size);
+        BENCHMARK_USE(json_parse_value(records_length, records, arena, 32, stack, benchmark_parser_options()).result.code);
+    }
+
+    BENCHMARK_LOOP("chained arena, reused blocks", records_length) {
+        json_arena_reset(chained_arena);
+        BENCHMARK_USE(json_parse_value(records_length, records, chained_arena, 32, stack, benchmark_parser_options()).result.code);
+    }
+
+    BENCHMARK_LOOP("chained arena, new blocks", records_length) {
+        json_arena_release(chained_arena);
+        BENCHMARK_USE(json_parse_value(records_length, records, chained_arena, 32, stack, benchmark_parser_options()).result.code);
+    }
+
+    json_arena_release(chained_arena);
+    free(chained_arena);
+    free(arena);
+    free(records);
+}
+
+typedef struct {
+    const char* record;
+    size_t record_length;
+    size_t record_count;
+
+    /**
+     * The pool to use, or nullptr to allocate an arena for each record
+     */
+    json_arena_pool_t* pool;
+} benchmark_arena_worker_t;
+
+static void* benchmark_arena_worker(void* data) {
+    const benchmark_arena_worker_t* worker = data;
+    const size_t arena_size = json_arena_size(worker->record_length, 32, 32);
+    json_value_t* stack[32];
+
+    for (size_t i = 0; i < worker->record_count; ++i) {
+        json_arena_t* arena;
+
+        if (worker->pool != nullptr) {
+            arena = json_arena_pool_acquire(worker->pool);
+        } else {
+            arena = malloc(arena_size);
+            json_arena_init(arena, arena_size, worker->record_length, 32, 32);
+        }
+
+        BENCHMARK_USE(json_parse_value(worker->record_length, worker->record, arena, 32, stack, benchmark_parser_options()).result.code);
+
+        if (worker->pool != nullptr) {
+            json_arena_pool_release(worker->pool, arena);
+        } else {
+            free(arena);
+        }
+    }
+
+    return nullptr;
+}
+
+static void benchmark_run_arena_workers(const size_t thread_count, benchmark_arena_worker_t* worker) {
+    pthread_t threads[thread_count];
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        pthread_create(&threads[i], nullptr, benchmark_arena_worker, worker);
+    }
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        pthread_join(threads[i], nullptr);
+    }
+}
+
+BENCHMARK(arena_pool) {
+    constexpr size_t thread_count = 8;
+    constexpr size_t record_count = 20000;
+    const char* record = "{\"id\": 42, \"name\": \"Alice\", \"active\": true, \"scores\": [1.5, 2.5, 3.5], \"address\": {\"city\": \"Paris\", \"zip\": \"75001\"}}";
+    const size_t record_length = strlen(record);
+    const size_t bytes = thread_count * record_count * record_length;
+
+    json_arena_pool_slot_t slots[thread_count];
+    json_arena_pool_t pools[2];
+    const bool huge_pages[2] = { false, true };
+
+    for (size_t i = 0; i < 2; ++i) {
+        json_arena_pool_init(&pools[i], (json_arena_pool_options_t) {
+            .allocator = json_arena_page_allocator(0, huge_pages[i]),
+            .mode = JSON_ARENA_POOLS,
+            .string_pool_size = record_length,
+            .value_pool_size = 32,
+            .key_pool_size = 32,
+        }, thread_count, slots);
+
+        benchmark_arena_worker_t worker = { record, record_length, record_count, &pools[i] };
+
+        BENCHMARK_LOOP(huge_pages[i] ? "pool of huge page arenas, 8 threads" : "pool of page arenas, 8 threads", bytes) {
+            benchmark_run_arena_workers(thread_count, &worker);
+        }
+
+        const json_arena_pool_stats_t stats = json_arena_pool_stats(&pools[i]);
+        printf("  Pool hits: %zu, misses: %zu, evictions: %zu\n", stats.hits, stats.misses, stats.evictions);
+
+        json_arena_pool_destroy(&pools[i]);
+    }
+
+    benchmark_arena_worker_t malloc_worker = { record, record_length, record_count, nullptr };
+
+    BENCHMARK_LOOP("malloc arena per record, 8 threads", bytes) {
+        benchmark_run_arena_workers(thread_count, &malloc_worker);
+    }
+}
+
+BENCHMARK(borrowed_strings) {
+    constexpr size_t record_count = 50000;
+    constexpr size_t buffer_size = 32 * 1024 * 1024;
+    char* records = malloc(buffer_size);
+    const size_t records_length = benchmark_generate_records(records, buffer_size, record_count, false);
+    json_value_t* stack[32];
+
+    const json_measure_result_t sizes = json_measure(records_length, records);
+    const size_t arena_size = json_arena_size(sizes.string_pool_size, sizes.value_pool_size, sizes.key_pool_size);
+    json_arena_t* arena = malloc(arena_size);
+
+    BENCHMARK_LOOP("json_parse_value, copied strings", records_length) {
+        json_arena_init(arena, arena_size, sizes.string_pool_size, sizes.value_pool_size, sizes.key_pool_size);
+        BENCHMARK_USE(json_parse_value(records_length, records, arena, 32, stack, benchmark_parser_options()).result.code);
+    }
+
+    BENCHMARK_LOOP("json_parse_value_borrowed", records_length) {
+        json_arena_init(arena, arena_size, sizes.string_pool_size, sizes.value_pool_size, sizes.key_pool_size);
+        BENCHMARK_USE(json_parse_value_borrowed(records_length, records, arena, 32, stack, benchmark_parser_options()).result.code);
+    }
+
+    printf("  Decoded string bytes: %zu of %zu\n", arena->string_pool_used, sizes.string_pool_size);
+
+    // The in situ parsing destroys its input: each iteration works on a fresh copy
+    char* buffer = malloc(records_length);
+    const size_t values_size = json_arena_size(0, sizes.value_pool_size, sizes.key_pool_size);
+
+    BENCHMARK_LOOP("memcpy of the input", records_length) {
+        memcpy(buffer, records, records_length);
+        BENCHMARK_USE(buffer[0]);
+    }
+
+    BENCHMARK_LOOP("memcpy + json_parse_value_in_situ", records_length) {
+        memcpy(buffer, records, records_length);
+        json_arena_init(arena, values_size, 0, sizes.value_pool_size, sizes.key_pool_size);
+        BENCHMARK_USE(json_parse_value_in_situ(records_length, buffer, arena, 32, stack, benchmark_parser_options()).result.code);
+    }
+
+    free(buffer);
+    free(arena);
+    free(records);
+}
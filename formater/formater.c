@@ -5,6 +5,7 @@
 #include "formater.h"
 
 #include <stdio.h>
+#include <string.h>
 
 typedef struct {
     char* buffer;
@@ -61,6 +62,61 @@ static bool json_string_builder_append_number(json_string_builder_t* builder, co
     return true;
 }
 
+static const char p_digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/**
+ * Write an integer without going through snprintf(), two digits at a time.
+ */
+static bool json_string_builder_append_integer(json_string_builder_t* builder, const int64_t number) {
+    // 19 digits and the sign
+    char digits[20];
+    size_t start = sizeof(digits);
+    // Negate as unsigned to handle INT64_MIN, which has no positive counterpart
+    uint64_t value = number < 0 ? 0 - (uint64_t) number : (uint64_t) number;
+
+    while (value >= 100) {
+        const size_t pair = (size_t) (value % 100) * 2;
+        value /= 100;
+
+        digits[--start] = p_digit_pairs[pair + 1];
+        digits[--start] = p_digit_pairs[pair];
+    }
+
+    if (value >= 10) {
+        digits[--start] = p_digit_pairs[value * 2 + 1];
+        digits[--start] = p_digit_pairs[value * 2];
+    } else {
+        digits[--start] = (char) ('0' + value);
+    }
+
+    if (number < 0) {
+        digits[--start] = '-';
+    }
+
+    const size_t length = sizeof(digits) - start;
+
+    if (builder->position + length > builder->buffer_size) {
+        // Make the builder full to prevent further writes
+        builder->position = builder->buffer_size;
+        return false;
+    }
+
+    memcpy(builder->buffer + builder->position, digits + start, length);
+    builder->position += length;
+
+    return true;
+}
+
 /**
  * Get the escaped value for a given character
  * If the character does not need to be escaped, return 0
@@ -254,6 +310,15 @@ json_formater_result_t json_format_value(const json_value_t* value, char* buffer
                 }
                 break;
 
+            case JSON_INTEGER:
+                if (!json_string_builder_append_integer(&builder, current_value->integer_value)) {
+                    return (json_formater_result_t) {
+                        .code = JSON_FORMATER_ERROR_BUFFER_TOO_SMALL,
+                        .error = { "Buffer too small for integer" },
+                    };
+                }
+                break;
+
             case JSON_STRING:
                 if (!json_format_string(&builder, current_value->string_value.value, current_value->string_value.length)) {
                     return (json_formater_result_t) {
@@ -0,0 +1,421 @@
+#include "parser.h"
+
+#include <string.h>
+
+#include "parser_internal.h"
+#include "scanner.h"
+
+/**
+ * Extraction behind `json_extract()`.
+ *
+ * Each reference token of the pointer selects a property or an element of the current structure:
+ * the other properties and elements are skipped by matching brackets, without checking them nor calling any handler.
+ * Only the target value is parsed with `json_parse()`, at the depth it has in the document, then the scan stops.
+ */
+
+static json_parser_result_t json_extract_invalid_pointer(const size_t position) {
+    return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_INVALID_POINTER, 0, position };
+}
+
+json_parser_result_t json_pointer_check(const char* pointer) {
+    if (pointer[0] != '\0' && pointer[0] != '/') {
+        return json_extract_invalid_pointer(0);
+    }
+
+    for (size_t position = 0; pointer[position] != '\0'; ++position) {
+        if (pointer[position] == '~' && pointer[position + 1] != '0' && pointer[position + 1] != '1') {
+            return json_extract_invalid_pointer(position);
+        }
+    }
+
+    return json_create_success_result();
+}
+
+static inline int json_extract_hex_value(const char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+/**
+ * Read the 4 hexadecimal digits of a \u escape sequence starting at position (the backslash).
+ * Return -1 if the sequence is malformed.
+ */
+static int32_t json_extract_unicode_escape(const char* key, const size_t position, const size_t end) {
+    if (position + 6 > end || key[position + 1] != 'u') {
+        return -1;
+    }
+
+    int32_t code_point = 0;
+
+    for (size_t i = position + 2; i < position + 6; ++i) {
+        const int digit = json_extract_hex_value(key[i]);
+
+        if (digit < 0) {
+            return -1;
+        }
+
+        code_point = code_point * 16 + digit;
+    }
+
+    return code_point;
+}
+
+/**
+ * Decode the escape sequence at position (the backslash) into its UTF-8 bytes, and move the position after it.
+ * Surrogate pairs are combined. Return the number of bytes, or 0 if the sequence is malformed.
+ */
+static size_t json_extract_decode_escape(const char* key, size_t* position, const size_t end, char bytes[4]) {
+    if (*position + 1 >= end) {
+        return 0;
+    }
+
+    const char escaped = key[*position + 1];
+    const char* simple_escapes = "\"\"\\\\//b\bf\fn\nr\rt\t";
+
+    for (size_t i = 0; simple_escapes[i] != '\0'; i += 2) {
+        if (simple_escapes[i] == escaped) {
+            bytes[0] = simple_escapes[i + 1];
+            *position += 2;
+            return 1;
+        }
+    }
+
+    int32_t code_point = json_extract_unicode_escape(key, *position, end);
+
+    if (code_point < 0) {
+        return 0;
+    }
+
+    *position += 6;
+
+    if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+        const int32_t low_surrogate = json_extract_unicode_escape(key, *position, end);
+
+        if (low_surrogate >= 0xDC00 && low_surrogate <= 0xDFFF) {
+            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low_surrogate - 0xDC00);
+            *position += 6;
+        }
+    }
+
+    if (code_point < 0x80) {
+        bytes[0] = (char) code_point;
+        return 1;
+    }
+
+    if (code_point < 0x800) {
+        bytes[0] = (char) (0xC0 | (code_point >> 6));
+        bytes[1] = (char) (0x80 | (code_point & 0x3F));
+        return 2;
+    }
+
+    if (code_point < 0x10000) {
+        bytes[0] = (char) (0xE0 | (code_point >> 12));
+        bytes[1] = (char) (0x80 | ((code_point >> 6) & 0x3F));
+        bytes[2] = (char) (0x80 | (code_point & 0x3F));
+        return 3;
+    }
+
+    bytes[0] = (char) (0xF0 | (code_point >> 18));
+    bytes[1] = (char) (0x80 | ((code_point >> 12) & 0x3F));
+    bytes[2] = (char) (0x80 | ((code_point >> 6) & 0x3F));
+    bytes[3] = (char) (0x80 | (code_point & 0x3F));
+    return 4;
+}
+
+bool json_pointer_key_matches(const char* key, size_t key_position, const size_t key_end, const char* token, const size_t token_length) {
+    size_t token_position = 0;
+
+    while (key_position < key_end) {
+        char bytes[4];
+        size_t byte_count = 1;
+
+        if (key[key_position] == '\\') {
+            byte_count = json_extract_decode_escape(key, &key_position, key_end, bytes);
+
+            if (byte_count == 0) {
+                return false;
+            }
+        } else {
+            bytes[0] = key[key_position++];
+        }
+
+        for (size_t i = 0; i < byte_count; ++i) {
+            if (token_position >= token_length) {
+                return false;
+            }
+
+            char token_char = token[token_position++];
+
+            if (token_char == '~') {
+                token_char = token[token_position++] == '0' ? '~' : '/';
+            }
+
+            if (token_char != bytes[i]) {
+                return false;
+            }
+        }
+    }
+
+    return token_position == token_length;
+}
+
+bool json_pointer_array_index(const char* token, const size_t token_length, size_t* index) {
+    if (token_length == 0 || token_length > 18 || (token[0] == '0' && token_length > 1)) {
+        return false;
+    }
+
+    *index = 0;
+
+    for (size_t i = 0; i < token_length; ++i) {
+        if (token[i] < '0' || token[i] > '9') {
+            return false;
+        }
+
+        *index = *index * 10 + (size_t) (token[i] - '0');
+    }
+
+    return true;
+}
+
+static bool json_extract_skip_whitespace(json_stream_parser_state_t* state) {
+    state->position = json_scan_whitespace(state->json, state->position, state->length);
+
+    return state->position < state->length;
+}
+
+/**
+ * After a skipped value, move to the next element or property of the structure.
+ * has_next is false when the structure is closed: the pointer does not match any value.
+ */
+static json_parser_result_t json_extract_next_element(json_stream_parser_state_t* state, const json_parse_context_t context, bool* has_next) {
+    const char closing_char = context == JSON_CONTEXT_OBJECT ? '}' : ']';
+    *has_next = false;
+
+    if (!json_extract_skip_whitespace(state)) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, context, JSON_ERROR_MISSING_CLOSING_CHARACTER, closing_char, state->position };
+    }
+
+    const char current_char = state->json[state->position];
+
+    if (current_char == closing_char) {
+        return json_create_success_result();
+    }
+
+    if (current_char != ',') {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, context, JSON_ERROR_UNEXPECTED_CHARACTER, ',', state->position };
+    }
+
+    ++state->position;
+
+    // Trailing commas are accepted, like json_parse()
+    if (!json_extract_skip_whitespace(state)) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, context, JSON_ERROR_MISSING_CLOSING_CHARACTER, closing_char, state->position };
+    }
+
+    *has_next = state->json[state->position] != closing_char;
+
+    return json_create_success_result();
+}
+
+/**
+ * Move the position to the value of the property matching the token, in the object opened just before the position.
+ * found is false if there is no such property.
+ */
+static json_parser_result_t json_extract_find_property(json_stream_parser_state_t* state, const char* token, const size_t token_length, bool* found) {
+    const char* json = state->json;
+    *found = false;
+
+    if (!json_extract_skip_whitespace(state)) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_MISSING_CLOSING_CHARACTER, '}', state->position };
+    }
+
+    bool has_next = json[state->position] != '}';
+
+    while (has_next) {
+        if (json[state->position] != '"') {
+            return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_OBJECT, JSON_ERROR_UNEXPECTED_CHARACTER, '"', state->position };
+        }
+
+        const size_t key_start = state->position + 1;
+        size_t key_end = key_start;
+
+        for (;;) {
+            key_end = json_scan_string_special(json, key_end, state->length);
+
+            if (key_end >= state->length || json[key_end] == '"') {
+                break;
+            }
+
+            key_end += json[key_end] == '\\' ? 2 : 1;
+        }
+
+        if (key_end >= state->length) {
+            return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT_PROPERTY, JSON_ERROR_MISSING_CLOSING_CHARACTER, '"', state->length };
+        }
+
+        state->position = key_end + 1;
+
+        if (!json_extract_skip_whitespace(state)) {
+            return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_MISSING_CLOSING_CHARACTER, ':', state->position };
+        }
+
+        if (json[state->position] != ':') {
+            return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_OBJECT, JSON_ERROR_UNEXPECTED_CHARACTER, ':', state->position };
+        }
+
+        ++state->position;
+
+        if (json_pointer_key_matches(json, key_start, key_end, token, token_length)) {
+            *found = true;
+            return json_create_success_result();
+        }
+
+        const json_parser_result_t skip_result = json_parser_skip_value(state);
+
+        if (skip_result.code != JSON_PARSE_SUCCESS) {
+            return skip_result;
+        }
+
+        const json_parser_result_t next_result = json_extract_next_element(state, JSON_CONTEXT_OBJECT, &has_next);
+
+        if (next_result.code != JSON_PARSE_SUCCESS) {
+            return next_result;
+        }
+    }
+
+    return json_create_success_result();
+}
+
+/**
+ * Move the position to the element at the given index, in the array opened just before the position.
+ * found is false if the array is shorter.
+ */
+static json_parser_result_t json_extract_find_element(json_stream_parser_state_t* state, const size_t index, bool* found) {
+    *found = false;
+
+    if (!json_extract_skip_whitespace(state)) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_ARRAY, JSON_ERROR_MISSING_CLOSING_CHARACTER, ']', state->position };
+    }
+
+    bool has_next = state->json[state->position] != ']';
+
+    for (size_t i = 0; i < index && has_next; ++i) {
+        const json_parser_result_t skip_result = json_parser_skip_value(state);
+
+        if (skip_result.code != JSON_PARSE_SUCCESS) {
+            return skip_result;
+        }
+
+        const json_parser_result_t next_result = json_extract_next_element(state, JSON_CONTEXT_ARRAY, &has_next);
+
+        if (next_result.code != JSON_PARSE_SUCCESS) {
+            return next_result;
+        }
+    }
+
+    *found = has_next;
+
+    return json_create_success_result();
+}
+
+/**
+ * Move the position to the child of the value at the current position designated by the reference token.
+ * found is false if there is no such child: scalars have no children, and arrays only have indexes.
+ */
+static json_parser_result_t json_extract_find_child(json_stream_parser_state_t* state, const char* token, const size_t token_length, bool* found) {
+    *found = false;
+
+    if (!json_extract_skip_whitespace(state)) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_UNKNOWN, JSON_ERROR_EMPTY_VALUE, 0, state->position };
+    }
+
+    size_t index;
+
+    if (state->json[state->position] == '{') {
+        ++state->position;
+        return json_extract_find_property(state, token, token_length, found);
+    }
+
+    if (state->json[state->position] == '[' && json_pointer_array_index(token, token_length, &index)) {
+        ++state->position;
+        return json_extract_find_element(state, index, found);
+    }
+
+    return json_create_success_result();
+}
+
+json_parser_result_t json_extract(const size_t length, const char json[length], const char* pointer, json_parser_options_t options, json_raw_string_t* out) {
+    options = json_default_parser_options(options);
+
+    if (json == nullptr || length == 0 || pointer == nullptr || out == nullptr) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    memcpy(out, &(json_raw_string_t) { .length = 0, .value = nullptr }, sizeof(*out));
+
+    const json_parser_result_t options_result = json_parser_check_options(options);
+
+    if (options_result.code != JSON_PARSE_SUCCESS) {
+        return options_result;
+    }
+
+    const json_parser_result_t pointer_result = json_pointer_check(pointer);
+
+    if (pointer_result.code != JSON_PARSE_SUCCESS) {
+        return pointer_result;
+    }
+
+    json_stream_parser_state_t state = {
+        .json = json,
+        .length = length,
+        .handler = nullptr,
+        .max_depth = options.max_depth,
+        .max_string_size = options.max_string_size,
+        .max_struct_size = options.max_struct_size,
+        .position = 0,
+    };
+    size_t depth = 0;
+
+    for (const char* token = pointer; *token == '/'; token += strcspn(token, "/")) {
+        ++token;
+
+        const size_t token_length = strcspn(token, "/");
+        bool found;
+        const json_parser_result_t result = json_extract_find_child(&state, token, token_length, &found);
+
+        if (!found) {
+            return result;
+        }
+
+        depth += 2;
+    }
+
+    if (!json_extract_skip_whitespace(&state)) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_UNKNOWN, JSON_ERROR_EMPTY_VALUE, 0, state.position };
+    }
+
+    // The target value is parsed, so its syntax and the limits are checked, but nothing after it is read
+    const size_t start = state.position;
+    size_t end = start;
+    json_parser_handler_t handler = {};
+    const json_parser_result_t value_result = json_parse_nested_value(length, json, &handler, options, depth, &end);
+
+    if (value_result.code != JSON_PARSE_SUCCESS) {
+        return value_result;
+    }
+
+    memcpy(out, &(json_raw_string_t) { .length = end - start, .value = json + start }, sizeof(*out));
+
+    return value_result;
+}
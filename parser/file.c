@@ -0,0 +1,165 @@
+#include "file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * The scanners never load bytes past the length of the input, even with SIMD instructions: the tail of each
+ * buffer is handled by scalar code. So the mapping can end exactly at the end of the file, without padding.
+ */
+
+typedef struct {
+    const char* data;
+    size_t length;
+} json_file_mapping_t;
+
+static json_parser_result_t json_file_io_failure() {
+    return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_IO_FAILURE, 0, 0 };
+}
+
+/**
+ * Map the whole file read-only. An empty file is mapped to an empty string, as mmap() rejects empty mappings.
+ */
+static json_parser_result_t json_file_map(const char* path, json_file_mapping_t* mapping) {
+    if (path == nullptr) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0) {
+        return json_file_io_failure();
+    }
+
+    struct stat status;
+
+    if (fstat(fd, &status) != 0) {
+        const int error = errno;
+        close(fd);
+        errno = error;
+
+        return json_file_io_failure();
+    }
+
+    if (!S_ISREG(status.st_mode)) {
+        close(fd);
+        errno = EINVAL;
+
+        return json_file_io_failure();
+    }
+
+    if (status.st_size == 0) {
+        close(fd);
+        *mapping = (json_file_mapping_t) { "", 0 };
+
+        return json_create_success_result();
+    }
+
+    void* data = mmap(nullptr, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    const int error = errno;
+
+    // The mapping keeps its own reference to the file
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        errno = error;
+
+        return json_file_io_failure();
+    }
+
+    // The hints are only an optimization: the parsing works the same if they are rejected
+    madvise(data, (size_t) status.st_size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    madvise(data, (size_t) status.st_size, MADV_HUGEPAGE);
+#endif
+
+    *mapping = (json_file_mapping_t) { data, (size_t) status.st_size };
+
+    return json_create_success_result();
+}
+
+static void json_file_unmap(const json_file_mapping_t* mapping) {
+    if (mapping->length > 0) {
+        munmap((void*) mapping->data, mapping->length);
+    }
+}
+
+json_parser_result_t json_parse_file(const char* path, json_parser_handler_t* handler, const json_parser_options_t options) {
+    json_file_mapping_t mapping;
+    const json_parser_result_t map_result = json_file_map(path, &mapping);
+
+    if (map_result.code != JSON_PARSE_SUCCESS) {
+        return map_result;
+    }
+
+    const json_parser_result_t result = json_parse(mapping.length, mapping.data, handler, options);
+    json_file_unmap(&mapping);
+
+    return result;
+}
+
+json_value_parser_result_t json_parse_value_file(const char* path, json_arena_t* arena, const size_t stack_size, json_value_t* stack[stack_size], const json_parser_options_t options) {
+    json_file_mapping_t mapping;
+    const json_parser_result_t map_result = json_file_map(path, &mapping);
+
+    if (map_result.code != JSON_PARSE_SUCCESS) {
+        return (json_value_parser_result_t) { map_result, nullptr };
+    }
+
+    const json_value_parser_result_t result = json_parse_value(mapping.length, mapping.data, arena, stack_size, stack, options);
+    json_file_unmap(&mapping);
+
+    return result;
+}
+
+json_parser_result_t json_parse_fd(const int fd, json_parser_handler_t* handler, json_parser_options_t options, const size_t stack_size, json_parser_frame_t stack[stack_size], const size_t buffer_size, char buffer[buffer_size]) {
+    if (buffer == nullptr) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    options = json_default_parser_options(options);
+
+    // The start of the buffer keeps the split strings, the rest receives the blocks
+    const size_t token_buffer_size = JSON_PUSH_PARSER_BUFFER_SIZE(options.max_string_size);
+
+    if (buffer_size <= token_buffer_size) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_TOO_SMALL, 0, 0 };
+    }
+
+    char* block = buffer + token_buffer_size;
+    const size_t block_size = buffer_size - token_buffer_size;
+    json_push_parser_t parser;
+
+    const json_parser_result_t init_result = json_push_parser_init(&parser, handler, options, stack_size, stack, token_buffer_size, buffer);
+
+    if (init_result.code != JSON_PARSE_SUCCESS) {
+        return init_result;
+    }
+
+    while (parser.phase != JSON_PUSH_PARSER_DONE) {
+        const ssize_t count = read(fd, block, block_size);
+
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_IO_FAILURE, 0, parser.position };
+        }
+
+        if (count == 0) {
+            break;
+        }
+
+        const json_parser_result_t result = json_parser_feed(&parser, (size_t) count, block);
+
+        if (result.code != JSON_PARSE_SUCCESS) {
+            return result;
+        }
+    }
+
+    return json_parser_finish(&parser);
+}
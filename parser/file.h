@@ -0,0 +1,63 @@
+#ifndef JSON_FILE_H
+#define JSON_FILE_H
+
+#include <stddef.h>
+
+#include "../type/factory.h"
+#include "parser.h"
+#include "push_parser.h"
+#include "value_parser.h"
+
+/**
+ * Number of bytes needed by `json_parse_fd()` to read the input by blocks of read_size bytes,
+ * and keep any string allowed by the max string size option when it is split between two blocks.
+ */
+#define JSON_PARSE_FD_BUFFER_SIZE(max_string_size, read_size) (JSON_PUSH_PARSER_BUFFER_SIZE(max_string_size) + (read_size))
+
+/**
+ * Parse a file like `json_parse()`, mapping it in memory instead of reading it into a buffer.
+ * The pages are read by the kernel as the parser walks them, so the file is not copied, and the memory can be reclaimed
+ * under pressure like the page cache.
+ *
+ * Strings passed to the handler point into the mapping, so they are only valid until this function returns.
+ * Only regular files can be mapped: use `json_parse_fd()` for pipes and sockets.
+ *
+ * If the file cannot be opened or mapped, `JSON_PARSE_CONFIG_ERROR` is returned with `JSON_ERROR_IO_FAILURE`,
+ * and errno is set to the cause of the failure, or EINVAL if the path is not a regular file.
+ *
+ * @param path The path of the file to parse.
+ */
+json_parser_result_t json_parse_file(const char* path, json_parser_handler_t* handler, json_parser_options_t options);
+
+/**
+ * Parse a file as a value like `json_parse_value()`, mapping it in memory like `json_parse_file()`.
+ * The strings are copied into the arena, so the value stays valid once the file is unmapped.
+ *
+ * @param path The path of the file to parse.
+ * @param arena The arena to use for allocating JSON values and strings.
+ * @param stack_size The size of the internal stack used for parsing nested structures. This value should be equals to `options.max_depth`.
+ * @param stack The stack to use for parsing nested structures.
+ */
+json_value_parser_result_t json_parse_value_file(const char* path, json_arena_t* arena, size_t stack_size, json_value_t* stack[stack_size], json_parser_options_t options);
+
+/**
+ * Parse the input read from a file descriptor like `json_parse()`, using the push parser on blocks of a fixed size.
+ * The memory use only depends on the buffer, so it works with pipes, sockets, and files larger than the memory.
+ *
+ * Strings passed to the handler point into the current block, or into the part of the buffer which keeps the strings
+ * split between two blocks: in both cases, they are only valid during the callback, as the next read overwrites them.
+ *
+ * The input is read until the root value is complete: the bytes following it are not read, except those of the last block.
+ * The descriptor is not closed. If a read fails, `JSON_PARSE_CONFIG_ERROR` is returned with `JSON_ERROR_IO_FAILURE`,
+ * at the position of the first byte which cannot be read, and errno is set by read().
+ *
+ * @param fd The file descriptor to read, from its current offset.
+ * @param stack_size The number of frames in the stack. See `JSON_PARSER_STACK_SIZE()`.
+ * @param stack The stack used to track nested structures.
+ * @param buffer_size The size of the buffer. Must be larger than `JSON_PUSH_PARSER_BUFFER_SIZE(options.max_string_size)`,
+ *                    after applying defaults: the remaining bytes are used to read the input. See `JSON_PARSE_FD_BUFFER_SIZE()`.
+ * @param buffer The buffer used to read the input and keep the split strings.
+ */
+json_parser_result_t json_parse_fd(int fd, json_parser_handler_t* handler, json_parser_options_t options, size_t stack_size, json_parser_frame_t stack[stack_size], size_t buffer_size, char buffer[buffer_size]);
+
+#endif //JSON_FILE_H
@@ -0,0 +1,33 @@
+#include "parser.h"
+
+#include "parser_internal.h"
+#include "structural_index.h"
+
+json_parser_result_t json_parse_indexed(const size_t length, const char json[length], json_parser_handler_t* handler, json_parser_options_t options, const size_t stack_size, json_parser_frame_t stack[stack_size]) {
+    options = json_default_parser_options(options);
+
+    const json_parser_result_t input_result = json_parser_check_input(length, json, handler, options);
+
+    if (input_result.code != JSON_PARSE_SUCCESS) {
+        return input_result;
+    }
+
+    if (stack == nullptr && stack_size > 0) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    json_stream_parser_state_t state = {
+        .json = json,
+        .length = length,
+        .handler = handler,
+        .max_depth = options.max_depth,
+        .max_string_size = options.max_string_size,
+        .max_struct_size = options.max_struct_size,
+        .position = 0,
+    };
+
+    json_structural_index_t index;
+    json_structural_index_init(&index, length, json);
+
+    return json_parse_stack(&state, &index, stack_size, stack);
+}
@@ -0,0 +1,435 @@
+#include "parser.h"
+
+#include "parser_internal.h"
+#include "scanner.h"
+#include "structural_index.h"
+
+/**
+ * Iterative parser engine, used by `json_parse_iterative()` and as second stage of `json_parse_indexed()`.
+ *
+ * The nested structures are handled with an explicit stack instead of recursion,
+ * but the depth, size and error reporting rules are the same as the recursive `json_parse()`:
+ * each nesting level counts twice in depth (value and structure), and structure sizes count separators too.
+ *
+ * When a structural index is given, whitespaces and strings are skipped using the index instead of scanning them.
+ */
+
+/**
+ * Move the cursor to the next non-whitespace character.
+ *
+ * If the current character is not a whitespace, it is returned as is: it may be the continuation of a literal,
+ * which is not indexed. Otherwise, the next indexed character is the next non-whitespace one.
+ */
+static bool json_iterative_skip_whitespace(json_stream_parser_state_t* state, json_structural_index_t* index) {
+    if (state->position < state->length && !json_is_whitespace(state->json[state->position])) {
+        return true;
+    }
+
+    state->position = index != nullptr
+        ? json_structural_index_next(index, state->position)
+        : json_scan_whitespace(state->json, state->position, state->length)
+    ;
+
+    return state->position < state->length;
+}
+
+static json_parser_result_t json_iterative_parse_string(json_stream_parser_state_t* state, json_structural_index_t* index, const size_t depth, const bool is_property_key) {
+    if (index == nullptr) {
+        return json_parse_string_internal(state, depth, is_property_key);
+    }
+
+    const json_parse_context_t context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING;
+
+    if (depth > state->max_depth) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, context, JSON_ERROR_UNKNOWN, 0, state->position };
+    }
+
+    if (state->position + 1 >= state->length) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, context, JSON_ERROR_TOO_SMALL, 0, state->position };
+    }
+
+    if (state->json[state->position] != '"') {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, context, JSON_ERROR_UNEXPECTED_CHARACTER, '"', state->position };
+    }
+
+    const size_t start_position = state->position;
+    // Strings do not contain any indexed character, so the next one is the closing quote
+    const size_t closing_position = json_structural_index_next(index, start_position + 1);
+    const size_t scan_end = state->length - start_position > state->max_string_size
+        ? start_position + state->max_string_size
+        : state->length
+    ;
+
+    // Only the characters of the string need to be checked: the closing quote is already known
+    const size_t content_end = closing_position < scan_end ? closing_position : scan_end;
+    state->position = start_position + 1;
+    state->string_escape_free = true;
+
+    while (state->position < content_end) {
+        state->position = json_scan_string_utf8(state->json, state->position, content_end);
+
+        if (state->position >= content_end) {
+            break;
+        }
+
+        if (state->json[state->position] == '\\') {
+            // Like json_parser_scan_string(), a UTF-8 sequence following the backslash is checked as any other
+            state->position += state->position + 1 < content_end && (unsigned char) state->json[state->position + 1] >= 0x80 ? 1 : 2;
+            state->string_escape_free = false;
+            continue;
+        }
+
+        const json_parser_result_t char_result = json_parser_check_string_char(state, is_property_key);
+
+        if (char_result.code != JSON_PARSE_SUCCESS) {
+            return char_result;
+        }
+    }
+
+    if (closing_position >= scan_end) {
+        if (scan_end < state->length) {
+            return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_STRING_SIZE, context, JSON_ERROR_UNKNOWN, 0, scan_end };
+        }
+
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, context, JSON_ERROR_MISSING_CLOSING_CHARACTER, '"', state->length };
+    }
+
+    if (state->json[closing_position] != '"') {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, context, JSON_ERROR_UNEXPECTED_CHARACTER, '"', closing_position };
+    }
+
+    state->position = closing_position + 1;
+
+    return json_parser_emit_string(state, start_position, is_property_key);
+}
+
+static json_parser_result_t json_iterative_start_structure(json_stream_parser_state_t* state, const json_parse_context_t context, const size_t depth) {
+    if (depth > state->max_depth) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, context, JSON_ERROR_UNKNOWN, 0, state->position };
+    }
+
+    if (state->position + 1 >= state->length) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, context, JSON_ERROR_TOO_SMALL, 0, state->position };
+    }
+
+    // Skip the opening bracket
+    ++state->position;
+
+    json_parser_result_t (*start_handler)(json_parser_handler_t*) = context == JSON_CONTEXT_OBJECT
+        ? state->handler->on_object_start
+        : state->handler->on_array_start
+    ;
+
+    if (start_handler == nullptr) {
+        return json_create_success_result();
+    }
+
+    return start_handler(state->handler);
+}
+
+static json_parser_result_t json_iterative_parse_scalar(json_stream_parser_state_t* state, json_structural_index_t* index, const char current_char, const size_t depth) {
+    switch (current_char) {
+        case '"':
+            return json_iterative_parse_string(state, index, depth, false);
+
+        case 'n':
+            return json_parse_null(state, depth);
+
+        case 't':
+            return json_parse_boolean(state, true, depth);
+
+        case 'f':
+            return json_parse_boolean(state, false, depth);
+
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            return json_parse_number(state, depth);
+
+        default:
+            return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNEXPECTED_CHARACTER, 0, state->position };
+    }
+}
+
+/**
+ * Skip the rest of the structure opened just before the current position, after a skip result of a handler.
+ * With an index, the brackets are counted on the indexed characters, which are never inside strings.
+ */
+static json_parser_result_t json_iterative_skip_structure(json_stream_parser_state_t* state, json_structural_index_t* index, const json_parse_context_t context) {
+    if (index == nullptr) {
+        return json_parser_skip_structure(state, context);
+    }
+
+    size_t depth = 1;
+
+    for (size_t position = json_structural_index_next(index, state->position); position < state->length; position = json_structural_index_next(index, position + 1)) {
+        const char current_char = state->json[position];
+
+        if (current_char == '[' || current_char == '{') {
+            ++depth;
+        } else if ((current_char == ']' || current_char == '}') && --depth == 0) {
+            state->position = position + 1;
+            return json_create_success_result();
+        }
+    }
+
+    state->position = state->length;
+
+    return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, context, JSON_ERROR_MISSING_CLOSING_CHARACTER, context == JSON_CONTEXT_OBJECT ? '}' : ']', state->length };
+}
+
+/**
+ * Skip the value of a property, after a skip result of the property handler.
+ * See `json_parser_skip_value()`.
+ */
+static json_parser_result_t json_iterative_skip_value(json_stream_parser_state_t* state, json_structural_index_t* index) {
+    if (index == nullptr) {
+        return json_parser_skip_value(state);
+    }
+
+    if (!json_iterative_skip_whitespace(state, index)) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_UNKNOWN, JSON_ERROR_EMPTY_VALUE, 0, state->position };
+    }
+
+    switch (state->json[state->position]) {
+        case '[':
+        case '{': {
+            const json_parse_context_t context = state->json[state->position] == '{' ? JSON_CONTEXT_OBJECT : JSON_CONTEXT_ARRAY;
+
+            ++state->position;
+            return json_iterative_skip_structure(state, index, context);
+        }
+
+        case '"': {
+            const size_t closing_position = json_structural_index_next(index, state->position + 1);
+
+            if (closing_position >= state->length) {
+                state->position = state->length;
+                return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_STRING, JSON_ERROR_MISSING_CLOSING_CHARACTER, '"', state->length };
+            }
+
+            state->position = closing_position + 1;
+            return json_create_success_result();
+        }
+
+        case ',':
+        case ']':
+        case '}':
+        case ':':
+            return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNEXPECTED_CHARACTER, 0, state->position };
+
+        default:
+            // The literal continues up to the next indexed character
+            state->position = json_structural_index_next(index, state->position + 1);
+            return json_create_success_result();
+    }
+}
+
+static json_parser_result_t json_iterative_parse_stack(json_stream_parser_state_t* state, json_structural_index_t* index, const size_t stack_size, json_parser_frame_t stack[stack_size]) {
+    size_t stack_used = 0;
+    bool value_expected = true;
+
+    for (;;) {
+        if (value_expected) {
+            const size_t depth = 2 * stack_used;
+
+            if (depth > state->max_depth) {
+                return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNKNOWN, 0, state->position };
+            }
+
+            if (!json_iterative_skip_whitespace(state, index)) {
+                return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_UNKNOWN, JSON_ERROR_EMPTY_VALUE, 0, state->position };
+            }
+
+            const char current_char = state->json[state->position];
+
+            if (current_char == '[' || current_char == '{') {
+                const json_parse_context_t context = current_char == '{' ? JSON_CONTEXT_OBJECT : JSON_CONTEXT_ARRAY;
+
+                // The max depth error takes precedence, to report the same error as json_parse() when possible
+                if (stack_used >= stack_size && depth + 1 <= state->max_depth) {
+                    return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, context, JSON_ERROR_STACK_OVERFLOW, 0, state->position };
+                }
+
+                const json_parser_result_t start_result = json_iterative_start_structure(state, context, depth + 1);
+
+                if (start_result.code == JSON_PARSE_SKIP) {
+                    const json_parser_result_t skip_result = json_iterative_skip_structure(state, index, context);
+
+                    if (skip_result.code != JSON_PARSE_SUCCESS || stack_used == 0) {
+                        return skip_result;
+                    }
+
+                    value_expected = false;
+                    continue;
+                }
+
+                if (start_result.code != JSON_PARSE_SUCCESS) {
+                    return start_result;
+                }
+
+                stack[stack_used++] = (json_parser_frame_t) {
+                    .length = 0,
+                    .type = context,
+                    .expected = true,
+                };
+                value_expected = false;
+                continue;
+            }
+
+            const json_parser_result_t result = json_iterative_parse_scalar(state, index, current_char, depth + 1);
+
+            if (result.code != JSON_PARSE_SUCCESS || stack_used == 0) {
+                return result;
+            }
+
+            value_expected = false;
+            continue;
+        }
+
+        json_parser_frame_t* frame = &stack[stack_used - 1];
+        const bool is_object = frame->type == JSON_CONTEXT_OBJECT;
+        const char closing_char = is_object ? '}' : ']';
+
+        if (state->position >= state->length) {
+            return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, frame->type, JSON_ERROR_MISSING_CLOSING_CHARACTER, closing_char, state->position };
+        }
+
+        if (frame->length > state->max_struct_size) {
+            return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_STRUCT_SIZE, frame->type, JSON_ERROR_UNKNOWN, 0, state->position };
+        }
+
+        ++frame->length;
+
+        if (!json_iterative_skip_whitespace(state, index)) {
+            return is_object
+                ? (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_EMPTY_VALUE, 0, state->position }
+                : (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_ARRAY, JSON_ERROR_MISSING_CLOSING_CHARACTER, ']', state->position }
+            ;
+        }
+
+        const char current_char = state->json[state->position];
+
+        if (current_char == closing_char) {
+            ++state->position;
+            --stack_used;
+
+            json_parser_result_t (*end_handler)(json_parser_handler_t*) = is_object
+                ? state->handler->on_object_end
+                : state->handler->on_array_end
+            ;
+
+            if (end_handler != nullptr) {
+                const json_parser_result_t end_result = end_handler(state->handler);
+
+                if (end_result.code != JSON_PARSE_SUCCESS) {
+                    return end_result;
+                }
+            }
+
+            if (stack_used == 0) {
+                return json_create_success_result();
+            }
+
+            continue;
+        }
+
+        if (current_char == ',') {
+            if (frame->expected) {
+                return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, frame->type, JSON_ERROR_UNEXPECTED_CHARACTER, is_object ? '"' : 0, state->position };
+            }
+
+            frame->expected = true;
+            ++state->position;
+            continue;
+        }
+
+        if (!frame->expected) {
+            return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, frame->type, JSON_ERROR_UNEXPECTED_CHARACTER, ',', state->position };
+        }
+
+        frame->expected = false;
+
+        if (is_object) {
+            const json_parser_result_t key_result = json_iterative_parse_string(state, index, 2 * stack_used, true);
+            const bool skip_value = key_result.code == JSON_PARSE_SKIP;
+
+            if (key_result.code != JSON_PARSE_SUCCESS && !skip_value) {
+                return key_result;
+            }
+
+            if (!json_iterative_skip_whitespace(state, index)) {
+                return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_MISSING_CLOSING_CHARACTER, ':', state->position };
+            }
+
+            if (state->json[state->position] != ':') {
+                return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_OBJECT, JSON_ERROR_UNEXPECTED_CHARACTER, ':', state->position };
+            }
+
+            ++state->position;
+
+            if (skip_value) {
+                const json_parser_result_t skip_result = json_iterative_skip_value(state, index);
+
+                if (skip_result.code != JSON_PARSE_SUCCESS) {
+                    return skip_result;
+                }
+
+                continue;
+            }
+        }
+
+        value_expected = true;
+    }
+}
+
+json_parser_result_t json_parse_stack(json_stream_parser_state_t* state, json_structural_index_t* index, const size_t stack_size, json_parser_frame_t stack[stack_size]) {
+    const json_parser_result_t result = json_iterative_parse_stack(state, index, stack_size, stack);
+
+    // Handler codes which are not parser results, like a skip result from a scalar or end handler, are reported as json_parse() does
+    if (result.code < 0 || result.code > JSON_PARSE_CONFIG_ERROR) {
+        return (json_parser_result_t) {
+            .code = JSON_PARSE_CONFIG_ERROR,
+            .context = JSON_CONTEXT_UNKNOWN,
+            .error = JSON_ERROR_INVALID_CODE,
+            .extra = result.code,
+            .position = state->position,
+        };
+    }
+
+    return result;
+}
+
+json_parser_result_t json_parse_iterative(const size_t length, const char json[length], json_parser_handler_t* handler, json_parser_options_t options, const size_t stack_size, json_parser_frame_t stack[stack_size]) {
+    options = json_default_parser_options(options);
+
+    const json_parser_result_t input_result = json_parser_check_input(length, json, handler, options);
+
+    if (input_result.code != JSON_PARSE_SUCCESS) {
+        return input_result;
+    }
+
+    if (stack == nullptr && stack_size > 0) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    json_stream_parser_state_t state = {
+        .json = json,
+        .length = length,
+        .handler = handler,
+        .max_depth = options.max_depth,
+        .max_string_size = options.max_string_size,
+        .max_struct_size = options.max_struct_size,
+        .position = 0,
+    };
+
+    return json_parse_stack(&state, nullptr, stack_size, stack);
+}
@@ -0,0 +1,106 @@
+#include "value_parser.h"
+
+#include <string.h>
+
+#include "structural_index.h"
+
+/**
+ * Counting pass behind `json_measure()`.
+ *
+ * The end of the root value is found by counting brackets, then its values are counted by blocks, without visiting
+ * each token: every opening bracket, string not followed by a colon, or literal start is a value, and each value
+ * except the root one is a member of its array or object. The decoded size of the strings is their content
+ * minus the escape backslashes.
+ */
+
+static bool json_measure_is_whitespace(const char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+/**
+ * Check if the quote at the given position is escaped, i.e. preceded by an odd sequence of backslashes.
+ */
+static bool json_measure_is_escaped(const char json[], const size_t start, size_t position) {
+    size_t backslashes = 0;
+
+    while (position > start && json[position - 1] == '\\') {
+        ++backslashes;
+        --position;
+    }
+
+    return backslashes % 2 == 1;
+}
+
+/**
+ * Find the position after the root value starting at the given position.
+ * The input is not validated: an unterminated value ends at the end of the input.
+ */
+static size_t json_measure_root_end(const size_t length, const char json[length], const size_t start) {
+    switch (json[start]) {
+        case '{':
+        case '[': {
+            json_structural_skip_t skip = { 1, 0, 0 };
+
+            return json_structural_index_skip(&skip, length, json, start + 1);
+        }
+
+        case '"':
+            for (const char* quote = memchr(json + start + 1, '"', length - start - 1); quote != nullptr; quote = memchr(quote + 1, '"', (size_t) (json + length - quote - 1))) {
+                if (!json_measure_is_escaped(json, start, (size_t) (quote - json))) {
+                    return (size_t) (quote - json) + 1;
+                }
+            }
+
+            return length;
+
+        default:
+            // Only the start of a literal is counted
+            return start + 1;
+    }
+}
+
+json_measure_result_t json_measure(const size_t length, const char json[length]) {
+    if (json == nullptr) {
+        return (json_measure_result_t) { .result = { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 } };
+    }
+
+    size_t start = 0;
+
+    while (start < length && json_measure_is_whitespace(json[start])) {
+        ++start;
+    }
+
+    if (start == length) {
+        return (json_measure_result_t) { .result = json_create_success_result() };
+    }
+
+    const size_t end = json_measure_root_end(length, json, start);
+    json_structural_counts_t counts;
+
+    json_structural_index_count(end - start, json + start, &counts);
+
+    // Keys are strings followed by a colon, so they are counted as values too
+    const size_t value_count = counts.values > counts.keys ? counts.values - counts.keys : 0;
+    size_t string_size = counts.string_bytes;
+
+    if (counts.last_colon < end - start && counts.string_bytes_at_last_colon == string_size) {
+        // json_create_object_member() needs a free byte in the string pool, even for an empty key:
+        // the byte is missing only if the last key and all the following strings are empty
+        size_t key_end = start + counts.last_colon;
+
+        while (key_end > start && json_measure_is_whitespace(json[key_end - 1])) {
+            --key_end;
+        }
+
+        if (key_end >= start + 2 && json[key_end - 1] == '"' && json[key_end - 2] == '"' && !json_measure_is_escaped(json, start, key_end - 2)) {
+            ++string_size;
+        }
+    }
+
+    return (json_measure_result_t) {
+        .result = json_create_success_result(),
+        .string_pool_size = string_size,
+        .value_pool_size = value_count,
+        .key_pool_size = value_count > 0 ? value_count - 1 : 0,
+    };
+}
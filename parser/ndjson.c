@@ -0,0 +1,293 @@
+#include "ndjson.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#include "parser_internal.h"
+#include "scanner.h"
+
+/**
+ * The lines of the input are split by the calling thread, which only searches line feeds, into one batch per worker.
+ * Workers parse their batch in their own arena, then the calling thread delivers the records in order, and starts
+ * the next round. As the values of a round live in the arenas, the next round only starts once all records are delivered.
+ */
+
+typedef struct {
+    const char* json;
+    json_parser_options_t options;
+    json_arena_t* arena;
+    size_t stack_size;
+    json_value_t** stack;
+    json_ndjson_record_t* records;
+
+    /**
+     * Number of lines of the batch, set before the round
+     */
+    size_t count;
+
+    /**
+     * Number of records to deliver, set by the worker. Blank lines are removed from the records.
+     */
+    size_t parsed;
+
+    /**
+     * The arena was full: the record following the parsed ones is the first line of the next round
+     */
+    bool truncated;
+} json_ndjson_batch_t;
+
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t start;
+    pthread_cond_t done;
+
+    /**
+     * Incremented each time the batches are ready to be parsed
+     */
+    size_t round;
+
+    /**
+     * Number of threads still parsing the current round
+     */
+    size_t pending;
+    bool stop;
+
+    size_t worker_count;
+    json_ndjson_batch_t* batches;
+} json_ndjson_pool_t;
+
+typedef struct {
+    json_ndjson_pool_t* pool;
+    size_t index;
+} json_ndjson_worker_t;
+
+static void json_ndjson_set_result(json_ndjson_record_t* record, const json_value_parser_result_t result) {
+    memcpy(&record->result, &result, sizeof(result));
+}
+
+static void json_ndjson_parse_batch(json_ndjson_batch_t* batch) {
+    size_t parsed = 0;
+
+    json_arena_reset(batch->arena);
+    batch->truncated = false;
+
+    for (size_t i = 0; i < batch->count; ++i) {
+        json_ndjson_record_t* record = &batch->records[i];
+        const char* line = batch->json + record->offset;
+
+        if (json_scan_whitespace(line, 0, record->length) == record->length) {
+            continue;
+        }
+
+        const json_value_parser_result_t result = json_parse_value(record->length, line, batch->arena, batch->stack_size, batch->stack, batch->options);
+
+        if (i != parsed) {
+            memcpy(&batch->records[parsed], record, sizeof(*record));
+            record = &batch->records[parsed];
+        }
+
+        // The line may fit in an empty arena: retry it on the next round
+        if (parsed > 0 && result.result.code == JSON_PARSE_HANDLER_ERROR && result.result.error == JSON_ERROR_OUT_OF_MEMORY) {
+            batch->truncated = true;
+            break;
+        }
+
+        json_ndjson_set_result(record, result);
+        ++parsed;
+    }
+
+    batch->parsed = parsed;
+}
+
+static void* json_ndjson_worker_run(void* argument) {
+    const json_ndjson_worker_t* worker = argument;
+    json_ndjson_pool_t* pool = worker->pool;
+    size_t round = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+
+    for (;;) {
+        while (!pool->stop && pool->round == round) {
+            pthread_cond_wait(&pool->start, &pool->mutex);
+        }
+
+        if (pool->stop) {
+            break;
+        }
+
+        round = pool->round;
+        pthread_mutex_unlock(&pool->mutex);
+
+        json_ndjson_parse_batch(&pool->batches[worker->index]);
+
+        pthread_mutex_lock(&pool->mutex);
+
+        if (--pool->pending == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    return nullptr;
+}
+
+/**
+ * Parse all the batches, the first one on the calling thread, and wait for the other workers
+ */
+static void json_ndjson_pool_run(json_ndjson_pool_t* pool) {
+    if (pool->worker_count > 1) {
+        pthread_mutex_lock(&pool->mutex);
+        pool->pending = pool->worker_count - 1;
+        ++pool->round;
+        pthread_cond_broadcast(&pool->start);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    json_ndjson_parse_batch(&pool->batches[0]);
+
+    if (pool->worker_count > 1) {
+        pthread_mutex_lock(&pool->mutex);
+
+        while (pool->pending > 0) {
+            pthread_cond_wait(&pool->done, &pool->mutex);
+        }
+
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+static void json_ndjson_pool_stop(json_ndjson_pool_t* pool, const size_t thread_count, pthread_t threads[thread_count]) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        pthread_join(threads[i], nullptr);
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->mutex);
+}
+
+static json_parser_result_t json_ndjson_run(json_ndjson_pool_t* pool, const size_t length, const char json[length], json_ndjson_handler_t* handler, const size_t batch_size) {
+    size_t position = 0;
+    size_t line = 0;
+
+    while (position < length) {
+        for (size_t worker = 0; worker < pool->worker_count; ++worker) {
+            json_ndjson_batch_t* batch = &pool->batches[worker];
+
+            for (batch->count = 0; batch->count < batch_size && position < length; ++batch->count) {
+                const size_t end = json_scan_newline(json, position, length);
+                json_ndjson_record_t* record = &batch->records[batch->count];
+
+                record->line = line++;
+                record->offset = position;
+                record->length = end - position;
+                position = end < length ? end + 1 : length;
+            }
+        }
+
+        json_ndjson_pool_run(pool);
+
+        for (size_t worker = 0; worker < pool->worker_count; ++worker) {
+            const json_ndjson_batch_t* batch = &pool->batches[worker];
+
+            for (size_t i = 0; i < batch->parsed; ++i) {
+                const json_parser_result_t result = handler->on_record(handler, &batch->records[i]);
+
+                if (result.code != JSON_PARSE_SUCCESS) {
+                    return result;
+                }
+            }
+
+            // The lines of the following batches are parsed again on the next round, to keep the input order
+            if (batch->truncated) {
+                position = batch->records[batch->parsed].offset;
+                line = batch->records[batch->parsed].line;
+                break;
+            }
+        }
+    }
+
+    return json_create_success_result();
+}
+
+json_parser_result_t json_parse_ndjson(
+    const size_t length,
+    const char json[length],
+    json_ndjson_handler_t* handler,
+    json_parser_options_t options,
+    const size_t worker_count,
+    json_arena_t* arenas[worker_count],
+    const size_t stack_size,
+    json_value_t* stacks[JSON_NDJSON_STACKS_SIZE(worker_count, stack_size)],
+    const size_t batch_size,
+    json_ndjson_record_t records[JSON_NDJSON_RECORDS_SIZE(worker_count, batch_size)]
+) {
+    if ((json == nullptr && length > 0) || handler == nullptr || handler->on_record == nullptr || arenas == nullptr || records == nullptr || (stacks == nullptr && stack_size > 0)) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    if (worker_count == 0 || batch_size == 0) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_TOO_SMALL, 0, 0 };
+    }
+
+    for (size_t worker = 0; worker < worker_count; ++worker) {
+        if (arenas[worker] == nullptr) {
+            return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+        }
+    }
+
+    options = json_default_parser_options(options);
+
+    const json_parser_result_t options_result = json_parser_check_options(options);
+
+    if (options_result.code != JSON_PARSE_SUCCESS) {
+        return options_result;
+    }
+
+    json_ndjson_batch_t batches[worker_count];
+
+    for (size_t worker = 0; worker < worker_count; ++worker) {
+        batches[worker] = (json_ndjson_batch_t) {
+            .json = json,
+            .options = options,
+            .arena = arenas[worker],
+            .stack_size = stack_size,
+            .stack = stacks + worker * stack_size,
+            .records = records + worker * batch_size,
+        };
+    }
+
+    json_ndjson_pool_t pool = {
+        .mutex = PTHREAD_MUTEX_INITIALIZER,
+        .start = PTHREAD_COND_INITIALIZER,
+        .done = PTHREAD_COND_INITIALIZER,
+        .worker_count = worker_count,
+        .batches = batches,
+    };
+
+    const size_t thread_count = worker_count - 1;
+    pthread_t threads[thread_count + 1];
+    json_ndjson_worker_t workers[thread_count + 1];
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers[i] = (json_ndjson_worker_t) { &pool, i + 1 };
+
+        if (pthread_create(&threads[i], nullptr, json_ndjson_worker_run, &workers[i]) != 0) {
+            json_ndjson_pool_stop(&pool, i, threads);
+
+            return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_THREAD_FAILURE, 0, 0 };
+        }
+    }
+
+    const json_parser_result_t result = json_ndjson_run(&pool, length, json, handler, batch_size);
+
+    json_ndjson_pool_stop(&pool, thread_count, threads);
+
+    return result;
+}
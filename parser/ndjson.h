@@ -0,0 +1,97 @@
+#ifndef JSON_NDJSON_H
+#define JSON_NDJSON_H
+
+#include <stddef.h>
+
+#include "../type/factory.h"
+#include "parser.h"
+#include "value_parser.h"
+
+/**
+ * Number of records needed by `json_parse_ndjson()` for the given count of workers and batch size.
+ */
+#define JSON_NDJSON_RECORDS_SIZE(worker_count, batch_size) ((worker_count) * (batch_size))
+
+/**
+ * Number of stack entries needed by `json_parse_ndjson()` for the given count of workers and stack size per worker.
+ */
+#define JSON_NDJSON_STACKS_SIZE(worker_count, stack_size) ((worker_count) * (stack_size))
+
+/**
+ * A line of a NDJSON input, parsed as a value.
+ */
+typedef struct {
+    /**
+     * Index of the line in the input, starting at 0. Blank lines are counted, but never delivered.
+     */
+    size_t line;
+
+    /**
+     * Position of the first character of the line in the input
+     */
+    size_t offset;
+
+    /**
+     * Length of the line, without the line feed
+     */
+    size_t length;
+
+    /**
+     * The parsed value, or the error if the line is malformed.
+     * Error positions are relative to the start of the line.
+     */
+    json_value_parser_result_t result;
+} json_ndjson_record_t;
+
+/**
+ * Receive the records of a NDJSON input, in input order.
+ * Like `json_parser_handler_t`, the handler receives a pointer to itself, and can be embedded in a larger structure to keep a state.
+ */
+typedef struct json_ndjson_handler_t {
+    /**
+     * Called for each non-blank line, including malformed ones.
+     * The value of the record is only valid during the call: its arena is reused for the next batches.
+     *
+     * Return a non-success result to stop parsing. This result is then returned by `json_parse_ndjson()`.
+     */
+    json_parser_result_t (*on_record)(struct json_ndjson_handler_t* self, const json_ndjson_record_t* record);
+} json_ndjson_handler_t;
+
+/**
+ * Parse a NDJSON (JSON Lines) input: each line contains a JSON value, and lines are separated by a line feed.
+ * Blank lines are ignored, and a carriage return before the line feed is accepted.
+ *
+ * Lines are split in batches of up to `batch_size` lines, and the batches are parsed in parallel by `worker_count`
+ * workers, each one with its own arena. The calling thread is the first worker, so `worker_count - 1` threads are started.
+ * Once all the batches of a round are parsed, their records are sent to the handler in input order, from the calling thread.
+ *
+ * A malformed line does not stop parsing: its record is sent to the handler with the error.
+ * If the arena of a worker is full, the batch is cut before the line which does not fit, and the remaining lines are parsed in the
+ * next round. So an arena only needs to be large enough for the largest line: a line which does not fit in an empty arena is
+ * reported with `JSON_ERROR_OUT_OF_MEMORY`.
+ *
+ * Each line is parsed like with `json_parse_value()`, so any content after the value of a line is ignored.
+ *
+ * @param handler The handler receiving the records.
+ * @param options The parser options applied to each line.
+ * @param worker_count The number of workers, at least 1.
+ * @param arenas One initialized arena per worker. They are reset before each batch.
+ * @param stack_size The size of the stack of each worker, see `json_parse_value()`. It should be equals to `options.max_depth`.
+ * @param stacks The stacks of the workers, one after the other. See `JSON_NDJSON_STACKS_SIZE()`.
+ * @param batch_size The maximum number of lines parsed by a worker in a round.
+ * @param records Buffer for the records of a round. See `JSON_NDJSON_RECORDS_SIZE()`.
+ */
+json_parser_result_t json_parse_ndjson(
+    size_t length,
+    const char json[length],
+    json_ndjson_handler_t* handler,
+    json_parser_options_t options,
+    size_t worker_count,
+    json_arena_t* arenas[worker_count],
+    size_t stack_size,
+    json_value_t* stacks[JSON_NDJSON_STACKS_SIZE(worker_count, stack_size)],
+    size_t batch_size,
+    json_ndjson_record_t records[JSON_NDJSON_RECORDS_SIZE(worker_count, batch_size)]
+);
+
+#endif //JSON_NDJSON_H
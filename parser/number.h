@@ -0,0 +1,67 @@
+#ifndef JSON_NUMBER_H
+#define JSON_NUMBER_H
+
+/**
+ * JSON number scanning and conversion, shared by the parser engines.
+ * This header is not part of the public API.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "parser.h"
+
+/**
+ * A scanned JSON number, in the decimal form `mantissa * 10^exponent`.
+ */
+typedef struct {
+    /**
+     * The raw number in the input, including the sign and the exponent.
+     */
+    const char* value;
+    size_t length;
+
+    bool negative;
+
+    /**
+     * The input has more than 19 significant digits, so the mantissa only keeps the first 19 ones.
+     */
+    bool too_many_digits;
+
+    /**
+     * The number has no fraction nor exponent, and fits in a int64_t.
+     * "-0" is not considered as an integer, to keep its sign.
+     */
+    bool integer;
+
+    uint64_t mantissa;
+    int64_t exponent;
+} json_number_t;
+
+/**
+ * Scan the number starting at the given position, checking the JSON number grammar:
+ * an optional minus sign, an integer part without leading zero, an optional fraction and an optional exponent.
+ *
+ * On success, position is moved to the first character after the number.
+ * On error, the result position is the position of the invalid character (or the input length).
+ */
+json_parser_result_t json_number_scan(const char* json, size_t length, size_t* position, json_number_t* number);
+
+/**
+ * Convert the scanned number to the nearest double (round to nearest, ties to even).
+ *
+ * Numbers up to 19 significant digits are converted with the Clinger fast path, or the Eisel-Lemire algorithm.
+ * Longer numbers use `strtod()` when the truncated mantissa is ambiguous, which expects the "C" locale for LC_NUMERIC.
+ */
+double json_number_to_double(const json_number_t* number);
+
+/**
+ * Get the value of a number flagged as integer.
+ * The result is undefined if the number is not an integer.
+ */
+static inline int64_t json_number_to_integer(const json_number_t* number) {
+    // Negate as unsigned to handle INT64_MIN, which has no positive counterpart
+    return number->negative ? (int64_t) (0 - number->mantissa) : (int64_t) number->mantissa;
+}
+
+#endif //JSON_NUMBER_H
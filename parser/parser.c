@@ -3,27 +3,17 @@
 #include <stdio.h>
 #include <string.h>
 
-typedef struct {
-    const char* json;
-    const size_t length;
-    json_parser_handler_t* handler;
-    const size_t max_depth;
-    const size_t max_string_size;
-    const size_t max_struct_size;
-    size_t position;
-} json_stream_parser_state_t;
+#include "number.h"
+#include "parser_internal.h"
+#include "scanner.h"
 
 json_parser_result_t json_create_success_result() {
     return (json_parser_result_t) { .code = JSON_PARSE_SUCCESS };
 }
 
-static json_parser_result_t json_parse_value(json_stream_parser_state_t* state, size_t depth);
-static json_parser_result_t json_parse_string(json_stream_parser_state_t* state, size_t depth);
-static json_parser_result_t json_parse_object(json_stream_parser_state_t* state, size_t depth);
-static json_parser_result_t json_parse_array(json_stream_parser_state_t* state, size_t depth);
-static json_parser_result_t json_parse_number(json_stream_parser_state_t* state, size_t depth);
-static json_parser_result_t json_parse_boolean(json_stream_parser_state_t* state, bool expected_value, size_t depth);
-static json_parser_result_t json_parse_null(json_stream_parser_state_t* state, size_t depth);
+json_parser_result_t json_create_skip_result() {
+    return (json_parser_result_t) { .code = JSON_PARSE_SKIP };
+}
 
 json_parser_options_t json_default_parser_options(const json_parser_options_t options) {
     return (json_parser_options_t) {
@@ -33,13 +23,15 @@ json_parser_options_t json_default_parser_options(const json_parser_options_t op
     };
 }
 
-json_parser_result_t json_parse(const size_t length, const char json[length], json_parser_handler_t* handler, json_parser_options_t options) {
-    options = json_default_parser_options(options);
-
+json_parser_result_t json_parser_check_input(const size_t length, const char* json, const json_parser_handler_t* handler, const json_parser_options_t options) {
     if (json == nullptr || length == 0 || handler == nullptr) {
         return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
     }
 
+    return json_parser_check_options(options);
+}
+
+json_parser_result_t json_parser_check_options(const json_parser_options_t options) {
     if (options.max_depth > 1000000) {
         return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_INVALID_MAX_DEPTH, 0, 0 };
     }
@@ -52,6 +44,36 @@ json_parser_result_t json_parse(const size_t length, const char json[length], js
         return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_INVALID_MAX_STRUCT_SIZE, 0, 0 };
     }
 
+    return json_create_success_result();
+}
+
+/*
+ * The recursive parser is the generic instance of the parser template: each event calls the corresponding function of
+ * the handler, if it is set. Integers are passed to on_number when on_integer is not set.
+ */
+#define JSON_PARSER_NAME json_parse_generic
+#define JSON_PARSER_HANDLER_TYPE json_parser_handler_t
+#define JSON_PARSER_ON_NULL(handler) ((handler)->on_null == nullptr ? json_create_success_result() : (handler)->on_null(handler))
+#define JSON_PARSER_ON_BOOL(handler, value) ((handler)->on_bool == nullptr ? json_create_success_result() : (handler)->on_bool(handler, value))
+#define JSON_PARSER_ON_NUMBER(handler, value) ((handler)->on_number == nullptr ? json_create_success_result() : (handler)->on_number(handler, value))
+#define JSON_PARSER_ON_STRING(handler, value) ((handler)->on_string == nullptr ? json_create_success_result() : (handler)->on_string(handler, value))
+#define JSON_PARSER_ON_ARRAY_START(handler) ((handler)->on_array_start == nullptr ? json_create_success_result() : (handler)->on_array_start(handler))
+#define JSON_PARSER_ON_ARRAY_END(handler) ((handler)->on_array_end == nullptr ? json_create_success_result() : (handler)->on_array_end(handler))
+#define JSON_PARSER_ON_OBJECT_START(handler) ((handler)->on_object_start == nullptr ? json_create_success_result() : (handler)->on_object_start(handler))
+#define JSON_PARSER_ON_OBJECT_PROPERTY(handler, key) ((handler)->on_object_property == nullptr ? json_create_success_result() : (handler)->on_object_property(handler, key))
+#define JSON_PARSER_ON_OBJECT_END(handler) ((handler)->on_object_end == nullptr ? json_create_success_result() : (handler)->on_object_end(handler))
+#define JSON_PARSER_ON_INTEGER(handler, value) ((handler)->on_integer == nullptr ? JSON_PARSER_ON_NUMBER(handler, (double) (value)) : (handler)->on_integer(handler, value))
+#include "parser_template.h"
+
+json_parser_result_t json_parse(const size_t length, const char json[length], json_parser_handler_t* handler, const json_parser_options_t options) {
+    if (handler == nullptr) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    return json_parse_generic(length, json, handler, options);
+}
+
+json_parser_result_t json_parse_nested_value(const size_t length, const char json[length], json_parser_handler_t* handler, const json_parser_options_t options, const size_t depth, size_t* position) {
     json_stream_parser_state_t state = {
         .json = json,
         .length = length,
@@ -59,115 +81,16 @@ json_parser_result_t json_parse(const size_t length, const char json[length], js
         .max_depth = options.max_depth,
         .max_string_size = options.max_string_size,
         .max_struct_size = options.max_struct_size,
-        .position = 0,
+        .position = *position,
     };
 
-    // @todo set position if not already set
-    return json_parse_value(&state, 0);
-}
-
-static bool skip_whitespace(json_stream_parser_state_t* state) {
-    while (state->position < state->length) {
-        const char current_char = state->json[state->position];
-
-        if (current_char == ' ' || current_char == '\n' || current_char == '\r' || current_char == '\t') {
-            ++state->position;
-            continue;
-        }
-
-        break;
-    }
-
-    return state->position < state->length;
-}
-
-static json_parser_result_t json_parse_value_inner_switch(json_stream_parser_state_t* state, const char current_char, const size_t depth) {
-    switch (current_char) {
-        case 'n':
-            return json_parse_null(state, depth + 1);
-
-        case 't':
-            return json_parse_boolean(state, true, depth + 1);
-
-        case 'f':
-            return json_parse_boolean(state, false, depth + 1);
-
-        case '-':
-        case '0':
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9':
-            return json_parse_number(state, depth + 1);
-
-        case '"':
-            return json_parse_string(state, depth + 1);
-
-        case '{':
-            return json_parse_object(state, depth + 1);
-
-        case '[':
-            return json_parse_array(state, depth + 1);
-
-        default:
-            return (json_parser_result_t) {
-                .code = JSON_PARSE_ERROR_INVALID_SYNTAX,
-                .context = JSON_CONTEXT_UNKNOWN,
-                .error = JSON_ERROR_UNEXPECTED_CHARACTER,
-                .extra = 0,
-                .position = state->position,
-            };
-    }
-}
-
-static json_parser_result_t json_parse_value(json_stream_parser_state_t* state, const size_t depth) {
-    if (state == nullptr) {
-        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, state->position };
-    }
-
-    if (depth > state->max_depth) {
-        return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNKNOWN, 0, state->position };
-    }
-
-    if (!skip_whitespace(state)) {
-        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_UNKNOWN, JSON_ERROR_EMPTY_VALUE, 0, state->position };
-    }
-
-    const size_t position = state->position;
-    const char current_char = state->json[position];
-    const json_parser_result_t result = json_parse_value_inner_switch(state, current_char, depth);
-
-    if (result.code < 0 || result.code > JSON_PARSE_CONFIG_ERROR) {
-        return (json_parser_result_t) {
-            .code = JSON_PARSE_CONFIG_ERROR,
-            .context = JSON_CONTEXT_UNKNOWN,
-            .error = JSON_ERROR_INVALID_CODE,
-            .extra = result.code,
-            .position = state->position,
-        };
-    }
-
-    if (result.code != JSON_PARSE_SUCCESS) {
-        return result;
-    }
-
-    if (state->position <= position) {
-        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_CURSOR_NOT_ADVANCE, 0, state->position };
-    }
-
-    if (state->position > state->length) {
-        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_CURSOR_EXCEED_INPUT, 0, state->position };
-    }
+    const json_parser_result_t result = json_parse_generic_value(&state, handler, depth);
+    *position = state.position;
 
     return result;
 }
 
-static json_parser_result_t json_parse_constant(json_stream_parser_state_t* state, const char* expected_value, const size_t expected_value_length, const size_t depth, const json_parse_context_t context) {
+json_parser_result_t json_parse_constant(json_stream_parser_state_t* state, const char* expected_value, const size_t expected_value_length, const size_t depth, const json_parse_context_t context) {
     if (state == nullptr) {
         return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, context, JSON_ERROR_NULL_POINTER, 0, state->position };
     }
@@ -202,7 +125,7 @@ static json_parser_result_t json_parse_constant(json_stream_parser_state_t* stat
     return json_create_success_result();
 }
 
-static json_parser_result_t json_parse_null(json_stream_parser_state_t* state, const size_t depth) {
+json_parser_result_t json_parse_null(json_stream_parser_state_t* state, const size_t depth) {
     const json_parser_result_t result = json_parse_constant(state, "null", 4, depth, JSON_CONTEXT_NULL);
 
     if (
@@ -215,7 +138,7 @@ static json_parser_result_t json_parse_null(json_stream_parser_state_t* state, c
     return state->handler->on_null(state->handler);
 }
 
-static json_parser_result_t json_parse_boolean(json_stream_parser_state_t* state, const bool expected_value, const size_t depth) {
+json_parser_result_t json_parse_boolean(json_stream_parser_state_t* state, const bool expected_value, const size_t depth) {
     const json_parser_result_t result = expected_value == true
         ? json_parse_constant(state, "true", 4, depth, JSON_CONTEXT_BOOL)
         : json_parse_constant(state, "false", 5, depth, JSON_CONTEXT_BOOL)
@@ -231,7 +154,7 @@ static json_parser_result_t json_parse_boolean(json_stream_parser_state_t* state
     return state->handler->on_bool(state->handler, expected_value);
 }
 
-static json_parser_result_t json_parse_number(json_stream_parser_state_t* state, const size_t depth) {
+json_parser_result_t json_parser_scan_number(json_stream_parser_state_t* state, const size_t depth, json_number_t* number) {
     if (state == nullptr) {
         return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_NUMBER, JSON_ERROR_NULL_POINTER, 0, state->position };
     }
@@ -244,347 +167,174 @@ static json_parser_result_t json_parse_number(json_stream_parser_state_t* state,
         return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_NUMBER, JSON_ERROR_EMPTY_VALUE, 0, state->position };
     }
 
-    const size_t start_position = state->position;
-    const size_t max_position = start_position + 328 > state->length ? state->length : start_position + 328; // 328 is the maximum length of a float64 using decimal notation
-    bool has_decimal_point = false;
-
-    // @todo better parser
-    double integer_part = 0.0;
-    double fractional_part = 0.0;
-    double sign = 1.0;
-
-    for (; state->position < max_position; ++state->position) {
-        const char current_char = state->json[state->position];
-
-        if (current_char >= '0' && current_char <= '9') {
-            const double digit_value = (double)(current_char - '0');
-
-            if (!has_decimal_point) {
-                integer_part = integer_part * 10.0 + digit_value;
-            } else {
-                fractional_part = fractional_part * 10.0 + digit_value;
-            }
-            continue;
-        }
-
-        if (current_char == '-') {
-            if (state->position != start_position) {
-                break;
-            }
-
-            sign = -1.0;
-            continue;
-        }
-
-        if (current_char == '.') {
-            if (has_decimal_point) {
-                break;
-            }
+    return json_number_scan(state->json, state->length, &state->position, number);
+}
 
-            has_decimal_point = true;
-            continue;
-        }
+json_parser_result_t json_parse_number(json_stream_parser_state_t* state, const size_t depth) {
+    json_number_t number;
+    const json_parser_result_t result = json_parser_scan_number(state, depth, &number);
 
-        break; // Invalid character for number
+    if (result.code != JSON_PARSE_SUCCESS) {
+        return result;
     }
 
-    while (fractional_part >= 1.0) {
-        fractional_part /= 10.0;
+    if (number.integer && state->handler->on_integer != nullptr) {
+        return state->handler->on_integer(state->handler, json_number_to_integer(&number));
     }
 
     if (state->handler->on_number == nullptr) {
         return json_create_success_result();
     }
 
-    const double number_value = sign * (integer_part + fractional_part);
-    return state->handler->on_number(state->handler, number_value);
+    return state->handler->on_number(state->handler, json_number_to_double(&number));
 }
 
-static json_parser_result_t json_parse_string_internal(json_stream_parser_state_t* state, const size_t depth, const bool is_property_key) {
-    if (state == nullptr) {
-        return (json_parser_result_t) {
-            .code = JSON_PARSE_CONFIG_ERROR,
-            .context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING,
-            .error = JSON_ERROR_NULL_POINTER,
-            .extra = 0,
-            .position = state->position,
-        };
-    }
-
-    if (depth > state->max_depth) {
-        return (json_parser_result_t) {
-            .code = JSON_PARSE_ERROR_MAX_DEPTH,
-            .context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING,
-            .error = JSON_ERROR_UNKNOWN,
-            .extra = 0,
-            .position = state->position,
-        };
-    }
-
-    if (state->position + 1 >= state->length) {
-        return (json_parser_result_t) {
-            .code = JSON_PARSE_ERROR_UNEXPECTED_END,
-            .context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING,
-            .error = JSON_ERROR_TOO_SMALL,
-            .extra = 0,
-            .position = state->position,
-        };
-    }
+json_parser_result_t json_parse_string_internal(json_stream_parser_state_t* state, const size_t depth, const bool is_property_key) {
+    const size_t start_position = state->position;
+    const json_parser_result_t result = json_parser_scan_string(state, depth, is_property_key);
 
-    if (state->json[state->position] != '"') {
-        return (json_parser_result_t) {
-            .code = JSON_PARSE_ERROR_INVALID_SYNTAX,
-            .context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING,
-            .error = JSON_ERROR_UNEXPECTED_CHARACTER,
-            .extra = '"',
-            .position = state->position,
-        };
+    if (result.code != JSON_PARSE_SUCCESS) {
+        return result;
     }
 
-    // Skip the opening quote
-    const size_t start_position = state->position++;
-    bool is_escaped = false;
-    bool end = false;
-
-    for (; state->position < state->length; ++state->position) {
-        if (state->position - start_position >= state->max_string_size) {
-            return (json_parser_result_t) {
-                .code = JSON_PARSE_ERROR_MAX_STRING_SIZE,
-                .context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING,
-                .error = JSON_ERROR_UNKNOWN,
-                .extra = 0,
-                .position = state->position,
-            };
-        }
-
-        const char current_char = state->json[state->position];
+    return json_parser_emit_string(state, start_position, is_property_key);
+}
 
-        if (is_escaped) {
-            is_escaped = false;
-            continue;
-        }
+json_parser_result_t json_parser_scan_string(json_stream_parser_state_t* state, const size_t depth, const bool is_property_key) {
+    return json_parser_scan_string_limited(state, depth, is_property_key, state != nullptr ? state->max_string_size : 0);
+}
 
-        if (current_char == '\\') {
-            is_escaped = true;
-            continue;
-        }
+json_parser_result_t json_parser_skip_structure(json_stream_parser_state_t* state, const json_parse_context_t context) {
+    json_structural_skip_t skip = { .depth = 1 };
+    const size_t end = json_structural_index_skip(&skip, state->length, state->json, state->position);
 
-        if (current_char == '"') {
-            end = true;
-            break;
-        }
-    }
+    if (skip.depth > 0) {
+        state->position = state->length;
 
-    if (!end) {
         return (json_parser_result_t) {
             .code = JSON_PARSE_ERROR_UNEXPECTED_END,
-            .context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING,
+            .context = context,
             .error = JSON_ERROR_MISSING_CLOSING_CHARACTER,
-            .extra = '"',
-            .position = state->position,
+            .extra = context == JSON_CONTEXT_OBJECT ? '}' : ']',
+            .position = state->length,
         };
     }
 
-    // Move to the next character after the closing quote
-    ++state->position;
-
-    json_parser_result_t (*string_handler)(json_parser_handler_t*, json_raw_string_t) = is_property_key
-        ? state->handler->on_object_property
-        : state->handler->on_string
-    ;
-
-    if (string_handler == nullptr) {
-        return json_create_success_result();
-    }
-
-    const size_t string_length = state->position - start_position;
-    const json_raw_string_t raw_string = {
-        .length = string_length,
-        .value = &state->json[start_position],
-    };
-
-    return string_handler(state->handler, raw_string);
-}
+    state->position = end;
 
-static json_parser_result_t json_parse_string(json_stream_parser_state_t* state, const size_t depth) {
-    return json_parse_string_internal(state, depth, false);
+    return json_create_success_result();
 }
 
-static json_parser_result_t json_parse_object(json_stream_parser_state_t* state, const size_t depth) {
-    if (state == nullptr) {
-        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_OBJECT, JSON_ERROR_NULL_POINTER, 0, state->position };
-    }
+json_parser_result_t json_parser_skip_value(json_stream_parser_state_t* state) {
+    const char* json = state->json;
+    size_t position = json_scan_whitespace(json, state->position, state->length);
 
-    if (depth > state->max_depth) {
-        return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, JSON_CONTEXT_OBJECT, JSON_ERROR_UNKNOWN, 0, state->position };
+    if (position >= state->length) {
+        state->position = position;
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_UNKNOWN, JSON_ERROR_EMPTY_VALUE, 0, position };
     }
 
-    if (state->position + 1 >= state->length) {
-        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_TOO_SMALL, 0, state->position };
-    }
-
-    if (state->json[state->position] != '{') {
-        return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_OBJECT, JSON_ERROR_UNEXPECTED_CHARACTER, '{', state->position };
-    }
-
-    // Skip the opening bracket
-    ++state->position;
-
-    if (state->handler->on_object_start != nullptr) {
-        const json_parser_result_t start_array_result = state->handler->on_object_start(state->handler);
-
-        if (start_array_result.code != JSON_PARSE_SUCCESS) {
-            return start_array_result;
-        }
-    }
+    switch (json[position]) {
+        case '[':
+        case '{':
+            state->position = position + 1;
+            return json_parser_skip_structure(state, json[position] == '{' ? JSON_CONTEXT_OBJECT : JSON_CONTEXT_ARRAY);
 
-    bool end = false;
-    bool property_expected = true;
+        case '"':
+            ++position;
 
-    for (size_t len = 0; state->position < state->length; ++len) {
-        if (len > state->max_struct_size) {
-            return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_STRUCT_SIZE, JSON_CONTEXT_OBJECT, JSON_ERROR_UNKNOWN, 0, state->position };
-        }
+            while (position < state->length) {
+                position = json_scan_string_special(json, position, state->length);
 
-        if (!skip_whitespace(state)) {
-            return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_EMPTY_VALUE, 0, state->position };
-        }
+                if (position >= state->length) {
+                    break;
+                }
 
-        const char current_char = state->json[state->position];
+                if (json[position] == '"') {
+                    state->position = position + 1;
+                    return json_create_success_result();
+                }
 
-        if (current_char == '}') {
-            ++state->position;
-            end = true;
-            break;
-        }
-
-        if (current_char == ',') {
-            if (property_expected == true) {
-                return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_OBJECT, JSON_ERROR_UNEXPECTED_CHARACTER, '"', state->position };
+                // Skip the escaped character too
+                position += json[position] == '\\' ? 2 : 1;
             }
 
-            property_expected = true;
-            ++state->position;
-            continue;
-        }
-
-        if (!property_expected) {
-            return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_OBJECT, JSON_ERROR_UNEXPECTED_CHARACTER, ',', state->position };
-        }
+            state->position = state->length;
+            return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_STRING, JSON_ERROR_MISSING_CLOSING_CHARACTER, '"', state->length };
 
-        property_expected = false;
+        case ',':
+        case ']':
+        case '}':
+        case ':':
+            state->position = position;
+            return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNEXPECTED_CHARACTER, 0, position };
 
-        const json_parser_result_t key_result = json_parse_string_internal(state, depth + 1, true);
-        if (key_result.code != JSON_PARSE_SUCCESS) {
-            return key_result;
-        }
-
-        if (!skip_whitespace(state)) {
-            return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_MISSING_CLOSING_CHARACTER, ':', state->position };
-        }
-
-        if (state->position >= state->length || state->json[state->position] != ':') {
-            return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_OBJECT, JSON_ERROR_UNEXPECTED_CHARACTER, ':', state->position };
-        }
+        default:
+            // Number or literal: skip up to the next separator
+            while (position < state->length) {
+                const char current_char = json[position];
 
-        ++state->position;
+                if (current_char == ',' || current_char == ']' || current_char == '}' || json_is_whitespace(current_char)) {
+                    break;
+                }
 
-        const json_parser_result_t value_result = json_parse_value(state, depth + 1);
-        if (value_result.code != JSON_PARSE_SUCCESS) {
-            return value_result;
-        }
-    }
-
-    if (!end) {
-        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_MISSING_CLOSING_CHARACTER, '}', state->position };
-    }
+                ++position;
+            }
 
-    if (state->handler->on_object_end == nullptr) {
-        return json_create_success_result();
+            state->position = position;
+            return json_create_success_result();
     }
-
-    return state->handler->on_object_end(state->handler);
 }
 
-static json_parser_result_t json_parse_array(json_stream_parser_state_t* state, const size_t depth) {
-    if (state == nullptr) {
-        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_ARRAY, JSON_ERROR_NULL_POINTER, 0, state->position };
-    }
-
-    if (depth > state->max_depth) {
-        return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, JSON_CONTEXT_ARRAY, JSON_ERROR_UNKNOWN, 0, state->position };
-    }
-
-    if (state->position + 1 >= state->length) {
-        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_ARRAY, JSON_ERROR_TOO_SMALL, 0, state->position };
-    }
+json_parser_result_t json_parser_check_string_char(json_stream_parser_state_t* state, const bool is_property_key) {
+    const unsigned char current_char = (unsigned char) state->json[state->position];
 
-    if (state->json[state->position] != '[') {
-        return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_ARRAY, JSON_ERROR_UNEXPECTED_CHARACTER, '[', state->position };
+    if (current_char < 0x20) {
+        return (json_parser_result_t) {
+            .code = JSON_PARSE_ERROR_INVALID_SYNTAX,
+            .context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING,
+            .error = JSON_ERROR_UNEXPECTED_CHARACTER,
+            .extra = 0,
+            .position = state->position,
+        };
     }
 
-    // Skip the opening bracket
-    ++state->position;
+    // The sequence may only be truncated by the max string size: check it against the whole input
+    const size_t sequence_length = json_utf8_sequence_length(state->json, state->position, state->length);
 
-    if (state->handler->on_array_start != nullptr) {
-        const json_parser_result_t start_array_result = state->handler->on_array_start(state->handler);
-
-        if (start_array_result.code != JSON_PARSE_SUCCESS) {
-            return start_array_result;
-        }
+    if (sequence_length == 0) {
+        return (json_parser_result_t) {
+            .code = JSON_PARSE_ERROR_INVALID_SYNTAX,
+            .context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING,
+            .error = JSON_ERROR_INVALID_UTF8,
+            .extra = 0,
+            .position = state->position,
+        };
     }
 
-    bool end = false;
-    bool value_expected = true;
-
-    for (size_t len = 0; state->position < state->length; ++len) {
-        if (len > state->max_struct_size) {
-            return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_STRUCT_SIZE, JSON_CONTEXT_ARRAY, JSON_ERROR_UNKNOWN, 0, state->position };
-        }
-
-        if (!skip_whitespace(state)) {
-            break;
-        }
+    state->position += sequence_length;
 
-        const char current_char = state->json[state->position];
-
-        if (current_char == ']') {
-            ++state->position;
-            end = true;
-            break;
-        }
-
-        if (current_char == ',') {
-            if (value_expected == true) {
-                return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_ARRAY, JSON_ERROR_UNEXPECTED_CHARACTER, 0, state->position };
-            }
-
-            value_expected = true;
-            ++state->position;
-            continue;
-        }
-
-        if (!value_expected) {
-            return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_ARRAY, JSON_ERROR_UNEXPECTED_CHARACTER, ',', state->position };
-        }
-
-        const json_parser_result_t value_result = json_parse_value(state, depth + 1);
-        value_expected = false;
-
-        if (value_result.code != JSON_PARSE_SUCCESS) {
-            return value_result;
-        }
-    }
+    return json_create_success_result();
+}
 
-    if (!end) {
-        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_ARRAY, JSON_ERROR_MISSING_CLOSING_CHARACTER, ']', state->position };
-    }
+json_parser_result_t json_parser_emit_string(json_stream_parser_state_t* state, const size_t start_position, const bool is_property_key) {
+    json_parser_result_t (*string_handler)(json_parser_handler_t*, json_raw_string_t) = is_property_key
+        ? state->handler->on_object_property
+        : state->handler->on_string
+    ;
 
-    if (state->handler->on_array_end == nullptr) {
+    if (string_handler == nullptr) {
         return json_create_success_result();
     }
 
-    return state->handler->on_array_end(state->handler);
+    const size_t string_length = state->position - start_position;
+    const json_raw_string_t raw_string = {
+        .length = string_length,
+        .value = &state->json[start_position],
+        .escape_free = state->string_escape_free,
+    };
+
+    return string_handler(state->handler, raw_string);
 }
 
 static char p_error_message_buffer[128];
@@ -713,6 +463,22 @@ char* json_parse_error_message(json_parser_result_t result) {
             error = "Stack is empty, cannot pop value";
             break;
 
+        case JSON_ERROR_THREAD_FAILURE:
+            error = "Cannot start or synchronize worker threads";
+            break;
+
+        case JSON_ERROR_INVALID_UTF8:
+            error = "Invalid UTF-8 sequence";
+            break;
+
+        case JSON_ERROR_INVALID_POINTER:
+            error = "Invalid JSON pointer";
+            break;
+
+        case JSON_ERROR_IO_FAILURE:
+            error = "Cannot read the input file";
+            break;
+
         default:
             // no extra info
     }
@@ -29,6 +29,12 @@ typedef struct {
      * The pointer to the start of the raw JSON string in the input.
      */
     const char* value;
+
+    /**
+     * True if the parser found no escape sequence while scanning the string, so its content is already decoded.
+     * False if the string has escape sequences, or if it is unknown: the string must then be decoded.
+     */
+    const bool escape_free;
 } json_raw_string_t;
 
 typedef enum: uint8_t {
@@ -76,6 +82,12 @@ typedef enum: uint8_t {
      * This type of error must not happen in normal conditions, indicating a bug in the code.
      */
     JSON_PARSE_CONFIG_ERROR,
+
+    /**
+     * Not an error: returned by the `on_object_property`, `on_array_start` or `on_object_start` handlers
+     * to skip the value without parsing it. See `json_create_skip_result()`.
+     */
+    JSON_PARSE_SKIP,
 } json_parse_code_t;
 
 typedef enum: uint8_t {
@@ -109,6 +121,10 @@ typedef enum: uint8_t {
     JSON_ERROR_INVALID_TYPE,
     JSON_ERROR_STACK_OVERFLOW,
     JSON_ERROR_STACK_EMPTY,
+    JSON_ERROR_THREAD_FAILURE,
+    JSON_ERROR_INVALID_UTF8,
+    JSON_ERROR_INVALID_POINTER,
+    JSON_ERROR_IO_FAILURE,
 } json_parse_error_t;
 
 typedef struct {
@@ -151,6 +167,14 @@ typedef struct {
  *
  * Note: for string parameters, the input buffer will be used directly without copying.
  * So, you must copy the data if you need to keep it after the parsing is complete.
+ *
+ * Numbers without fraction nor exponent which fit in a int64_t are passed to `on_integer`, without float conversion.
+ * If `on_integer` is not set, all numbers are passed to `on_number`.
+ *
+ * `on_object_property`, `on_array_start` and `on_object_start` can return `json_create_skip_result()` to ignore a value:
+ * the value of the property, or the rest of the structure, is skipped by only matching brackets outside of strings.
+ * No handler is called for the skipped value, not even `on_array_end` or `on_object_end` for a skipped structure,
+ * and its content is not checked, nor counted in the limits. The skip result is not supported by the other handlers.
  */
 typedef struct json_parser_handler_t {
     json_parser_result_t (*on_null)(struct json_parser_handler_t* self);
@@ -162,6 +186,9 @@ typedef struct json_parser_handler_t {
     json_parser_result_t (*on_object_start)(struct json_parser_handler_t* self);
     json_parser_result_t (*on_object_property)(struct json_parser_handler_t* self, json_raw_string_t key);
     json_parser_result_t (*on_object_end)(struct json_parser_handler_t* self);
+
+    // Added after the other callbacks: new members go last, so existing handlers keep their layout
+    json_parser_result_t (*on_integer)(struct json_parser_handler_t* self, int64_t value);
 } json_parser_handler_t;
 
 typedef struct {
@@ -189,11 +216,44 @@ typedef struct {
     size_t max_struct_size;
 } json_parser_options_t;
 
+/**
+ * State of an array or object being parsed by `json_parse_iterative()`.
+ * The fields are internal to the parser.
+ */
+typedef struct {
+    /**
+     * Number of elements and separators already parsed
+     */
+    uint32_t length;
+
+    /**
+     * JSON_CONTEXT_ARRAY or JSON_CONTEXT_OBJECT
+     */
+    json_parse_context_t type;
+
+    /**
+     * Whether a value (for arrays) or a property (for objects) is expected, i.e. after the opening bracket or a comma
+     */
+    bool expected;
+} json_parser_frame_t;
+
+/**
+ * Number of frames needed by `json_parse_iterative()` to reach the given max depth.
+ * Each nested structure takes two levels of depth: one for the value, and one for the structure itself.
+ */
+#define JSON_PARSER_STACK_SIZE(max_depth) ((max_depth) / 2 + 1)
+
 /**
  * Create a success result for JSON parsing.
  */
 json_parser_result_t json_create_success_result();
 
+/**
+ * Create a result asking the parser to skip the current value, for the handlers supporting it.
+ * See `json_parser_handler_t`.
+ */
+json_parser_result_t json_create_skip_result();
+
 /**
  * Fill the given json_parser_options_t structure with default values for any field set to zero.
  */
@@ -207,6 +267,68 @@ json_parser_options_t json_default_parser_options(json_parser_options_t options)
  */
 json_parser_result_t json_parse(size_t length, const char json[length], json_parser_handler_t* handler, json_parser_options_t options);
 
+/**
+ * Parse the JSON input string like `json_parse()`, without recursion.
+ * Nested structures are tracked in the stack provided by the caller, so deep documents do not use the C stack.
+ *
+ * The handler receives the same events, and errors are reported the same way as `json_parse()`.
+ * If the stack is too small for the document, `JSON_PARSE_ERROR_MAX_DEPTH` is returned with `JSON_ERROR_STACK_OVERFLOW`.
+ * Use `JSON_PARSER_STACK_SIZE(options.max_depth)` frames to only be limited by the max depth option.
+ *
+ * @param length The length of the JSON input string.
+ * @param json The JSON input string to parse. Null-terminated is not required.
+ * @param stack_size The number of frames in the stack, i.e. the maximum number of nested arrays or objects.
+ * @param stack The stack used to track nested structures.
+ */
+json_parser_result_t json_parse_iterative(size_t length, const char json[length], json_parser_handler_t* handler, json_parser_options_t options, size_t stack_size, json_parser_frame_t stack[stack_size]);
+
+/**
+ * Parse the JSON input string like `json_parse()`, using a two stages algorithm.
+ * The structural characters are first indexed by blocks of 64 bytes using SIMD instructions,
+ * then the index is walked to invoke the handler callbacks.
+ *
+ * The handler receives the same events, and errors are reported the same way as `json_parse()`.
+ * Which engine is faster depends on the shape of the documents: compare them with the `indexed_parser` benchmark.
+ * The nested structures are tracked in the given stack, like `json_parse_iterative()`.
+ *
+ * @param length The length of the JSON input string.
+ * @param json The JSON input string to parse. Null-terminated is not required.
+ * @param stack_size The number of frames in the stack, i.e. the maximum number of nested arrays or objects.
+ * @param stack The stack used to track nested structures.
+ */
+json_parser_result_t json_parse_indexed(size_t length, const char json[length], json_parser_handler_t* handler, json_parser_options_t options, size_t stack_size, json_parser_frame_t stack[stack_size]);
+
+/**
+ * Check that the input is a valid JSON document, without calling any handler nor converting any value.
+ *
+ * The validation is strict, following RFC 8259: unlike `json_parse()`, trailing commas and content after the root value
+ * are rejected, and strings must only contain valid escape sequences and valid UTF-8, without raw control characters.
+ * The limits of the options are applied like `json_parse()`.
+ * Invalid UTF-8 is reported with `JSON_ERROR_INVALID_UTF8`, at the position of the first byte of the invalid sequence.
+ *
+ * @param length The length of the JSON input string.
+ * @param json The JSON input string to validate. Null-terminated is not required.
+ */
+json_parser_result_t json_validate(size_t length, const char json[length], json_parser_options_t options);
+
+/**
+ * Find the value designated by a JSON Pointer (RFC 6901), like "/meta/request_id" or "/items/0", without parsing the whole input.
+ *
+ * The properties and elements which are not on the path are skipped by matching brackets, without checking their content,
+ * like with a skip result of the handlers. Only the target value is parsed, with the options limits applied as if the whole
+ * document was parsed by `json_parse()`, and the input is not read after it.
+ * With duplicated keys, the first matching property is used.
+ *
+ * If the pointer does not designate any value, a success result is returned, and the value of out is set to nullptr.
+ * A malformed pointer is reported with `JSON_ERROR_INVALID_POINTER`, at the position of the error in the pointer.
+ *
+ * @param length The length of the JSON input string.
+ * @param json The JSON input string. Null-terminated is not required.
+ * @param pointer The null-terminated JSON Pointer. The empty pointer designates the root value.
+ * @param out Receive the raw text of the value in the input, without surrounding whitespaces.
+ */
+json_parser_result_t json_extract(size_t length, const char json[length], const char* pointer, json_parser_options_t options, json_raw_string_t* out);
+
 /**
  * Get a human-readable error message for the given parser result.
  * The result will be a static null-terminated string, do not free it.
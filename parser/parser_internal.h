@@ -0,0 +1,249 @@
+#ifndef JSON_PARSER_INTERNAL_H
+#define JSON_PARSER_INTERNAL_H
+
+/**
+ * Internal functions of the streaming parser, shared between the parser engines.
+ * This header is not part of the public API.
+ */
+
+#include "number.h"
+#include "parser.h"
+#include "scanner.h"
+#include "structural_index.h"
+
+typedef struct {
+    const char* json;
+    const size_t length;
+    json_parser_handler_t* handler;
+    const size_t max_depth;
+    const size_t max_string_size;
+    const size_t max_struct_size;
+    size_t position;
+
+    /**
+     * Set by the scan of a string: true if it has no escape sequence
+     */
+    bool string_escape_free;
+} json_stream_parser_state_t;
+
+/**
+ * Check the parameters given to a parser entry point.
+ * The options must already be filled with default values.
+ */
+json_parser_result_t json_parser_check_input(size_t length, const char* json, const json_parser_handler_t* handler, json_parser_options_t options);
+
+/**
+ * Check the limits given in the parser options.
+ * The options must already be filled with default values.
+ */
+json_parser_result_t json_parser_check_options(json_parser_options_t options);
+
+/**
+ * Parse the value at the given position with `json_parse()`, as if it was at the given depth of the document,
+ * and move the position after it. Used to parse the elements of a document separately.
+ * The options must already be filled with default values and checked.
+ */
+json_parser_result_t json_parse_nested_value(size_t length, const char json[length], json_parser_handler_t* handler, json_parser_options_t options, size_t depth, size_t* position);
+
+/**
+ * Check that the literal at the current position is expected_value, and move the position after it.
+ */
+json_parser_result_t json_parse_constant(json_stream_parser_state_t* state, const char* expected_value, size_t expected_value_length, size_t depth, json_parse_context_t context);
+
+/**
+ * Parse the null literal at the current position, and call the handler.
+ */
+json_parser_result_t json_parse_null(json_stream_parser_state_t* state, size_t depth);
+
+/**
+ * Parse the boolean literal at the current position, and call the handler.
+ * The literal is expected to match expected_value, which is deduced from the first character.
+ */
+json_parser_result_t json_parse_boolean(json_stream_parser_state_t* state, bool expected_value, size_t depth);
+
+/**
+ * Scan the number at the current position, and move the position after it, without calling the handler.
+ */
+json_parser_result_t json_parser_scan_number(json_stream_parser_state_t* state, size_t depth, json_number_t* number);
+
+/**
+ * Parse the number at the current position, and call the handler.
+ */
+json_parser_result_t json_parse_number(json_stream_parser_state_t* state, size_t depth);
+
+/**
+ * Check the character of a string at the current position, when `json_scan_string_utf8()` stopped on it
+ * and it is neither a quote nor a backslash: a control character, or the first byte of an invalid or truncated UTF-8 sequence.
+ * An error is returned at the current position, unless the sequence is only truncated by the scan end: the position is then moved after it.
+ */
+json_parser_result_t json_parser_check_string_char(json_stream_parser_state_t* state, bool is_property_key);
+
+/**
+ * Scan the string at the current position like `json_parser_scan_string()`, with the given max string size
+ * instead of the one of the state. Inlined by the parser template, so a constant limit folds into the scan.
+ */
+static inline json_parser_result_t json_parser_scan_string_limited(json_stream_parser_state_t* state, const size_t depth, const bool is_property_key, const size_t max_string_size) {
+    if (state == nullptr) {
+        return (json_parser_result_t) {
+            .code = JSON_PARSE_CONFIG_ERROR,
+            .context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING,
+            .error = JSON_ERROR_NULL_POINTER,
+            .extra = 0,
+            .position = state->position,
+        };
+    }
+
+    if (depth > state->max_depth) {
+        return (json_parser_result_t) {
+            .code = JSON_PARSE_ERROR_MAX_DEPTH,
+            .context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING,
+            .error = JSON_ERROR_UNKNOWN,
+            .extra = 0,
+            .position = state->position,
+        };
+    }
+
+    if (state->position + 1 >= state->length) {
+        return (json_parser_result_t) {
+            .code = JSON_PARSE_ERROR_UNEXPECTED_END,
+            .context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING,
+            .error = JSON_ERROR_TOO_SMALL,
+            .extra = 0,
+            .position = state->position,
+        };
+    }
+
+    if (state->json[state->position] != '"') {
+        return (json_parser_result_t) {
+            .code = JSON_PARSE_ERROR_INVALID_SYNTAX,
+            .context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING,
+            .error = JSON_ERROR_UNEXPECTED_CHARACTER,
+            .extra = '"',
+            .position = state->position,
+        };
+    }
+
+    // Skip the opening quote
+    const size_t start_position = state->position++;
+    const size_t scan_end = state->length - start_position > max_string_size
+        ? start_position + max_string_size
+        : state->length
+    ;
+    bool end = false;
+    bool escape_free = true;
+
+    while (state->position < scan_end) {
+        // Jump over regular characters and valid UTF-8 sequences, and only handle the other characters one by one
+        state->position = json_scan_string_utf8(state->json, state->position, scan_end);
+
+        if (state->position >= scan_end) {
+            break;
+        }
+
+        const char current_char = state->json[state->position];
+
+        if (current_char == '"') {
+            end = true;
+            break;
+        }
+
+        if (current_char == '\\') {
+            // Skip the escaped character too, unless it starts a UTF-8 sequence: the sequence is then checked as any other
+            state->position += state->position + 1 < scan_end && (unsigned char) state->json[state->position + 1] >= 0x80 ? 1 : 2;
+            escape_free = false;
+            continue;
+        }
+
+        const json_parser_result_t char_result = json_parser_check_string_char(state, is_property_key);
+
+        if (char_result.code != JSON_PARSE_SUCCESS) {
+            return char_result;
+        }
+    }
+
+    if (!end && scan_end < state->length) {
+        return (json_parser_result_t) {
+            .code = JSON_PARSE_ERROR_MAX_STRING_SIZE,
+            .context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING,
+            .error = JSON_ERROR_UNKNOWN,
+            .extra = 0,
+            .position = scan_end,
+        };
+    }
+
+    if (state->position > state->length) {
+        // The last character is an escape, so the cursor has been moved past the end
+        state->position = state->length;
+    }
+
+    if (!end) {
+        return (json_parser_result_t) {
+            .code = JSON_PARSE_ERROR_UNEXPECTED_END,
+            .context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING,
+            .error = JSON_ERROR_MISSING_CLOSING_CHARACTER,
+            .extra = '"',
+            .position = state->position,
+        };
+    }
+
+    // Move to the next character after the closing quote
+    ++state->position;
+    state->string_escape_free = escape_free;
+
+    return json_create_success_result();
+}
+
+/**
+ * Scan the string at the current position (opening quote), and move the position after the closing quote,
+ * without calling the handler. On success, `string_escape_free` tells if the string has escape sequences.
+ */
+json_parser_result_t json_parser_scan_string(json_stream_parser_state_t* state, size_t depth, bool is_property_key);
+
+/**
+ * Parse the string at the current position (opening quote), and call the string or property handler.
+ */
+json_parser_result_t json_parse_string_internal(json_stream_parser_state_t* state, size_t depth, bool is_property_key);
+
+/**
+ * Skip the rest of the structure opened just before the current position, without checking it nor calling any handler.
+ * See `json_structural_index_skip()`.
+ */
+json_parser_result_t json_parser_skip_structure(json_stream_parser_state_t* state, json_parse_context_t context);
+
+/**
+ * Skip the value at the current position (after optional whitespaces), without checking it nor calling any handler.
+ * Structures are skipped by matching brackets, strings by searching the closing quote, and other scalars up to the next separator.
+ */
+json_parser_result_t json_parser_skip_value(json_stream_parser_state_t* state);
+
+/**
+ * Check the syntax of a JSON Pointer: it must be empty, or start with a slash, and "~" must be followed by "0" or "1".
+ * The error position is the position in the pointer.
+ */
+json_parser_result_t json_pointer_check(const char* pointer);
+
+/**
+ * Compare the content of a raw property key, between key_position and key_end, with a reference token of a checked JSON Pointer.
+ * The escape sequences of the key, and the "~0" and "~1" sequences of the token, are decoded on the fly.
+ */
+bool json_pointer_key_matches(const char* key, size_t key_position, size_t key_end, const char* token, size_t token_length);
+
+/**
+ * Parse a reference token as an array index: "0", or digits without leading zero.
+ * Return false for any other token, including "-" which designates the element after the last one.
+ */
+bool json_pointer_array_index(const char* token, size_t token_length, size_t* index);
+
+/**
+ * Call the string or property handler for the string starting at start_position (opening quote),
+ * and ending just before the current position (so the closing quote is at `position - 1`).
+ */
+json_parser_result_t json_parser_emit_string(json_stream_parser_state_t* state, size_t start_position, bool is_property_key);
+
+/**
+ * Parse the value at the current position with the iterative engine, using the given stack for nested structures.
+ * If index is not null, it is used to skip whitespaces and strings instead of scanning them.
+ */
+json_parser_result_t json_parse_stack(json_stream_parser_state_t* state, json_structural_index_t* index, size_t stack_size, json_parser_frame_t stack[stack_size]);
+
+#endif //JSON_PARSER_INTERNAL_H
@@ -0,0 +1,489 @@
+/**
+ * Template of the recursive streaming parser, specialized at compile time for a set of event handlers and limits.
+ * `json_parse()` is the generic instance of this template, which calls the handler functions of a `json_parser_handler_t`.
+ *
+ * When the handlers are known at compile time, instantiating the parser with them allows the compiler to inline them,
+ * and to remove the events which are not handled. To instantiate the parser, define the parameters below and include this file.
+ * It can be included several times in the same file, the parameters are undefined at the end.
+ *
+ * Required parameters:
+ * - JSON_PARSER_NAME: The name of the generated function
+ * - JSON_PARSER_HANDLER_TYPE: The type pointed by the handler parameter of the generated function
+ *
+ * Event parameters, all optional. Each one is called as a function-like macro, with the handler pointer as first argument,
+ * and must evaluate to a `json_parser_result_t`. An undefined event is ignored.
+ * - JSON_PARSER_ON_NULL(handler)
+ * - JSON_PARSER_ON_BOOL(handler, bool value)
+ * - JSON_PARSER_ON_NUMBER(handler, double value)
+ * - JSON_PARSER_ON_STRING(handler, json_raw_string_t value)
+ * - JSON_PARSER_ON_ARRAY_START(handler)
+ * - JSON_PARSER_ON_ARRAY_END(handler)
+ * - JSON_PARSER_ON_OBJECT_START(handler)
+ * - JSON_PARSER_ON_OBJECT_PROPERTY(handler, json_raw_string_t key)
+ * - JSON_PARSER_ON_OBJECT_END(handler)
+ * - JSON_PARSER_ON_INTEGER(handler, int64_t value): Numbers without fraction nor exponent which fit in a int64_t.
+ *   If not defined, they are passed to JSON_PARSER_ON_NUMBER.
+ *
+ * Other optional parameters:
+ * - JSON_PARSER_MAX_DEPTH, JSON_PARSER_MAX_STRING_SIZE, JSON_PARSER_MAX_STRUCT_SIZE: Constant limits, replacing the
+ *   corresponding option given at runtime.
+ * - JSON_PARSER_LINKAGE: The linkage of the generated function. Default to `static`.
+ *
+ * The generated function has the following signature, and the same behavior as `json_parse()`,
+ * except that the handler pointer is only passed to the events, so it may be null:
+ *
+ *     json_parser_result_t JSON_PARSER_NAME(size_t length, const char json[length], JSON_PARSER_HANDLER_TYPE* handler, json_parser_options_t options);
+ *
+ * Example:
+ *
+ *     #define JSON_PARSER_NAME count_numbers
+ *     #define JSON_PARSER_HANDLER_TYPE size_t
+ *     #define JSON_PARSER_ON_NUMBER(count, value) (++*(count), json_create_success_result())
+ *     #define JSON_PARSER_MAX_DEPTH 16
+ *     #include "parser_template.h"
+ */
+
+#include "number.h"
+#include "parser.h"
+#include "parser_internal.h"
+#include "scanner.h"
+
+#ifndef JSON_PARSER_NAME
+#error "JSON_PARSER_NAME must be defined before including parser_template.h"
+#endif
+
+#ifndef JSON_PARSER_HANDLER_TYPE
+#error "JSON_PARSER_HANDLER_TYPE must be defined before including parser_template.h"
+#endif
+
+#ifndef JSON_PARSER_LINKAGE
+#define JSON_PARSER_LINKAGE static
+#endif
+
+#define JSON_TEMPLATE_CONCAT_(name, suffix) name##_##suffix
+#define JSON_TEMPLATE_CONCAT(name, suffix) JSON_TEMPLATE_CONCAT_(name, suffix)
+#define JSON_TEMPLATE_FUNCTION(suffix) JSON_TEMPLATE_CONCAT(JSON_PARSER_NAME, suffix)
+
+#ifdef JSON_PARSER_MAX_DEPTH
+#define JSON_TEMPLATE_MAX_DEPTH(state) ((size_t) (JSON_PARSER_MAX_DEPTH))
+#else
+#define JSON_TEMPLATE_MAX_DEPTH(state) ((state)->max_depth)
+#endif
+
+#ifdef JSON_PARSER_MAX_STRING_SIZE
+#define JSON_TEMPLATE_MAX_STRING_SIZE(state) ((size_t) (JSON_PARSER_MAX_STRING_SIZE))
+#else
+#define JSON_TEMPLATE_MAX_STRING_SIZE(state) ((state)->max_string_size)
+#endif
+
+#ifdef JSON_PARSER_MAX_STRUCT_SIZE
+#define JSON_TEMPLATE_MAX_STRUCT_SIZE(state) ((size_t) (JSON_PARSER_MAX_STRUCT_SIZE))
+#else
+#define JSON_TEMPLATE_MAX_STRUCT_SIZE(state) ((state)->max_struct_size)
+#endif
+
+static json_parser_result_t JSON_TEMPLATE_FUNCTION(value)(json_stream_parser_state_t* state, JSON_PARSER_HANDLER_TYPE* handler, size_t depth);
+
+static inline bool JSON_TEMPLATE_FUNCTION(skip_whitespace)(json_stream_parser_state_t* state) {
+    state->position = json_scan_whitespace(state->json, state->position, state->length);
+
+    return state->position < state->length;
+}
+
+static json_parser_result_t JSON_TEMPLATE_FUNCTION(null)(json_stream_parser_state_t* state, JSON_PARSER_HANDLER_TYPE* handler, const size_t depth) {
+    const json_parser_result_t result = json_parse_constant(state, "null", 4, depth, JSON_CONTEXT_NULL);
+
+#ifdef JSON_PARSER_ON_NULL
+    if (result.code == JSON_PARSE_SUCCESS) {
+        return JSON_PARSER_ON_NULL(handler);
+    }
+#endif
+
+    return result;
+}
+
+static json_parser_result_t JSON_TEMPLATE_FUNCTION(boolean)(json_stream_parser_state_t* state, JSON_PARSER_HANDLER_TYPE* handler, const bool expected_value, const size_t depth) {
+    const json_parser_result_t result = expected_value == true
+        ? json_parse_constant(state, "true", 4, depth, JSON_CONTEXT_BOOL)
+        : json_parse_constant(state, "false", 5, depth, JSON_CONTEXT_BOOL)
+    ;
+
+#ifdef JSON_PARSER_ON_BOOL
+    if (result.code == JSON_PARSE_SUCCESS) {
+        return JSON_PARSER_ON_BOOL(handler, expected_value);
+    }
+#endif
+
+    return result;
+}
+
+static json_parser_result_t JSON_TEMPLATE_FUNCTION(number)(json_stream_parser_state_t* state, JSON_PARSER_HANDLER_TYPE* handler, const size_t depth) {
+    json_number_t number;
+    const json_parser_result_t result = json_parser_scan_number(state, depth, &number);
+
+    if (result.code != JSON_PARSE_SUCCESS) {
+        return result;
+    }
+
+#ifdef JSON_PARSER_ON_INTEGER
+    if (number.integer) {
+        return JSON_PARSER_ON_INTEGER(handler, json_number_to_integer(&number));
+    }
+#endif
+
+#ifdef JSON_PARSER_ON_NUMBER
+    return JSON_PARSER_ON_NUMBER(handler, json_number_to_double(&number));
+#else
+    return result;
+#endif
+}
+
+static json_parser_result_t JSON_TEMPLATE_FUNCTION(string)(json_stream_parser_state_t* state, JSON_PARSER_HANDLER_TYPE* handler, const size_t depth) {
+    const size_t start_position = state->position;
+    const json_parser_result_t result = json_parser_scan_string_limited(state, depth, false, JSON_TEMPLATE_MAX_STRING_SIZE(state));
+
+#ifdef JSON_PARSER_ON_STRING
+    if (result.code == JSON_PARSE_SUCCESS) {
+        return JSON_PARSER_ON_STRING(handler, ((json_raw_string_t) {
+            .length = state->position - start_position,
+            .value = &state->json[start_position],
+            .escape_free = state->string_escape_free,
+        }));
+    }
+#endif
+
+    return result;
+}
+
+static json_parser_result_t JSON_TEMPLATE_FUNCTION(object)(json_stream_parser_state_t* state, JSON_PARSER_HANDLER_TYPE* handler, const size_t depth) {
+    if (depth > JSON_TEMPLATE_MAX_DEPTH(state)) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, JSON_CONTEXT_OBJECT, JSON_ERROR_UNKNOWN, 0, state->position };
+    }
+
+    if (state->position + 1 >= state->length) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_TOO_SMALL, 0, state->position };
+    }
+
+    // Skip the opening bracket
+    ++state->position;
+
+#ifdef JSON_PARSER_ON_OBJECT_START
+    const json_parser_result_t start_result = JSON_PARSER_ON_OBJECT_START(handler);
+
+    if (start_result.code == JSON_PARSE_SKIP) {
+        return json_parser_skip_structure(state, JSON_CONTEXT_OBJECT);
+    }
+
+    if (start_result.code != JSON_PARSE_SUCCESS) {
+        return start_result;
+    }
+#endif
+
+    bool end = false;
+    bool property_expected = true;
+
+    for (size_t len = 0; state->position < state->length; ++len) {
+        if (len > JSON_TEMPLATE_MAX_STRUCT_SIZE(state)) {
+            return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_STRUCT_SIZE, JSON_CONTEXT_OBJECT, JSON_ERROR_UNKNOWN, 0, state->position };
+        }
+
+        if (!JSON_TEMPLATE_FUNCTION(skip_whitespace)(state)) {
+            return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_EMPTY_VALUE, 0, state->position };
+        }
+
+        const char current_char = state->json[state->position];
+
+        if (current_char == '}') {
+            ++state->position;
+            end = true;
+            break;
+        }
+
+        if (current_char == ',') {
+            if (property_expected == true) {
+                return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_OBJECT, JSON_ERROR_UNEXPECTED_CHARACTER, '"', state->position };
+            }
+
+            property_expected = true;
+            ++state->position;
+            continue;
+        }
+
+        if (!property_expected) {
+            return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_OBJECT, JSON_ERROR_UNEXPECTED_CHARACTER, ',', state->position };
+        }
+
+        property_expected = false;
+
+        const size_t key_position = state->position;
+        const json_parser_result_t key_result = json_parser_scan_string_limited(state, depth + 1, true, JSON_TEMPLATE_MAX_STRING_SIZE(state));
+
+        if (key_result.code != JSON_PARSE_SUCCESS) {
+            return key_result;
+        }
+
+#ifdef JSON_PARSER_ON_OBJECT_PROPERTY
+        const json_parser_result_t property_result = JSON_PARSER_ON_OBJECT_PROPERTY(handler, ((json_raw_string_t) {
+            .length = state->position - key_position,
+            .value = &state->json[key_position],
+            .escape_free = state->string_escape_free,
+        }));
+        const bool skip_value = property_result.code == JSON_PARSE_SKIP;
+
+        if (property_result.code != JSON_PARSE_SUCCESS && !skip_value) {
+            return property_result;
+        }
+#else
+        (void) key_position;
+        constexpr bool skip_value = false;
+#endif
+
+        if (!JSON_TEMPLATE_FUNCTION(skip_whitespace)(state)) {
+            return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_MISSING_CLOSING_CHARACTER, ':', state->position };
+        }
+
+        if (state->json[state->position] != ':') {
+            return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_OBJECT, JSON_ERROR_UNEXPECTED_CHARACTER, ':', state->position };
+        }
+
+        ++state->position;
+
+        const json_parser_result_t value_result = skip_value
+            ? json_parser_skip_value(state)
+            : JSON_TEMPLATE_FUNCTION(value)(state, handler, depth + 1)
+        ;
+
+        if (value_result.code != JSON_PARSE_SUCCESS) {
+            return value_result;
+        }
+    }
+
+    if (!end) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_MISSING_CLOSING_CHARACTER, '}', state->position };
+    }
+
+#ifdef JSON_PARSER_ON_OBJECT_END
+    return JSON_PARSER_ON_OBJECT_END(handler);
+#else
+    return json_create_success_result();
+#endif
+}
+
+static json_parser_result_t JSON_TEMPLATE_FUNCTION(array)(json_stream_parser_state_t* state, JSON_PARSER_HANDLER_TYPE* handler, const size_t depth) {
+    if (depth > JSON_TEMPLATE_MAX_DEPTH(state)) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, JSON_CONTEXT_ARRAY, JSON_ERROR_UNKNOWN, 0, state->position };
+    }
+
+    if (state->position + 1 >= state->length) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_ARRAY, JSON_ERROR_TOO_SMALL, 0, state->position };
+    }
+
+    // Skip the opening bracket
+    ++state->position;
+
+#ifdef JSON_PARSER_ON_ARRAY_START
+    const json_parser_result_t start_result = JSON_PARSER_ON_ARRAY_START(handler);
+
+    if (start_result.code == JSON_PARSE_SKIP) {
+        return json_parser_skip_structure(state, JSON_CONTEXT_ARRAY);
+    }
+
+    if (start_result.code != JSON_PARSE_SUCCESS) {
+        return start_result;
+    }
+#endif
+
+    bool end = false;
+    bool value_expected = true;
+
+    for (size_t len = 0; state->position < state->length; ++len) {
+        if (len > JSON_TEMPLATE_MAX_STRUCT_SIZE(state)) {
+            return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_STRUCT_SIZE, JSON_CONTEXT_ARRAY, JSON_ERROR_UNKNOWN, 0, state->position };
+        }
+
+        if (!JSON_TEMPLATE_FUNCTION(skip_whitespace)(state)) {
+            break;
+        }
+
+        const char current_char = state->json[state->position];
+
+        if (current_char == ']') {
+            ++state->position;
+            end = true;
+            break;
+        }
+
+        if (current_char == ',') {
+            if (value_expected == true) {
+                return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_ARRAY, JSON_ERROR_UNEXPECTED_CHARACTER, 0, state->position };
+            }
+
+            value_expected = true;
+            ++state->position;
+            continue;
+        }
+
+        if (!value_expected) {
+            return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_ARRAY, JSON_ERROR_UNEXPECTED_CHARACTER, ',', state->position };
+        }
+
+        const json_parser_result_t value_result = JSON_TEMPLATE_FUNCTION(value)(state, handler, depth + 1);
+        value_expected = false;
+
+        if (value_result.code != JSON_PARSE_SUCCESS) {
+            return value_result;
+        }
+    }
+
+    if (!end) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_ARRAY, JSON_ERROR_MISSING_CLOSING_CHARACTER, ']', state->position };
+    }
+
+#ifdef JSON_PARSER_ON_ARRAY_END
+    return JSON_PARSER_ON_ARRAY_END(handler);
+#else
+    return json_create_success_result();
+#endif
+}
+
+static json_parser_result_t JSON_TEMPLATE_FUNCTION(value_inner_switch)(json_stream_parser_state_t* state, JSON_PARSER_HANDLER_TYPE* handler, const char current_char, const size_t depth) {
+    switch (current_char) {
+        case 'n':
+            return JSON_TEMPLATE_FUNCTION(null)(state, handler, depth + 1);
+
+        case 't':
+            return JSON_TEMPLATE_FUNCTION(boolean)(state, handler, true, depth + 1);
+
+        case 'f':
+            return JSON_TEMPLATE_FUNCTION(boolean)(state, handler, false, depth + 1);
+
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            return JSON_TEMPLATE_FUNCTION(number)(state, handler, depth + 1);
+
+        case '"':
+            return JSON_TEMPLATE_FUNCTION(string)(state, handler, depth + 1);
+
+        case '{':
+            return JSON_TEMPLATE_FUNCTION(object)(state, handler, depth + 1);
+
+        case '[':
+            return JSON_TEMPLATE_FUNCTION(array)(state, handler, depth + 1);
+
+        default:
+            return (json_parser_result_t) {
+                .code = JSON_PARSE_ERROR_INVALID_SYNTAX,
+                .context = JSON_CONTEXT_UNKNOWN,
+                .error = JSON_ERROR_UNEXPECTED_CHARACTER,
+                .extra = 0,
+                .position = state->position,
+            };
+    }
+}
+
+static json_parser_result_t JSON_TEMPLATE_FUNCTION(value)(json_stream_parser_state_t* state, JSON_PARSER_HANDLER_TYPE* handler, const size_t depth) {
+    if (depth > JSON_TEMPLATE_MAX_DEPTH(state)) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNKNOWN, 0, state->position };
+    }
+
+    if (!JSON_TEMPLATE_FUNCTION(skip_whitespace)(state)) {
+        return (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_UNKNOWN, JSON_ERROR_EMPTY_VALUE, 0, state->position };
+    }
+
+    const size_t position = state->position;
+    const char current_char = state->json[position];
+    const json_parser_result_t result = JSON_TEMPLATE_FUNCTION(value_inner_switch)(state, handler, current_char, depth);
+
+    if (result.code < 0 || result.code > JSON_PARSE_CONFIG_ERROR) {
+        return (json_parser_result_t) {
+            .code = JSON_PARSE_CONFIG_ERROR,
+            .context = JSON_CONTEXT_UNKNOWN,
+            .error = JSON_ERROR_INVALID_CODE,
+            .extra = result.code,
+            .position = state->position,
+        };
+    }
+
+    if (result.code != JSON_PARSE_SUCCESS) {
+        return result;
+    }
+
+    if (state->position <= position) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_CURSOR_NOT_ADVANCE, 0, state->position };
+    }
+
+    if (state->position > state->length) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_CURSOR_EXCEED_INPUT, 0, state->position };
+    }
+
+    return result;
+}
+
+JSON_PARSER_LINKAGE json_parser_result_t JSON_PARSER_NAME(const size_t length, const char json[length], JSON_PARSER_HANDLER_TYPE* handler, json_parser_options_t options) {
+#ifdef JSON_PARSER_MAX_DEPTH
+    options.max_depth = JSON_PARSER_MAX_DEPTH;
+#endif
+#ifdef JSON_PARSER_MAX_STRING_SIZE
+    options.max_string_size = JSON_PARSER_MAX_STRING_SIZE;
+#endif
+#ifdef JSON_PARSER_MAX_STRUCT_SIZE
+    options.max_struct_size = JSON_PARSER_MAX_STRUCT_SIZE;
+#endif
+
+    options = json_default_parser_options(options);
+
+    if (json == nullptr || length == 0) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    const json_parser_result_t options_result = json_parser_check_options(options);
+
+    if (options_result.code != JSON_PARSE_SUCCESS) {
+        return options_result;
+    }
+
+    json_stream_parser_state_t state = {
+        .json = json,
+        .length = length,
+        .handler = nullptr,
+        .max_depth = options.max_depth,
+        .max_string_size = options.max_string_size,
+        .max_struct_size = options.max_struct_size,
+        .position = 0,
+    };
+
+    return JSON_TEMPLATE_FUNCTION(value)(&state, handler, 0);
+}
+
+#undef JSON_TEMPLATE_CONCAT_
+#undef JSON_TEMPLATE_CONCAT
+#undef JSON_TEMPLATE_FUNCTION
+#undef JSON_TEMPLATE_MAX_DEPTH
+#undef JSON_TEMPLATE_MAX_STRING_SIZE
+#undef JSON_TEMPLATE_MAX_STRUCT_SIZE
+
+#undef JSON_PARSER_NAME
+#undef JSON_PARSER_HANDLER_TYPE
+#undef JSON_PARSER_LINKAGE
+#undef JSON_PARSER_MAX_DEPTH
+#undef JSON_PARSER_MAX_STRING_SIZE
+#undef JSON_PARSER_MAX_STRUCT_SIZE
+#undef JSON_PARSER_ON_NULL
+#undef JSON_PARSER_ON_BOOL
+#undef JSON_PARSER_ON_NUMBER
+#undef JSON_PARSER_ON_STRING
+#undef JSON_PARSER_ON_ARRAY_START
+#undef JSON_PARSER_ON_ARRAY_END
+#undef JSON_PARSER_ON_OBJECT_START
+#undef JSON_PARSER_ON_OBJECT_PROPERTY
+#undef JSON_PARSER_ON_OBJECT_END
+#undef JSON_PARSER_ON_INTEGER
@@ -0,0 +1,746 @@
+#include "push_parser.h"
+
+#include <string.h>
+
+#include "parser_internal.h"
+#include "scanner.h"
+#include "structural_index.h"
+
+/**
+ * The push parser follows the same rules as the iterative engine: each nesting level counts twice in depth,
+ * and structure sizes count separators too. Tokens are parsed with the functions of the streaming parser,
+ * over the chunk when they are complete, or over the parser buffer when they are split between chunks.
+ */
+
+static json_parser_result_t json_push_parser_fail(json_push_parser_t* parser, const json_parser_result_t result) {
+    parser->phase = JSON_PUSH_PARSER_FAILED;
+    memcpy(&parser->error, &result, sizeof(result));
+
+    return result;
+}
+
+/**
+ * Fail with the result of a parser function working on a part of the input starting at the given position.
+ * Handler errors are kept as is, like json_parse() does.
+ */
+static json_parser_result_t json_push_parser_fail_at(json_push_parser_t* parser, const json_parser_result_t result, const size_t base_position) {
+    if (result.code == JSON_PARSE_HANDLER_ERROR) {
+        return json_push_parser_fail(parser, result);
+    }
+
+    return json_push_parser_fail(parser, (json_parser_result_t) {
+        .code = result.code,
+        .context = result.context,
+        .error = result.error,
+        .extra = result.extra,
+        .position = base_position + result.position,
+    });
+}
+
+/**
+ * Fail with the result of a handler. Codes which are not parser results, like a skip result
+ * from a handler which does not support it, are reported at the given position, like json_parse() does.
+ */
+static json_parser_result_t json_push_parser_fail_handler(json_push_parser_t* parser, const json_parser_result_t result, const size_t position) {
+    if (result.code < 0 || result.code > JSON_PARSE_CONFIG_ERROR) {
+        return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_INVALID_CODE, result.code, position });
+    }
+
+    return json_push_parser_fail(parser, result);
+}
+
+json_parser_result_t json_push_parser_init(json_push_parser_t* parser, json_parser_handler_t* handler, json_parser_options_t options, const size_t stack_size, json_parser_frame_t stack[stack_size], const size_t buffer_size, char buffer[buffer_size]) {
+    if (parser == nullptr || handler == nullptr || buffer == nullptr || (stack == nullptr && stack_size > 0)) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    options = json_default_parser_options(options);
+
+    const json_parser_result_t options_result = json_parser_check_options(options);
+
+    if (options_result.code != JSON_PARSE_SUCCESS) {
+        return options_result;
+    }
+
+    if (buffer_size < JSON_PUSH_PARSER_BUFFER_SIZE(options.max_string_size)) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_INVALID_MAX_STRING_SIZE, 0, 0 };
+    }
+
+    parser->handler = handler;
+    parser->options = options;
+    parser->stack_size = stack_size;
+    parser->stack_used = 0;
+    parser->stack = stack;
+    parser->buffer = buffer;
+    parser->buffer_size = buffer_size;
+    parser->buffer_used = 0;
+    parser->token_position = 0;
+    parser->token_escaped = false;
+    parser->token_unchecked = false;
+    parser->position = 0;
+    parser->phase = JSON_PUSH_PARSER_VALUE;
+    parser->skip_value = false;
+    parser->skip_context = JSON_CONTEXT_UNKNOWN;
+    parser->skip_depth = 0;
+    parser->skip_odd_backslash = 0;
+    parser->skip_in_string = 0;
+    parser->structure_whitespace = false;
+
+    const json_parser_result_t success = json_create_success_result();
+    memcpy(&parser->error, &success, sizeof(success));
+
+    return success;
+}
+
+typedef enum: uint8_t {
+    JSON_PUSH_TOKEN_INCOMPLETE,
+    JSON_PUSH_TOKEN_COMPLETE,
+
+    /**
+     * The token is a number which ended before the end of the buffered input.
+     * The remaining characters (like "-" in "1-2") cannot follow a value.
+     */
+    JSON_PUSH_TOKEN_TRAILING_CHARACTERS,
+} json_push_token_status_t;
+
+static inline bool json_push_is_number_char(const char c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+/**
+ * Find the end of the token starting with first_char, continued by data.
+ * The first `token_length` bytes of the token are already in the buffer.
+ *
+ * Return false if the token needs more input. Otherwise, window is set to the number of bytes of data to add to the token before parsing it.
+ * For numbers, the character following the number is included, so the number parser can validate it.
+ * For strings, closed is set if the window ends with the closing quote, so the string does not need to be scanned again.
+ */
+static bool json_push_parser_token_window(json_push_parser_t* parser, const char first_char, const bool is_property_key, const size_t token_length, const char* data, const size_t length, const bool final, size_t* window, bool* closed) {
+    // At the end of the input, the token parser reports the error if the token is not complete
+    *window = length;
+    *closed = false;
+
+    if (is_property_key && first_char != '"') {
+        // Let the string parser report the error, with enough input to not report an unexpected end
+        if (token_length + length >= 2) {
+            *window = 2 - token_length;
+            return true;
+        }
+
+        return final;
+    }
+
+    switch (first_char) {
+        case '"': {
+            // The closing quote must be found before max_string_size, like json_parse()
+            const size_t max_string_size = parser->options.max_string_size;
+            const size_t scan_length = max_string_size - token_length < length ? max_string_size - token_length : length;
+            size_t position = token_length == 0 ? 1 : 0;
+
+            if (parser->token_escaped && position < scan_length) {
+                parser->token_escaped = false;
+                parser->token_unchecked |= (unsigned char) data[position] >= 0x80;
+                ++position;
+            }
+
+            while (position < scan_length) {
+                position = json_scan_string_utf8(data, position, scan_length);
+
+                if (position >= scan_length) {
+                    break;
+                }
+
+                if (data[position] == '"') {
+                    *window = position + 1;
+                    *closed = !parser->token_unchecked;
+                    return true;
+                }
+
+                if (data[position] == '\\') {
+                    if (position + 1 >= scan_length) {
+                        parser->token_escaped = true;
+                        break;
+                    }
+
+                    // A UTF-8 sequence following the backslash is checked by the string parser, like the other ones
+                    parser->token_unchecked |= (unsigned char) data[position + 1] >= 0x80;
+                    position += 2;
+                    continue;
+                }
+
+                // Control character, or invalid UTF-8 sequence which may be cut by the chunk end:
+                // checked by the string parser, once the whole string is known
+                parser->token_unchecked = true;
+                ++position;
+            }
+
+            // Too long: give one more byte than allowed to the string parser, to report the error
+            if (token_length + length > max_string_size) {
+                *window = max_string_size + 1 - token_length;
+                return true;
+            }
+
+            return final;
+        }
+
+        case 'n':
+        case 't':
+        case 'f': {
+            const size_t literal_length = first_char == 'f' ? 5 : 4;
+
+            if (token_length + length >= literal_length) {
+                *window = literal_length - token_length;
+                return true;
+            }
+
+            return final;
+        }
+
+        default:
+            if (first_char != '-' && (first_char < '0' || first_char > '9')) {
+                // Not a valid token: let the parser functions report the error on the first character
+                *window = 1;
+                return true;
+            }
+
+            for (size_t position = 0; position < length; ++position) {
+                if (!json_push_is_number_char(data[position])) {
+                    *window = position + 1;
+                    return true;
+                }
+            }
+
+            return final;
+    }
+}
+
+static json_parser_result_t json_push_parser_parse_token(json_stream_parser_state_t* state, const char first_char, const size_t depth, const bool is_property_key) {
+    if (is_property_key) {
+        return json_parse_string_internal(state, depth, true);
+    }
+
+    switch (first_char) {
+        case '"':
+            return json_parse_string_internal(state, depth, false);
+
+        case 'n':
+            return json_parse_null(state, depth);
+
+        case 't':
+            return json_parse_boolean(state, true, depth);
+
+        case 'f':
+            return json_parse_boolean(state, false, depth);
+
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            return json_parse_number(state, depth);
+
+        default:
+            return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNEXPECTED_CHARACTER, 0, state->position };
+    }
+}
+
+/**
+ * Parse the token starting at position in the chunk, or continue the token kept in the buffer.
+ * If the token is not complete, it is kept in the buffer, and the position is moved to the end of the chunk.
+ * Otherwise, the handler is called and the position is moved after the token.
+ * With trailing characters, the token position is moved to the first of these characters.
+ */
+static json_parser_result_t json_push_parser_token(json_push_parser_t* parser, const char* chunk, const size_t length, size_t* position, const size_t depth, const bool is_property_key, const bool final, json_push_token_status_t* status) {
+    const bool continued = parser->buffer_used > 0;
+    const char first_char = continued ? parser->buffer[0] : chunk[*position];
+    size_t window;
+    bool closed_string;
+    const bool token_complete = json_push_parser_token_window(parser, first_char, is_property_key, parser->buffer_used, chunk + *position, length - *position, final, &window, &closed_string);
+
+    if (!continued) {
+        parser->token_position = parser->position + *position;
+    }
+
+    if (continued || !token_complete) {
+        if (parser->buffer_used + window > parser->buffer_size) {
+            // Only numbers can be longer than the buffer, as it can hold the longest string allowed
+            return json_push_parser_fail(parser, (json_parser_result_t) {
+                JSON_PARSE_ERROR_MAX_STRING_SIZE,
+                first_char == '"' ? JSON_CONTEXT_STRING : JSON_CONTEXT_NUMBER,
+                JSON_ERROR_UNKNOWN,
+                0,
+                parser->token_position + parser->buffer_size,
+            });
+        }
+
+        memcpy(parser->buffer + parser->buffer_used, chunk + *position, window);
+        parser->buffer_used += window;
+    }
+
+    if (!token_complete) {
+        *position = length;
+        *status = JSON_PUSH_TOKEN_INCOMPLETE;
+
+        return json_create_success_result();
+    }
+
+    const char* token = continued ? parser->buffer : chunk + *position;
+    const size_t token_length = continued ? parser->buffer_used : window;
+    const size_t token_position = parser->token_position;
+    const size_t previous_length = continued ? parser->buffer_used - window : 0;
+
+    json_stream_parser_state_t state = {
+        .json = token,
+        .length = token_length,
+        .handler = parser->handler,
+        .max_depth = parser->options.max_depth,
+        .max_string_size = parser->options.max_string_size,
+        .max_struct_size = parser->options.max_struct_size,
+        .position = 0,
+    };
+
+    // The closing quote has already been found: the string does not need to be scanned again
+    if (closed_string && depth <= state.max_depth) {
+        state.position = token_length;
+    }
+
+    const json_parser_result_t result = state.position > 0
+        ? json_parser_emit_string(&state, 0, is_property_key)
+        : json_push_parser_parse_token(&state, first_char, depth, is_property_key)
+    ;
+
+    parser->buffer_used = 0;
+    parser->token_escaped = false;
+    parser->token_unchecked = false;
+
+    // Only the property handler can ask to skip the following value
+    if (result.code != JSON_PARSE_SUCCESS && !(is_property_key && result.code == JSON_PARSE_SKIP)) {
+        if (result.code > JSON_PARSE_CONFIG_ERROR) {
+            return json_push_parser_fail_handler(parser, result, token_position + state.position);
+        }
+
+        return json_push_parser_fail_at(parser, result, token_position);
+    }
+
+    if (state.position < previous_length) {
+        parser->token_position += state.position;
+        *status = JSON_PUSH_TOKEN_TRAILING_CHARACTERS;
+
+        return result;
+    }
+
+    // The number parser does not consume the character following the number
+    *position += state.position - previous_length;
+    *status = JSON_PUSH_TOKEN_COMPLETE;
+
+    return result;
+}
+
+/**
+ * Count a new element or separator in the current structure, like the iterative engine.
+ */
+static json_parser_result_t json_push_parser_enter_structure(json_push_parser_t* parser, const size_t position) {
+    json_parser_frame_t* frame = &parser->stack[parser->stack_used - 1];
+
+    if (frame->length > parser->options.max_struct_size) {
+        return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_ERROR_MAX_STRUCT_SIZE, frame->type, JSON_ERROR_UNKNOWN, 0, parser->position + position });
+    }
+
+    ++frame->length;
+    parser->phase = JSON_PUSH_PARSER_STRUCTURE;
+    parser->structure_whitespace = false;
+
+    return json_create_success_result();
+}
+
+static json_parser_result_t json_push_parser_value_parsed(json_push_parser_t* parser, const size_t position) {
+    if (parser->stack_used == 0) {
+        parser->phase = JSON_PUSH_PARSER_DONE;
+        return json_create_success_result();
+    }
+
+    return json_push_parser_enter_structure(parser, position);
+}
+
+/**
+ * Start skipping the value at position, after a skip result of a handler.
+ * The opening bracket or quote of the value is consumed.
+ */
+static void json_push_parser_start_skip(json_push_parser_t* parser, const json_parse_context_t context) {
+    parser->phase = JSON_PUSH_PARSER_SKIP;
+    parser->skip_value = false;
+    parser->skip_context = context;
+    parser->skip_depth = 1;
+    parser->skip_odd_backslash = 0;
+    parser->skip_in_string = 0;
+    parser->token_escaped = false;
+}
+
+/**
+ * Continue skipping the current value over the chunk, without checking it nor calling any handler.
+ * Structures are skipped by matching brackets, strings by searching the closing quote, and other scalars up to the next separator.
+ * If the value is not complete, the position is moved to the end of the chunk, and the parser stays in the skip phase.
+ */
+static json_parser_result_t json_push_parser_skip(json_push_parser_t* parser, const char* chunk, const size_t length, size_t* position, const bool final) {
+    switch (parser->skip_context) {
+        case JSON_CONTEXT_ARRAY:
+        case JSON_CONTEXT_OBJECT: {
+            json_structural_skip_t skip = {
+                .depth = parser->skip_depth,
+                .previous_odd_backslash = parser->skip_odd_backslash,
+                .previous_in_string = parser->skip_in_string,
+            };
+
+            *position = json_structural_index_skip(&skip, length, chunk, *position);
+            parser->skip_depth = skip.depth;
+            parser->skip_odd_backslash = skip.previous_odd_backslash;
+            parser->skip_in_string = skip.previous_in_string;
+
+            if (skip.depth == 0) {
+                break;
+            }
+
+            if (final) {
+                const char closing_char = parser->skip_context == JSON_CONTEXT_OBJECT ? '}' : ']';
+                return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, parser->skip_context, JSON_ERROR_MISSING_CLOSING_CHARACTER, closing_char, parser->position + length });
+            }
+
+            return json_create_success_result();
+        }
+
+        case JSON_CONTEXT_STRING:
+            while (*position < length) {
+                if (parser->token_escaped) {
+                    parser->token_escaped = false;
+                    ++*position;
+                    continue;
+                }
+
+                *position = json_scan_string_special(chunk, *position, length);
+
+                if (*position >= length) {
+                    break;
+                }
+
+                const char current_char = chunk[(*position)++];
+
+                if (current_char == '"') {
+                    return json_push_parser_value_parsed(parser, *position);
+                }
+
+                parser->token_escaped = current_char == '\\';
+            }
+
+            if (final) {
+                return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_STRING, JSON_ERROR_MISSING_CLOSING_CHARACTER, '"', parser->position + length });
+            }
+
+            return json_create_success_result();
+
+        default:
+            while (*position < length) {
+                const char current_char = chunk[*position];
+
+                if (current_char == ',' || current_char == ']' || current_char == '}' || json_is_whitespace(current_char)) {
+                    break;
+                }
+
+                ++*position;
+            }
+
+            if (*position >= length && !final) {
+                return json_create_success_result();
+            }
+
+            break;
+    }
+
+    return json_push_parser_value_parsed(parser, *position);
+}
+
+static json_parser_result_t json_push_parser_run(json_push_parser_t* parser, const char* chunk, const size_t length, const bool final) {
+    size_t position = 0;
+
+    for (;;) {
+        switch (parser->phase) {
+            case JSON_PUSH_PARSER_FAILED:
+                return parser->error;
+
+            case JSON_PUSH_PARSER_DONE:
+                return json_create_success_result();
+
+            case JSON_PUSH_PARSER_VALUE: {
+                const size_t depth = 2 * parser->stack_used;
+
+                if (depth > parser->options.max_depth) {
+                    return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNKNOWN, 0, parser->position + position });
+                }
+
+                if (parser->buffer_used == 0) {
+                    position = json_scan_whitespace(chunk, position, length);
+
+                    if (position >= length) {
+                        if (final) {
+                            return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_UNKNOWN, JSON_ERROR_EMPTY_VALUE, 0, parser->position + position });
+                        }
+
+                        return json_create_success_result();
+                    }
+
+                    const char current_char = chunk[position];
+
+                    if (parser->skip_value) {
+                        switch (current_char) {
+                            case ',':
+                            case ']':
+                            case '}':
+                            case ':':
+                                return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNEXPECTED_CHARACTER, 0, parser->position + position });
+
+                            case '[':
+                                ++position;
+                                json_push_parser_start_skip(parser, JSON_CONTEXT_ARRAY);
+                                continue;
+
+                            case '{':
+                                ++position;
+                                json_push_parser_start_skip(parser, JSON_CONTEXT_OBJECT);
+                                continue;
+
+                            case '"':
+                                ++position;
+                                json_push_parser_start_skip(parser, JSON_CONTEXT_STRING);
+                                continue;
+
+                            default:
+                                json_push_parser_start_skip(parser, JSON_CONTEXT_UNKNOWN);
+                                continue;
+                        }
+                    }
+
+                    if (current_char == '[' || current_char == '{') {
+                        const json_parse_context_t context = current_char == '{' ? JSON_CONTEXT_OBJECT : JSON_CONTEXT_ARRAY;
+
+                        if (depth + 1 > parser->options.max_depth) {
+                            return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, context, JSON_ERROR_UNKNOWN, 0, parser->position + position });
+                        }
+
+                        if (parser->stack_used >= parser->stack_size) {
+                            return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, context, JSON_ERROR_STACK_OVERFLOW, 0, parser->position + position });
+                        }
+
+                        ++position;
+
+                        json_parser_result_t (*start_handler)(json_parser_handler_t*) = context == JSON_CONTEXT_OBJECT
+                            ? parser->handler->on_object_start
+                            : parser->handler->on_array_start
+                        ;
+
+                        if (start_handler != nullptr) {
+                            const json_parser_result_t start_result = start_handler(parser->handler);
+
+                            if (start_result.code == JSON_PARSE_SKIP) {
+                                json_push_parser_start_skip(parser, context);
+                                continue;
+                            }
+
+                            if (start_result.code != JSON_PARSE_SUCCESS) {
+                                return json_push_parser_fail_handler(parser, start_result, parser->position + position);
+                            }
+                        }
+
+                        parser->stack[parser->stack_used++] = (json_parser_frame_t) {
+                            .length = 0,
+                            .type = context,
+                            .expected = true,
+                        };
+
+                        const json_parser_result_t enter_result = json_push_parser_enter_structure(parser, position);
+
+                        if (enter_result.code != JSON_PARSE_SUCCESS) {
+                            return enter_result;
+                        }
+
+                        continue;
+                    }
+                }
+
+                json_push_token_status_t status;
+                const json_parser_result_t result = json_push_parser_token(parser, chunk, length, &position, depth + 1, false, final, &status);
+
+                if (result.code != JSON_PARSE_SUCCESS || status == JSON_PUSH_TOKEN_INCOMPLETE) {
+                    return result;
+                }
+
+                const json_parser_result_t parsed_result = json_push_parser_value_parsed(parser, position);
+
+                if (parsed_result.code != JSON_PARSE_SUCCESS) {
+                    return parsed_result;
+                }
+
+                // The trailing characters are neither a separator nor a closing bracket, and are ignored after the root value
+                if (status == JSON_PUSH_TOKEN_TRAILING_CHARACTERS && parser->phase != JSON_PUSH_PARSER_DONE) {
+                    const json_parse_context_t context = parser->stack[parser->stack_used - 1].type;
+                    return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, context, JSON_ERROR_UNEXPECTED_CHARACTER, ',', parser->token_position });
+                }
+
+                continue;
+            }
+
+            case JSON_PUSH_PARSER_STRUCTURE: {
+                json_parser_frame_t* frame = &parser->stack[parser->stack_used - 1];
+                const bool is_object = frame->type == JSON_CONTEXT_OBJECT;
+
+                if (parser->buffer_used == 0) {
+                    const char closing_char = is_object ? '}' : ']';
+                    const size_t token_position = position;
+                    position = json_scan_whitespace(chunk, position, length);
+                    parser->structure_whitespace = parser->structure_whitespace || position > token_position;
+
+                    if (position >= length) {
+                        if (!final) {
+                            return json_create_success_result();
+                        }
+
+                        // The input ends right after the opening bracket
+                        if (!parser->structure_whitespace && frame->length == 1) {
+                            return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, frame->type, JSON_ERROR_TOO_SMALL, 0, parser->position + position - 1 });
+                        }
+
+                        if (!parser->structure_whitespace) {
+                            return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, frame->type, JSON_ERROR_MISSING_CLOSING_CHARACTER, closing_char, parser->position + position });
+                        }
+
+                        return json_push_parser_fail(parser, is_object
+                            ? (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_EMPTY_VALUE, 0, parser->position + position }
+                            : (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_ARRAY, JSON_ERROR_MISSING_CLOSING_CHARACTER, ']', parser->position + position }
+                        );
+                    }
+
+                    const char current_char = chunk[position];
+
+                    if (current_char == closing_char) {
+                        ++position;
+                        --parser->stack_used;
+
+                        json_parser_result_t (*end_handler)(json_parser_handler_t*) = is_object
+                            ? parser->handler->on_object_end
+                            : parser->handler->on_array_end
+                        ;
+
+                        if (end_handler != nullptr) {
+                            const json_parser_result_t end_result = end_handler(parser->handler);
+
+                            if (end_result.code != JSON_PARSE_SUCCESS) {
+                                return json_push_parser_fail_handler(parser, end_result, parser->position + position);
+                            }
+                        }
+
+                        const json_parser_result_t parsed_result = json_push_parser_value_parsed(parser, position);
+
+                        if (parsed_result.code != JSON_PARSE_SUCCESS) {
+                            return parsed_result;
+                        }
+
+                        continue;
+                    }
+
+                    if (current_char == ',') {
+                        if (frame->expected) {
+                            return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, frame->type, JSON_ERROR_UNEXPECTED_CHARACTER, is_object ? '"' : 0, parser->position + position });
+                        }
+
+                        frame->expected = true;
+                        ++position;
+
+                        const json_parser_result_t enter_result = json_push_parser_enter_structure(parser, position);
+
+                        if (enter_result.code != JSON_PARSE_SUCCESS) {
+                            return enter_result;
+                        }
+
+                        continue;
+                    }
+
+                    if (!frame->expected) {
+                        return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, frame->type, JSON_ERROR_UNEXPECTED_CHARACTER, ',', parser->position + position });
+                    }
+
+                    if (!is_object) {
+                        frame->expected = false;
+                        parser->phase = JSON_PUSH_PARSER_VALUE;
+                        continue;
+                    }
+                }
+
+                // Only property keys are parsed in this phase
+                json_push_token_status_t status;
+                const json_parser_result_t result = json_push_parser_token(parser, chunk, length, &position, 2 * parser->stack_used, true, final, &status);
+                const bool skip_value = result.code == JSON_PARSE_SKIP;
+
+                if ((result.code != JSON_PARSE_SUCCESS && !skip_value) || status == JSON_PUSH_TOKEN_INCOMPLETE) {
+                    return result;
+                }
+
+                frame->expected = false;
+                parser->skip_value = skip_value;
+                parser->phase = JSON_PUSH_PARSER_COLON;
+                continue;
+            }
+
+            case JSON_PUSH_PARSER_COLON:
+                position = json_scan_whitespace(chunk, position, length);
+
+                if (position >= length) {
+                    if (final) {
+                        return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_MISSING_CLOSING_CHARACTER, ':', parser->position + position });
+                    }
+
+                    return json_create_success_result();
+                }
+
+                if (chunk[position] != ':') {
+                    return json_push_parser_fail(parser, (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_OBJECT, JSON_ERROR_UNEXPECTED_CHARACTER, ':', parser->position + position });
+                }
+
+                ++position;
+                parser->phase = JSON_PUSH_PARSER_VALUE;
+                continue;
+
+            case JSON_PUSH_PARSER_SKIP: {
+                const json_parser_result_t skip_result = json_push_parser_skip(parser, chunk, length, &position, final);
+
+                if (skip_result.code != JSON_PARSE_SUCCESS || parser->phase == JSON_PUSH_PARSER_SKIP) {
+                    return skip_result;
+                }
+
+                continue;
+            }
+        }
+    }
+}
+
+json_parser_result_t json_parser_feed(json_push_parser_t* parser, const size_t length, const char chunk[length]) {
+    if (parser == nullptr || (chunk == nullptr && length > 0)) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    const json_parser_result_t result = json_push_parser_run(parser, chunk, length, false);
+    parser->position += length;
+
+    return result;
+}
+
+json_parser_result_t json_parser_finish(json_push_parser_t* parser) {
+    if (parser == nullptr) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    return json_push_parser_run(parser, "", 0, true);
+}
@@ -0,0 +1,155 @@
+#ifndef JSON_PUSH_PARSER_H
+#define JSON_PUSH_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "parser.h"
+
+/**
+ * Number of bytes needed by the push parser buffer to hold any string allowed by the max string size option.
+ * Numbers and literals are also kept in this buffer when they are split between two chunks.
+ */
+#define JSON_PUSH_PARSER_BUFFER_SIZE(max_string_size) ((max_string_size) + 1)
+
+typedef enum: uint8_t {
+    /**
+     * A value is expected: at the start of the document, after an opening bracket, a comma, or a colon
+     */
+    JSON_PUSH_PARSER_VALUE,
+
+    /**
+     * Inside an array or object, waiting for an element, a property, a separator or the closing bracket
+     */
+    JSON_PUSH_PARSER_STRUCTURE,
+
+    /**
+     * A property key has been parsed, waiting for the colon
+     */
+    JSON_PUSH_PARSER_COLON,
+
+    /**
+     * A handler returned a skip result: the value is skipped without parsing it
+     */
+    JSON_PUSH_PARSER_SKIP,
+
+    /**
+     * The root value is complete, the remaining input is ignored
+     */
+    JSON_PUSH_PARSER_DONE,
+
+    /**
+     * An error occurred, the parser cannot continue
+     */
+    JSON_PUSH_PARSER_FAILED,
+} json_push_parser_phase_t;
+
+/**
+ * Resumable parser, fed with chunks of the JSON input as they are received.
+ * Initialize it with `json_push_parser_init()`. The fields are internal to the parser.
+ *
+ * When the whole input is already in memory, `json_parse()` is faster: compare them with the `push_parser` benchmark.
+ */
+typedef struct {
+    json_parser_handler_t* handler;
+    json_parser_options_t options;
+
+    size_t stack_size;
+    size_t stack_used;
+    json_parser_frame_t* stack;
+
+    /**
+     * Buffer used to keep a token (string, number or literal) split between two chunks
+     */
+    char* buffer;
+    size_t buffer_size;
+    size_t buffer_used;
+
+    /**
+     * Position in the whole input of the token kept in the buffer
+     */
+    size_t token_position;
+
+    /**
+     * The last byte of the buffer is a backslash escaping the next character of a string
+     */
+    bool token_escaped;
+
+    /**
+     * The string in the buffer contains control characters or non-ASCII bytes, so it must be scanned again by the string parser to check them
+     */
+    bool token_unchecked;
+
+    /**
+     * Position in the whole input of the start of the next chunk
+     */
+    size_t position;
+
+    json_push_parser_phase_t phase;
+
+    /**
+     * The property handler returned a skip result: the value following the colon must be skipped
+     */
+    bool skip_value;
+
+    /**
+     * The kind of the value being skipped: JSON_CONTEXT_ARRAY, JSON_CONTEXT_OBJECT, JSON_CONTEXT_STRING,
+     * or JSON_CONTEXT_UNKNOWN for numbers and literals
+     */
+    json_parse_context_t skip_context;
+
+    /**
+     * State of the bracket matching, when skipping a structure
+     */
+    size_t skip_depth;
+    uint64_t skip_odd_backslash;
+    uint64_t skip_in_string;
+
+    /**
+     * Whitespaces have been skipped since the last token of the current structure.
+     * Only used to report the same errors as json_parse() on truncated input.
+     */
+    bool structure_whitespace;
+
+    /**
+     * The error returned by all calls after a failure
+     */
+    json_parser_result_t error;
+} json_push_parser_t;
+
+/**
+ * Initialize the push parser.
+ *
+ * The handler receives the same events as with `json_parse()`, as soon as the tokens are complete.
+ * So, on malformed or truncated input, events may already have been sent for the beginning of the document.
+ * Strings are passed from the chunk when possible, or from the parser buffer if they were split between two chunks.
+ * In both cases, they are only valid during the callback.
+ *
+ * @param stack_size The number of frames in the stack, i.e. the maximum number of nested arrays or objects. See `JSON_PARSER_STACK_SIZE()`.
+ * @param stack The stack used to track nested structures. It must live as long as the parser.
+ * @param buffer_size The size of the buffer. Must be at least `JSON_PUSH_PARSER_BUFFER_SIZE(options.max_string_size)`, after applying defaults.
+ * @param buffer The buffer used to keep tokens split between chunks. It must live as long as the parser.
+ */
+json_parser_result_t json_push_parser_init(json_push_parser_t* parser, json_parser_handler_t* handler, json_parser_options_t options, size_t stack_size, json_parser_frame_t stack[stack_size], size_t buffer_size, char buffer[buffer_size]);
+
+/**
+ * Parse the next chunk of the input.
+ * The chunk can be released once this function returns.
+ *
+ * Once the root value is complete, the remaining input is ignored, like with `json_parse()`.
+ * After an error, the same error is returned by all subsequent calls. Error positions are relative to the whole input.
+ *
+ * @param length The length of the chunk. May be zero.
+ * @param chunk The next bytes of the input.
+ */
+json_parser_result_t json_parser_feed(json_push_parser_t* parser, size_t length, const char chunk[length]);
+
+/**
+ * Signal the end of the input.
+ * A number ending the input is only emitted at this step, because it may be continued by the next chunk.
+ *
+ * Return `JSON_PARSE_ERROR_UNEXPECTED_END` if the document is not complete.
+ */
+json_parser_result_t json_parser_finish(json_push_parser_t* parser);
+
+#endif //JSON_PUSH_PARSER_H
@@ -0,0 +1,372 @@
+#include "query.h"
+
+#include <string.h>
+
+#include "parser_internal.h"
+
+/**
+ * The runner follows the open structures which may contain a value designated by a path, and keeps for each one
+ * the query nodes designating it. With wildcards, a value can be designated by several nodes, but they all have
+ * the same depth in the trie: so the nodes of all the open structures fit in `query->node_count` entries.
+ *
+ * The value following a property key, or the next element of an array, is designated by the matching children
+ * of these nodes. When there is none, the value is skipped with a skip result of the handler.
+ */
+
+static json_parser_result_t json_query_invalid_path(const size_t path_id) {
+    return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_INVALID_POINTER, 0, path_id };
+}
+
+static inline bool json_query_is_wildcard(const json_query_node_t* node) {
+    return node->token_length == 1 && node->token[0] == '*';
+}
+
+size_t json_query_node_count(const size_t path_count, const char* const paths[path_count]) {
+    size_t count = 1;
+
+    for (size_t i = 0; i < path_count; ++i) {
+        for (const char* c = paths[i]; *c != '\0'; ++c) {
+            count += *c == '/';
+        }
+    }
+
+    return count;
+}
+
+json_parser_result_t json_query_compile(json_query_t* query, const size_t path_count, const char* const paths[path_count], const size_t node_capacity, json_query_node_t nodes[node_capacity]) {
+    if (query == nullptr || (paths == nullptr && path_count > 0) || nodes == nullptr || node_capacity == 0) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    nodes[0] = (json_query_node_t) {
+        .token = "",
+        .token_length = 0,
+        .escaped = false,
+        .array_index = JSON_QUERY_NONE,
+        .first_child = JSON_QUERY_NONE,
+        .next_sibling = JSON_QUERY_NONE,
+        .path_id = JSON_QUERY_NONE,
+    };
+
+    size_t node_count = 1;
+    size_t depth = 0;
+
+    for (size_t path_id = 0; path_id < path_count; ++path_id) {
+        const char* path = paths[path_id];
+
+        if (path == nullptr) {
+            return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, path_id };
+        }
+
+        if (json_pointer_check(path).code != JSON_PARSE_SUCCESS) {
+            return json_query_invalid_path(path_id);
+        }
+
+        uint32_t node = 0;
+        size_t path_depth = 0;
+
+        for (const char* token = path; *token == '/'; token += strcspn(token, "/")) {
+            ++token;
+            ++path_depth;
+
+            const size_t token_length = strcspn(token, "/");
+            uint32_t child = nodes[node].first_child;
+
+            // The tokens are compared as written: the "~" and "/" characters can only be written one way
+            while (child != JSON_QUERY_NONE && (nodes[child].token_length != token_length || memcmp(nodes[child].token, token, token_length) != 0)) {
+                child = nodes[child].next_sibling;
+            }
+
+            if (child == JSON_QUERY_NONE) {
+                if (node_count >= node_capacity) {
+                    return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_OUT_OF_MEMORY, 0, path_id };
+                }
+
+                size_t array_index;
+
+                child = (uint32_t) node_count++;
+                nodes[child] = (json_query_node_t) {
+                    .token = token,
+                    .token_length = (uint32_t) token_length,
+                    .escaped = strcspn(token, "~\\/") < token_length,
+                    .array_index = json_pointer_array_index(token, token_length, &array_index) && array_index < JSON_QUERY_NONE
+                        ? (uint32_t) array_index
+                        : JSON_QUERY_NONE,
+                    .first_child = JSON_QUERY_NONE,
+                    .next_sibling = nodes[node].first_child,
+                    .path_id = JSON_QUERY_NONE,
+                };
+                nodes[node].first_child = child;
+            }
+
+            node = child;
+        }
+
+        if (nodes[node].path_id != JSON_QUERY_NONE) {
+            return json_query_invalid_path(path_id);
+        }
+
+        nodes[node].path_id = (uint32_t) path_id;
+        depth = path_depth > depth ? path_depth : depth;
+    }
+
+    query->node_count = node_count;
+    query->nodes = nodes;
+    query->depth = depth;
+
+    return json_create_success_result();
+}
+
+/**
+ * Add the node to the set designating the next value
+ */
+static inline void json_query_add_pending(json_query_runner_t* runner, const uint32_t node) {
+    runner->active[runner->pending_end++] = node;
+}
+
+/**
+ * When the current value is an element of an array, compute the nodes designating it
+ */
+static void json_query_begin_value(json_query_runner_t* runner) {
+    if (runner->frame_used == 0 || !runner->frames[runner->frame_used - 1].is_array) {
+        // The nodes have been set by json_query_runner_reset() or the property handler
+        return;
+    }
+
+    json_query_frame_t* frame = &runner->frames[runner->frame_used - 1];
+    const json_query_node_t* nodes = runner->query->nodes;
+    const uint32_t index = frame->index++;
+
+    runner->pending_start = frame->active_end;
+    runner->pending_end = frame->active_end;
+
+    for (uint32_t i = frame->active_start; i < frame->active_end; ++i) {
+        for (uint32_t child = nodes[runner->active[i]].first_child; child != JSON_QUERY_NONE; child = nodes[child].next_sibling) {
+            if (nodes[child].array_index == index || json_query_is_wildcard(&nodes[child])) {
+                json_query_add_pending(runner, child);
+            }
+        }
+    }
+}
+
+/**
+ * Report the value to the match handler, for each path ending at a node designating it
+ */
+static json_parser_result_t json_query_match(json_query_runner_t* runner, const json_token_t* value) {
+    const json_query_node_t* nodes = runner->query->nodes;
+
+    for (uint32_t i = runner->pending_start; i < runner->pending_end; ++i) {
+        const uint32_t path_id = nodes[runner->active[i]].path_id;
+
+        if (path_id == JSON_QUERY_NONE) {
+            continue;
+        }
+
+        const json_parser_result_t result = runner->match_handler->on_match(runner->match_handler, path_id, value);
+
+        if (result.code != JSON_PARSE_SUCCESS) {
+            return result;
+        }
+    }
+
+    return json_create_success_result();
+}
+
+static json_parser_result_t json_query_on_scalar(json_parser_handler_t* self, const json_token_t* value) {
+    json_query_runner_t* runner = (json_query_runner_t*) self;
+
+    json_query_begin_value(runner);
+
+    return json_query_match(runner, value);
+}
+
+static json_parser_result_t json_query_on_null(json_parser_handler_t* self) {
+    return json_query_on_scalar(self, &(json_token_t) { .kind = JSON_TOKEN_NULL, .raw = { 0, nullptr } });
+}
+
+static json_parser_result_t json_query_on_bool(json_parser_handler_t* self, const bool value) {
+    return json_query_on_scalar(self, &(json_token_t) { .kind = JSON_TOKEN_BOOL, .raw = { 0, nullptr }, .bool_value = value });
+}
+
+static json_parser_result_t json_query_on_number(json_parser_handler_t* self, const double value) {
+    return json_query_on_scalar(self, &(json_token_t) { .kind = JSON_TOKEN_NUMBER, .raw = { 0, nullptr }, .number_value = value });
+}
+
+static json_parser_result_t json_query_on_integer(json_parser_handler_t* self, const int64_t value) {
+    return json_query_on_scalar(self, &(json_token_t) { .kind = JSON_TOKEN_INTEGER, .raw = { 0, nullptr }, .integer_value = value });
+}
+
+static json_parser_result_t json_query_on_string(json_parser_handler_t* self, const json_raw_string_t value) {
+    return json_query_on_scalar(self, &(json_token_t) { .kind = JSON_TOKEN_STRING, .raw = value });
+}
+
+/**
+ * Check if the node has a child which can designate an element of an array, or a property of an object
+ */
+static bool json_query_has_children(const json_query_node_t* nodes, const uint32_t node, const bool is_array) {
+    if (!is_array) {
+        return nodes[node].first_child != JSON_QUERY_NONE;
+    }
+
+    for (uint32_t child = nodes[node].first_child; child != JSON_QUERY_NONE; child = nodes[child].next_sibling) {
+        if (nodes[child].array_index != JSON_QUERY_NONE || json_query_is_wildcard(&nodes[child])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static json_parser_result_t json_query_on_structure_start(json_parser_handler_t* self, const bool is_array) {
+    json_query_runner_t* runner = (json_query_runner_t*) self;
+    const json_query_node_t* nodes = runner->query->nodes;
+
+    json_query_begin_value(runner);
+
+    const json_parser_result_t match_result = json_query_match(runner, &(json_token_t) {
+        .kind = is_array ? JSON_TOKEN_ARRAY_START : JSON_TOKEN_OBJECT_START,
+        .raw = { 0, nullptr },
+    });
+
+    if (match_result.code != JSON_PARSE_SUCCESS) {
+        return match_result;
+    }
+
+    // Only keep the nodes which can designate a value inside the structure
+    uint32_t active_end = runner->pending_start;
+
+    for (uint32_t i = runner->pending_start; i < runner->pending_end; ++i) {
+        if (json_query_has_children(nodes, runner->active[i], is_array)) {
+            runner->active[active_end++] = runner->active[i];
+        }
+    }
+
+    if (active_end == runner->pending_start) {
+        runner->pending_end = runner->pending_start;
+        return json_create_skip_result();
+    }
+
+    if (runner->frame_used >= runner->frame_count) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, is_array ? JSON_CONTEXT_ARRAY : JSON_CONTEXT_OBJECT, JSON_ERROR_STACK_OVERFLOW, 0, 0 };
+    }
+
+    runner->frames[runner->frame_used++] = (json_query_frame_t) {
+        .active_start = runner->pending_start,
+        .active_end = active_end,
+        .index = 0,
+        .is_array = is_array,
+    };
+    runner->pending_start = active_end;
+    runner->pending_end = active_end;
+
+    return json_create_success_result();
+}
+
+static json_parser_result_t json_query_on_array_start(json_parser_handler_t* self) {
+    return json_query_on_structure_start(self, true);
+}
+
+static json_parser_result_t json_query_on_object_start(json_parser_handler_t* self) {
+    return json_query_on_structure_start(self, false);
+}
+
+static json_parser_result_t json_query_on_structure_end(json_parser_handler_t* self) {
+    json_query_runner_t* runner = (json_query_runner_t*) self;
+    const json_query_frame_t* frame = &runner->frames[--runner->frame_used];
+
+    runner->pending_start = frame->active_start;
+    runner->pending_end = frame->active_start;
+
+    return json_create_success_result();
+}
+
+/**
+ * Check if the node token designates the key. The raw key is the key without its quotes.
+ *
+ * As escape sequences are longer than the characters they encode, the key has to be decoded only when it is longer than the token.
+ */
+static inline bool json_query_key_matches(const json_query_node_t* node, const char* raw_key, const size_t raw_key_length) {
+    if (node->escaped) {
+        return json_pointer_key_matches(raw_key, 0, raw_key_length, node->token, node->token_length);
+    }
+
+    if (node->token_length == raw_key_length) {
+        return memcmp(node->token, raw_key, raw_key_length) == 0;
+    }
+
+    return node->token_length < raw_key_length
+        && (raw_key[0] == '\\' || (node->token_length > 0 && raw_key[0] == node->token[0]))
+        && json_pointer_key_matches(raw_key, 0, raw_key_length, node->token, node->token_length);
+}
+
+static json_parser_result_t json_query_on_object_property(json_parser_handler_t* self, const json_raw_string_t key) {
+    json_query_runner_t* runner = (json_query_runner_t*) self;
+    const json_query_frame_t* frame = &runner->frames[runner->frame_used - 1];
+    const json_query_node_t* nodes = runner->query->nodes;
+    const char* raw_key = key.value + 1;
+    const size_t raw_key_length = key.length - 2;
+
+    runner->pending_start = frame->active_end;
+    runner->pending_end = frame->active_end;
+
+    for (uint32_t i = frame->active_start; i < frame->active_end; ++i) {
+        for (uint32_t child = nodes[runner->active[i]].first_child; child != JSON_QUERY_NONE; child = nodes[child].next_sibling) {
+            if (json_query_is_wildcard(&nodes[child]) || json_query_key_matches(&nodes[child], raw_key, raw_key_length)) {
+                json_query_add_pending(runner, child);
+            }
+        }
+    }
+
+    return runner->pending_end == runner->pending_start ? json_create_skip_result() : json_create_success_result();
+}
+
+json_parser_result_t json_query_runner_init(json_query_runner_t* runner, const json_query_t* query, json_query_handler_t* match_handler, const size_t frame_count, json_query_frame_t frames[frame_count], const size_t active_size, uint32_t active[active_size]) {
+    if (runner == nullptr || query == nullptr || match_handler == nullptr || match_handler->on_match == nullptr || active == nullptr || (frames == nullptr && frame_count > 0)) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    if (frame_count < query->depth || active_size < query->node_count) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_TOO_SMALL, 0, 0 };
+    }
+
+    runner->handler = (json_parser_handler_t) {
+        .on_null = json_query_on_null,
+        .on_bool = json_query_on_bool,
+        .on_number = json_query_on_number,
+        .on_integer = json_query_on_integer,
+        .on_string = json_query_on_string,
+        .on_array_start = json_query_on_array_start,
+        .on_array_end = json_query_on_structure_end,
+        .on_object_start = json_query_on_object_start,
+        .on_object_property = json_query_on_object_property,
+        .on_object_end = json_query_on_structure_end,
+    };
+    runner->query = query;
+    runner->match_handler = match_handler;
+    runner->frame_count = frame_count;
+    runner->frames = frames;
+    runner->active_size = active_size;
+    runner->active = active;
+
+    json_query_runner_reset(runner);
+
+    return json_create_success_result();
+}
+
+void json_query_runner_reset(json_query_runner_t* runner) {
+    // The root value is designated by the root node
+    runner->frame_used = 0;
+    runner->active[0] = 0;
+    runner->pending_start = 0;
+    runner->pending_end = 1;
+}
+
+json_parser_result_t json_parse_query(json_query_runner_t* runner, const size_t length, const char json[length], const json_parser_options_t options) {
+    if (runner == nullptr) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    json_query_runner_reset(runner);
+
+    return json_parse(length, json, &runner->handler, options);
+}
@@ -0,0 +1,160 @@
+#ifndef JSON_QUERY_H
+#define JSON_QUERY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "parser.h"
+#include "reader.h"
+
+/**
+ * Value of the node fields which do not reference anything
+ */
+#define JSON_QUERY_NONE UINT32_MAX
+
+/**
+ * A node of a compiled query: a reference token of one or several paths.
+ * The fields are internal to the query.
+ */
+typedef struct {
+    /**
+     * The reference token, as written in the path (with "~0" and "~1" sequences), or "*" for a wildcard
+     */
+    const char* token;
+    uint32_t token_length;
+
+    /**
+     * The token contains "~0" or "~1" sequences or backslashes, so it cannot be compared byte per byte with the raw keys
+     */
+    bool escaped;
+
+    /**
+     * The token as an array index, or JSON_QUERY_NONE if it is not a valid index
+     */
+    uint32_t array_index;
+
+    uint32_t first_child;
+    uint32_t next_sibling;
+
+    /**
+     * The path ending at this node, or JSON_QUERY_NONE
+     */
+    uint32_t path_id;
+} json_query_node_t;
+
+/**
+ * A set of paths compiled into a trie by `json_query_compile()`. It can be shared by several runners, and is not modified by them.
+ */
+typedef struct {
+    size_t node_count;
+    json_query_node_t* nodes;
+
+    /**
+     * The number of reference tokens of the longest path
+     */
+    size_t depth;
+} json_query_t;
+
+/**
+ * Receive the values matched by the paths of a query.
+ * Like `json_parser_handler_t`, the handler receives a pointer to itself, and can be embedded in a larger structure to keep a state.
+ */
+typedef struct json_query_handler_t {
+    /**
+     * Called for each value designated by a path, in document order. A value matched by several paths is reported once per path.
+     *
+     * Scalars are passed as the tokens of `json_reader_next()`, but only strings have their raw characters set.
+     * Arrays and objects are reported with a `JSON_TOKEN_ARRAY_START` or `JSON_TOKEN_OBJECT_START` token when they start:
+     * use a wildcard to get their content.
+     *
+     * Return a non-success result to stop parsing.
+     */
+    json_parser_result_t (*on_match)(struct json_query_handler_t* self, size_t path_id, const json_token_t* value);
+} json_query_handler_t;
+
+/**
+ * An open array or object followed by the runner. The fields are internal to the runner.
+ */
+typedef struct {
+    /**
+     * The range of the query nodes designating the structure, in the active nodes of the runner
+     */
+    uint32_t active_start;
+    uint32_t active_end;
+
+    /**
+     * Index of the next element, for arrays
+     */
+    uint32_t index;
+    bool is_array;
+} json_query_frame_t;
+
+/**
+ * Run a query on the events of a parser, and prune the values which cannot match any path using skip results.
+ * Initialize it with `json_query_runner_init()`, then parse the document with `json_parse_query()`,
+ * or give the `handler` field to any parser entry point supporting skip results, after calling `json_query_runner_reset()`.
+ */
+typedef struct {
+    /**
+     * The parser handler. Must stay the first field, as the parser callbacks receive a pointer to it.
+     */
+    json_parser_handler_t handler;
+
+    const json_query_t* query;
+    json_query_handler_t* match_handler;
+
+    size_t frame_count;
+    size_t frame_used;
+    json_query_frame_t* frames;
+
+    /**
+     * The query nodes designating the open structures, followed by the nodes designating the next value
+     */
+    size_t active_size;
+    uint32_t* active;
+    uint32_t pending_start;
+    uint32_t pending_end;
+} json_query_runner_t;
+
+/**
+ * Compute the number of nodes needed by `json_query_compile()` for the given paths, i.e. the count of reference tokens plus one.
+ */
+size_t json_query_node_count(size_t path_count, const char* const paths[path_count]);
+
+/**
+ * Compile a set of JSON Pointers (RFC 6901) into a query. Paths sharing a prefix share their nodes.
+ * The id of each path is its index in the paths array.
+ *
+ * As an extension, a "*" reference token is a wildcard, which matches any property of an object or element of an array.
+ * So a property named "*" cannot be designated.
+ *
+ * A malformed or duplicated path is reported with `JSON_ERROR_INVALID_POINTER`, and its index as position.
+ *
+ * @param paths The paths, which must live as long as the query: the tokens are not copied.
+ * @param node_capacity The size of nodes. See `json_query_node_count()`.
+ * @param nodes The nodes of the query. It must live as long as the query.
+ */
+json_parser_result_t json_query_compile(json_query_t* query, size_t path_count, const char* const paths[path_count], size_t node_capacity, json_query_node_t nodes[node_capacity]);
+
+/**
+ * Initialize a runner of the query.
+ *
+ * @param frame_count The size of frames. Must be at least `query->depth`.
+ * @param frames The open structures. It must live as long as the runner.
+ * @param active_size The size of active. Must be at least `query->node_count`.
+ * @param active The nodes of the query matching the current position. It must live as long as the runner.
+ */
+json_parser_result_t json_query_runner_init(json_query_runner_t* runner, const json_query_t* query, json_query_handler_t* match_handler, size_t frame_count, json_query_frame_t frames[frame_count], size_t active_size, uint32_t active[active_size]);
+
+/**
+ * Prepare the runner for a new document.
+ */
+void json_query_runner_reset(json_query_runner_t* runner);
+
+/**
+ * Parse the document with `json_parse()`, and report the values matched by the query to the match handler of the runner.
+ * Values which cannot match any path are skipped without being checked.
+ */
+json_parser_result_t json_parse_query(json_query_runner_t* runner, size_t length, const char json[length], json_parser_options_t options);
+
+#endif //JSON_QUERY_H
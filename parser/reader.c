@@ -0,0 +1,328 @@
+#include "reader.h"
+
+#include <string.h>
+
+#include "number.h"
+#include "parser_internal.h"
+#include "scanner.h"
+
+/**
+ * The reader follows the same rules as the iterative engine: each nesting level counts twice in depth,
+ * and structure sizes count separators too. Scalars are scanned with the functions of the streaming parser,
+ * which do not call the handler, so no indirect call is made while reading.
+ */
+
+static json_token_kind_t json_reader_fail(json_reader_t* reader, json_token_t* token, const json_parser_result_t result) {
+    reader->phase = JSON_READER_FAILED;
+    memcpy(&reader->error, &result, sizeof(result));
+
+    token->kind = JSON_TOKEN_ERROR;
+    memcpy(&token->raw, &(json_raw_string_t) { .length = 0, .value = reader->json + result.position }, sizeof(json_raw_string_t));
+
+    return JSON_TOKEN_ERROR;
+}
+
+static json_token_kind_t json_reader_emit(json_token_t* token, const json_token_kind_t kind, const char* start, const size_t length) {
+    token->kind = kind;
+    memcpy(&token->raw, &(json_raw_string_t) { .length = length, .value = start }, sizeof(json_raw_string_t));
+
+    return kind;
+}
+
+json_parser_result_t json_reader_init(json_reader_t* reader, const size_t length, const char json[length], json_parser_options_t options, const size_t stack_size, json_parser_frame_t stack[stack_size]) {
+    if (reader == nullptr || json == nullptr || length == 0 || (stack == nullptr && stack_size > 0)) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    options = json_default_parser_options(options);
+
+    const json_parser_result_t options_result = json_parser_check_options(options);
+
+    if (options_result.code != JSON_PARSE_SUCCESS) {
+        return options_result;
+    }
+
+    reader->json = json;
+    reader->length = length;
+    reader->options = options;
+    reader->stack_size = stack_size;
+    reader->stack_used = 0;
+    reader->stack = stack;
+    reader->position = 0;
+    reader->phase = JSON_READER_VALUE;
+
+    const json_parser_result_t success = json_create_success_result();
+    memcpy(&reader->error, &success, sizeof(success));
+
+    return success;
+}
+
+static bool json_reader_scan_whitespace(json_stream_parser_state_t* state) {
+    state->position = json_scan_whitespace(state->json, state->position, state->length);
+
+    return state->position < state->length;
+}
+
+static inline bool json_reader_skip_whitespace(json_stream_parser_state_t* state) {
+    // Tokens are rarely separated by whitespaces: avoid the scanner call in this case
+    if (state->position < state->length && !json_is_whitespace(state->json[state->position])) {
+        return true;
+    }
+
+    return json_reader_scan_whitespace(state);
+}
+
+/**
+ * Scan the scalar at the current position, and fill the kind and the decoded value of the token.
+ */
+static json_parser_result_t json_reader_scan_scalar(json_stream_parser_state_t* state, json_token_t* token, const char current_char, const size_t depth) {
+    switch (current_char) {
+        case '"':
+            token->kind = JSON_TOKEN_STRING;
+            return json_parser_scan_string(state, depth, false);
+
+        case 'n':
+            token->kind = JSON_TOKEN_NULL;
+            return json_parse_constant(state, "null", 4, depth, JSON_CONTEXT_NULL);
+
+        case 't':
+            token->kind = JSON_TOKEN_BOOL;
+            token->bool_value = true;
+            return json_parse_constant(state, "true", 4, depth, JSON_CONTEXT_BOOL);
+
+        case 'f':
+            token->kind = JSON_TOKEN_BOOL;
+            token->bool_value = false;
+            return json_parse_constant(state, "false", 5, depth, JSON_CONTEXT_BOOL);
+
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9': {
+            json_number_t number;
+            const json_parser_result_t result = json_parser_scan_number(state, depth, &number);
+
+            if (result.code != JSON_PARSE_SUCCESS) {
+                return result;
+            }
+
+            if (number.integer) {
+                token->kind = JSON_TOKEN_INTEGER;
+                token->integer_value = json_number_to_integer(&number);
+            } else {
+                token->kind = JSON_TOKEN_NUMBER;
+                token->number_value = json_number_to_double(&number);
+            }
+
+            return result;
+        }
+
+        default:
+            return (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNEXPECTED_CHARACTER, 0, state->position };
+    }
+}
+
+static json_token_kind_t json_reader_read_scalar(json_reader_t* reader, json_stream_parser_state_t* state, json_token_t* token, const char current_char, const size_t depth) {
+    const size_t start_position = state->position;
+    const json_parser_result_t result = json_reader_scan_scalar(state, token, current_char, depth);
+
+    if (result.code != JSON_PARSE_SUCCESS) {
+        return json_reader_fail(reader, token, result);
+    }
+
+    reader->phase = reader->stack_used == 0 ? JSON_READER_DONE : JSON_READER_STRUCTURE;
+
+    return json_reader_emit(token, token->kind, state->json + start_position, state->position - start_position);
+}
+
+static json_token_kind_t json_reader_read_value(json_reader_t* reader, json_stream_parser_state_t* state, json_token_t* token) {
+    const size_t depth = 2 * reader->stack_used;
+
+    if (depth > state->max_depth) {
+        return json_reader_fail(reader, token, (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNKNOWN, 0, state->position });
+    }
+
+    if (!json_reader_skip_whitespace(state)) {
+        return json_reader_fail(reader, token, (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_UNKNOWN, JSON_ERROR_EMPTY_VALUE, 0, state->position });
+    }
+
+    const char current_char = state->json[state->position];
+
+    if (current_char != '[' && current_char != '{') {
+        return json_reader_read_scalar(reader, state, token, current_char, depth + 1);
+    }
+
+    const json_parse_context_t context = current_char == '{' ? JSON_CONTEXT_OBJECT : JSON_CONTEXT_ARRAY;
+
+    // The max depth error takes precedence, to report the same error as json_parse() when possible
+    if (reader->stack_used >= reader->stack_size && depth + 1 <= state->max_depth) {
+        return json_reader_fail(reader, token, (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, context, JSON_ERROR_STACK_OVERFLOW, 0, state->position });
+    }
+
+    if (depth + 1 > state->max_depth) {
+        return json_reader_fail(reader, token, (json_parser_result_t) { JSON_PARSE_ERROR_MAX_DEPTH, context, JSON_ERROR_UNKNOWN, 0, state->position });
+    }
+
+    if (state->position + 1 >= state->length) {
+        return json_reader_fail(reader, token, (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, context, JSON_ERROR_TOO_SMALL, 0, state->position });
+    }
+
+    reader->stack[reader->stack_used++] = (json_parser_frame_t) {
+        .length = 0,
+        .type = context,
+        .expected = true,
+    };
+    reader->phase = JSON_READER_STRUCTURE;
+
+    return json_reader_emit(
+        token,
+        context == JSON_CONTEXT_OBJECT ? JSON_TOKEN_OBJECT_START : JSON_TOKEN_ARRAY_START,
+        state->json + state->position++,
+        1
+    );
+}
+
+/**
+ * Read the next token inside the current structure: the closing bracket, a property key, or an array element.
+ * Commas are consumed on the way.
+ */
+static json_token_kind_t json_reader_read_structure(json_reader_t* reader, json_stream_parser_state_t* state, json_token_t* token) {
+    for (;;) {
+        json_parser_frame_t* frame = &reader->stack[reader->stack_used - 1];
+        const bool is_object = frame->type == JSON_CONTEXT_OBJECT;
+        const char closing_char = is_object ? '}' : ']';
+
+        if (state->position >= state->length) {
+            return json_reader_fail(reader, token, (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, frame->type, JSON_ERROR_MISSING_CLOSING_CHARACTER, closing_char, state->position });
+        }
+
+        if (frame->length > state->max_struct_size) {
+            return json_reader_fail(reader, token, (json_parser_result_t) { JSON_PARSE_ERROR_MAX_STRUCT_SIZE, frame->type, JSON_ERROR_UNKNOWN, 0, state->position });
+        }
+
+        ++frame->length;
+
+        if (!json_reader_skip_whitespace(state)) {
+            return json_reader_fail(reader, token, is_object
+                ? (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_EMPTY_VALUE, 0, state->position }
+                : (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_ARRAY, JSON_ERROR_MISSING_CLOSING_CHARACTER, ']', state->position }
+            );
+        }
+
+        const char current_char = state->json[state->position];
+
+        if (current_char == closing_char) {
+            --reader->stack_used;
+            reader->phase = reader->stack_used == 0 ? JSON_READER_DONE : JSON_READER_STRUCTURE;
+
+            return json_reader_emit(
+                token,
+                is_object ? JSON_TOKEN_OBJECT_END : JSON_TOKEN_ARRAY_END,
+                state->json + state->position++,
+                1
+            );
+        }
+
+        if (current_char == ',') {
+            if (frame->expected) {
+                return json_reader_fail(reader, token, (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, frame->type, JSON_ERROR_UNEXPECTED_CHARACTER, is_object ? '"' : 0, state->position });
+            }
+
+            frame->expected = true;
+            ++state->position;
+            continue;
+        }
+
+        if (!frame->expected) {
+            return json_reader_fail(reader, token, (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, frame->type, JSON_ERROR_UNEXPECTED_CHARACTER, ',', state->position });
+        }
+
+        frame->expected = false;
+
+        if (!is_object) {
+            return json_reader_read_value(reader, state, token);
+        }
+
+        const size_t key_position = state->position;
+        const json_parser_result_t key_result = json_parser_scan_string(state, 2 * reader->stack_used, true);
+
+        if (key_result.code != JSON_PARSE_SUCCESS) {
+            return json_reader_fail(reader, token, key_result);
+        }
+
+        const size_t key_length = state->position - key_position;
+
+        // Errors on the colon are reported by the next call, after the property token, like json_parse() does
+        if (json_reader_skip_whitespace(state) && state->json[state->position] == ':') {
+            ++state->position;
+            reader->phase = JSON_READER_VALUE;
+        } else {
+            reader->phase = JSON_READER_COLON;
+        }
+
+        return json_reader_emit(token, JSON_TOKEN_OBJECT_PROPERTY, state->json + key_position, key_length);
+    }
+}
+
+/**
+ * Report the error on the missing colon following a property key.
+ */
+static json_token_kind_t json_reader_fail_colon(json_reader_t* reader, json_stream_parser_state_t* state, json_token_t* token) {
+    if (state->position >= state->length) {
+        return json_reader_fail(reader, token, (json_parser_result_t) { JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_MISSING_CLOSING_CHARACTER, ':', state->position });
+    }
+
+    return json_reader_fail(reader, token, (json_parser_result_t) { JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_OBJECT, JSON_ERROR_UNEXPECTED_CHARACTER, ':', state->position });
+}
+
+json_token_kind_t json_reader_next(json_reader_t* reader, json_token_t* token) {
+    switch (reader->phase) {
+        case JSON_READER_DONE:
+            return json_reader_emit(token, JSON_TOKEN_END, reader->json + reader->position, 0);
+
+        case JSON_READER_FAILED:
+            token->kind = JSON_TOKEN_ERROR;
+            memcpy(&token->raw, &(json_raw_string_t) { .length = 0, .value = reader->json + reader->error.position }, sizeof(json_raw_string_t));
+            return JSON_TOKEN_ERROR;
+
+        default:
+            break;
+    }
+
+    json_stream_parser_state_t state = {
+        .json = reader->json,
+        .length = reader->length,
+        .handler = nullptr,
+        .max_depth = reader->options.max_depth,
+        .max_string_size = reader->options.max_string_size,
+        .max_struct_size = reader->options.max_struct_size,
+        .position = reader->position,
+    };
+
+    json_token_kind_t kind;
+
+    switch (reader->phase) {
+        case JSON_READER_VALUE:
+            kind = json_reader_read_value(reader, &state, token);
+            break;
+
+        case JSON_READER_COLON:
+            kind = json_reader_fail_colon(reader, &state, token);
+            break;
+
+        default:
+            kind = json_reader_read_structure(reader, &state, token);
+            break;
+    }
+
+    reader->position = state.position;
+
+    return kind;
+}
@@ -0,0 +1,143 @@
+#ifndef JSON_READER_H
+#define JSON_READER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "parser.h"
+
+typedef enum: uint8_t {
+    /**
+     * The document is malformed or a limit is exceeded: the error is available in the `error` field of the reader
+     */
+    JSON_TOKEN_ERROR,
+
+    /**
+     * The root value is complete. The remaining input is ignored, like with `json_parse()`.
+     */
+    JSON_TOKEN_END,
+
+    JSON_TOKEN_NULL,
+
+    /**
+     * The value is available in `bool_value`
+     */
+    JSON_TOKEN_BOOL,
+
+    /**
+     * A number which is not an integer, or does not fit in 64 bits. The value is available in `number_value`.
+     */
+    JSON_TOKEN_NUMBER,
+
+    /**
+     * The raw string, including quotes and escape sequences, is available in `raw`
+     */
+    JSON_TOKEN_STRING,
+
+    JSON_TOKEN_ARRAY_START,
+    JSON_TOKEN_ARRAY_END,
+    JSON_TOKEN_OBJECT_START,
+
+    /**
+     * The raw property key, including quotes and escape sequences, is available in `raw`.
+     * The next token is the property value.
+     */
+    JSON_TOKEN_OBJECT_PROPERTY,
+
+    JSON_TOKEN_OBJECT_END,
+
+    /**
+     * A number without fraction nor exponent, which fits in a int64_t. The value is available in `integer_value`.
+     */
+    JSON_TOKEN_INTEGER,
+} json_token_kind_t;
+
+typedef struct {
+    json_token_kind_t kind;
+
+    /**
+     * The characters of the token in the input.
+     * Brackets have a length of 1, and the end and error tokens have a length of 0.
+     */
+    json_raw_string_t raw;
+
+    union {
+        bool bool_value;
+        double number_value;
+        int64_t integer_value;
+    };
+} json_token_t;
+
+typedef enum: uint8_t {
+    /**
+     * A value is expected: the root value, or the value of a property
+     */
+    JSON_READER_VALUE,
+
+    /**
+     * Inside an array or object, waiting for an element, a property, a separator or the closing bracket
+     */
+    JSON_READER_STRUCTURE,
+
+    /**
+     * A property key has been read, but is not followed by a colon: the next call reports the error
+     */
+    JSON_READER_COLON,
+
+    /**
+     * The root value is complete
+     */
+    JSON_READER_DONE,
+
+    /**
+     * An error occurred, the reader cannot continue
+     */
+    JSON_READER_FAILED,
+} json_reader_phase_t;
+
+/**
+ * Pull parser: the tokens of the document are read one by one with `json_reader_next()`,
+ * instead of being sent to a handler.
+ * Initialize it with `json_reader_init()`. The fields are internal to the reader, except `error`.
+ *
+ * The tokens, the limits and the errors are the same as the events of `json_parse()`:
+ * for any input, the sequence of tokens matches the sequence of handler calls (with an `on_integer` handler).
+ */
+typedef struct {
+    const char* json;
+    size_t length;
+    json_parser_options_t options;
+
+    size_t stack_size;
+    size_t stack_used;
+    json_parser_frame_t* stack;
+
+    size_t position;
+    json_reader_phase_t phase;
+
+    /**
+     * The error of the reader, once `JSON_TOKEN_ERROR` is returned
+     */
+    json_parser_result_t error;
+} json_reader_t;
+
+/**
+ * Initialize the reader.
+ *
+ * @param length The length of the JSON input
+ * @param json The JSON input. It must live as long as the reader, because the raw slices of the tokens point into it.
+ * @param stack_size The number of frames in the stack, i.e. the maximum number of nested arrays or objects. See `JSON_PARSER_STACK_SIZE()`.
+ * @param stack The stack used to track nested structures. It must live as long as the reader.
+ */
+json_parser_result_t json_reader_init(json_reader_t* reader, size_t length, const char json[length], json_parser_options_t options, size_t stack_size, json_parser_frame_t stack[stack_size]);
+
+/**
+ * Read the next token of the document.
+ *
+ * Return the kind of the token, also stored in `token->kind`.
+ * Once the root value is complete, `JSON_TOKEN_END` is returned by all subsequent calls.
+ * After an error, `JSON_TOKEN_ERROR` is returned by all subsequent calls, and the error is kept in `reader->error`.
+ */
+json_token_kind_t json_reader_next(json_reader_t* reader, json_token_t* token);
+
+#endif //JSON_READER_H
@@ -0,0 +1,929 @@
+#ifndef JSON_SCANNER_H
+#define JSON_SCANNER_H
+
+/**
+ * Low level scanning primitives shared by the parsers.
+ *
+ * Each primitive has a scalar version, which is the reference implementation, and a vectorized version
+ * using AVX2 or SSE2 when available at compile time. Both versions must return the same result for any input.
+ * Define JSON_DISABLE_SIMD to force the scalar versions.
+ *
+ * Vectorized versions never read past the given end position: the remaining bytes are handled by the scalar version.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if !defined(JSON_DISABLE_SIMD) && defined(__AVX2__)
+#define JSON_SIMD_AVX2 1
+#include <immintrin.h>
+#elif !defined(JSON_DISABLE_SIMD) && defined(__SSE2__)
+#define JSON_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/**
+ * Find the first byte in the range [position, end) which requires special handling inside a JSON string:
+ * a quote, a backslash or a control character (< 0x20).
+ *
+ * @return The position of the found byte, or end if there is none.
+ */
+static inline size_t json_scan_string_special_scalar(const char* json, size_t position, const size_t end) {
+    for (; position < end; ++position) {
+        const unsigned char current_char = (unsigned char) json[position];
+
+        if (current_char == '"' || current_char == '\\' || current_char < 0x20) {
+            return position;
+        }
+    }
+
+    return end;
+}
+
+/**
+ * Vectorized version of `json_scan_string_special_scalar()`.
+ */
+static inline size_t json_scan_string_special(const char* json, size_t position, const size_t end) {
+#if defined(JSON_SIMD_AVX2)
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control_max = _mm256_set1_epi8(0x1F);
+
+    while (end - position >= 32) {
+        const __m256i chunk = _mm256_loadu_si256((const __m256i*) (json + position));
+        const __m256i special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+            // unsigned chunk <= 0x1F
+            _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control_max), chunk)
+        );
+        const uint32_t mask = (uint32_t) _mm256_movemask_epi8(special);
+
+        if (mask != 0) {
+            return position + (size_t) __builtin_ctz(mask);
+        }
+
+        position += 32;
+    }
+#endif
+
+#if defined(JSON_SIMD_AVX2) || defined(JSON_SIMD_SSE2)
+    const __m128i quote_128 = _mm_set1_epi8('"');
+    const __m128i backslash_128 = _mm_set1_epi8('\\');
+    const __m128i control_max_128 = _mm_set1_epi8(0x1F);
+
+    while (end - position >= 16) {
+        const __m128i chunk = _mm_loadu_si128((const __m128i*) (json + position));
+        const __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote_128), _mm_cmpeq_epi8(chunk, backslash_128)),
+            // unsigned chunk <= 0x1F
+            _mm_cmpeq_epi8(_mm_min_epu8(chunk, control_max_128), chunk)
+        );
+        const uint32_t mask = (uint32_t) _mm_movemask_epi8(special);
+
+        if (mask != 0) {
+            return position + (size_t) __builtin_ctz(mask);
+        }
+
+        position += 16;
+    }
+#endif
+
+    return json_scan_string_special_scalar(json, position, end);
+}
+
+/**
+ * Find the first byte in the range [position, end) which requires special handling when validating a JSON string:
+ * a quote, a backslash, a control character (< 0x20), or a non-ASCII byte (>= 0x80) starting an UTF-8 sequence.
+ *
+ * @return The position of the found byte, or end if there is none.
+ */
+static inline size_t json_scan_string_strict_scalar(const char* json, size_t position, const size_t end) {
+    for (; position < end; ++position) {
+        const unsigned char current_char = (unsigned char) json[position];
+
+        if (current_char == '"' || current_char == '\\' || current_char < 0x20 || current_char >= 0x80) {
+            return position;
+        }
+    }
+
+    return end;
+}
+
+/**
+ * Vectorized version of `json_scan_string_strict_scalar()`.
+ * Non-ASCII bytes are found with the sign bit of each byte, so they cost no extra comparison.
+ */
+static inline size_t json_scan_string_strict(const char* json, size_t position, const size_t end) {
+#if defined(JSON_SIMD_AVX2)
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control_max = _mm256_set1_epi8(0x1F);
+
+    while (end - position >= 32) {
+        const __m256i chunk = _mm256_loadu_si256((const __m256i*) (json + position));
+        const __m256i special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+            // unsigned chunk <= 0x1F
+            _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control_max), chunk)
+        );
+        const uint32_t mask = (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(special, chunk));
+
+        if (mask != 0) {
+            return position + (size_t) __builtin_ctz(mask);
+        }
+
+        position += 32;
+    }
+#endif
+
+#if defined(JSON_SIMD_AVX2) || defined(JSON_SIMD_SSE2)
+    const __m128i quote_128 = _mm_set1_epi8('"');
+    const __m128i backslash_128 = _mm_set1_epi8('\\');
+    const __m128i control_max_128 = _mm_set1_epi8(0x1F);
+
+    while (end - position >= 16) {
+        const __m128i chunk = _mm_loadu_si128((const __m128i*) (json + position));
+        const __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote_128), _mm_cmpeq_epi8(chunk, backslash_128)),
+            // unsigned chunk <= 0x1F
+            _mm_cmpeq_epi8(_mm_min_epu8(chunk, control_max_128), chunk)
+        );
+        const uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_or_si128(special, chunk));
+
+        if (mask != 0) {
+            return position + (size_t) __builtin_ctz(mask);
+        }
+
+        position += 16;
+    }
+#endif
+
+    return json_scan_string_strict_scalar(json, position, end);
+}
+
+/**
+ * Check the UTF-8 sequence starting at the given position, following RFC 3629:
+ * overlong encodings, surrogates (U+D800 to U+DFFF) and code points above U+10FFFF are rejected.
+ *
+ * @return The length of the sequence, between 1 and 4, or 0 if it is invalid or truncated by end.
+ */
+static inline size_t json_utf8_sequence_length(const char* json, const size_t position, const size_t end) {
+    const unsigned char* bytes = (const unsigned char*) json + position;
+    const size_t available = end - position;
+    const unsigned char first = bytes[0];
+
+    if (first < 0x80) {
+        return 1;
+    }
+
+    // Continuation bytes, and overlong 2 bytes sequences
+    if (first < 0xC2 || first > 0xF4) {
+        return 0;
+    }
+
+    const size_t length = first < 0xE0 ? 2 : first < 0xF0 ? 3 : 4;
+
+    if (available < length) {
+        return 0;
+    }
+
+    for (size_t i = 1; i < length; ++i) {
+        if ((bytes[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+
+    // The second byte range is restricted for some first bytes: overlong encodings, surrogates, and code points above U+10FFFF
+    if ((first == 0xE0 && bytes[1] < 0xA0) || (first == 0xED && bytes[1] >= 0xA0) || (first == 0xF0 && bytes[1] < 0x90) || (first == 0xF4 && bytes[1] >= 0x90)) {
+        return 0;
+    }
+
+    return length;
+}
+
+/**
+ * Find the first byte in the range [position, end) which requires special handling inside a JSON string, like
+ * `json_scan_string_special_scalar()`, while checking the UTF-8 sequences of the skipped bytes.
+ * The scan also stops on the first byte of an invalid UTF-8 sequence, or of a sequence truncated by end.
+ *
+ * @return The position of the found byte, or end if there is none.
+ *         The found byte is non-ASCII only if its sequence is invalid or truncated.
+ */
+static inline size_t json_scan_string_utf8_scalar(const char* json, size_t position, const size_t end) {
+    while (position < end) {
+        const unsigned char current_char = (unsigned char) json[position];
+
+        if (current_char == '"' || current_char == '\\' || current_char < 0x20) {
+            return position;
+        }
+
+        const size_t sequence_length = json_utf8_sequence_length(json, position, end);
+
+        if (sequence_length == 0) {
+            return position;
+        }
+
+        position += sequence_length;
+    }
+
+    return end;
+}
+
+#if defined(JSON_SIMD_AVX2)
+/**
+ * Flag the invalid UTF-8 sequences of a block, with the lookup tables of Keiser and Lemire,
+ * "Validating UTF-8 In Less Than One Instruction Per Byte" (2021).
+ * Each pair of consecutive bytes is classified with the nibbles of both bytes, and a byte is an error if the three lookups share a bit.
+ * The previous block is needed for the sequences crossing the boundary of the blocks.
+ *
+ * @return A non-zero vector if the block contains an invalid sequence. Sequences truncated by the end of the block are not flagged.
+ */
+static inline __m256i json_utf8_check_block(const __m256i block, const __m256i previous) {
+    // Lead byte not followed by enough continuation bytes
+    constexpr uint8_t too_short = 1 << 0;
+    // Continuation byte following an ASCII byte
+    constexpr uint8_t too_long = 1 << 1;
+    constexpr uint8_t overlong_3 = 1 << 2;
+    // Code point above U+10FFFF
+    constexpr uint8_t too_large = 1 << 3;
+    constexpr uint8_t surrogate = 1 << 4;
+    constexpr uint8_t overlong_2 = 1 << 5;
+    constexpr uint8_t too_large_1000 = 1 << 6;
+    constexpr uint8_t overlong_4 = 1 << 6;
+    // Continuation byte following a continuation byte: only valid for the third and fourth bytes of a sequence
+    constexpr uint8_t two_continuations = 1 << 7;
+    constexpr uint8_t carry = too_short | too_long | two_continuations;
+
+    const __m256i first_high_table = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        // ASCII
+        too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+        // Continuation
+        (char) two_continuations, (char) two_continuations, (char) two_continuations, (char) two_continuations,
+        // 110_____
+        too_short | overlong_2, too_short,
+        // 1110____
+        too_short | overlong_3 | surrogate,
+        // 11110___ and invalid lead bytes
+        too_short | too_large | too_large_1000 | overlong_4
+    ));
+    const __m256i first_low_table = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        (char) (carry | overlong_3 | overlong_2 | overlong_4),
+        (char) (carry | overlong_2),
+        (char) carry,
+        (char) carry,
+        (char) (carry | too_large),
+        (char) (carry | too_large | too_large_1000),
+        (char) (carry | too_large | too_large_1000),
+        (char) (carry | too_large | too_large_1000),
+        (char) (carry | too_large | too_large_1000),
+        (char) (carry | too_large | too_large_1000),
+        (char) (carry | too_large | too_large_1000),
+        (char) (carry | too_large | too_large_1000),
+        (char) (carry | too_large | too_large_1000),
+        (char) (carry | too_large | too_large_1000 | surrogate),
+        (char) (carry | too_large | too_large_1000),
+        (char) (carry | too_large | too_large_1000)
+    ));
+    const __m256i second_high_table = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        // ASCII
+        too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+        // 1000____
+        (char) (too_long | overlong_2 | two_continuations | overlong_3 | too_large_1000 | overlong_4),
+        // 1001____
+        (char) (too_long | overlong_2 | two_continuations | overlong_3 | too_large),
+        // 101_____
+        (char) (too_long | overlong_2 | two_continuations | surrogate | too_large),
+        (char) (too_long | overlong_2 | two_continuations | surrogate | too_large),
+        // Lead bytes
+        too_short, too_short, too_short, too_short
+    ));
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+
+    // The block shifted by 1, 2 and 3 bytes, starting with the last bytes of the previous block
+    const __m256i shifted = _mm256_permute2x128_si256(previous, block, 0x21);
+    const __m256i previous_1 = _mm256_alignr_epi8(block, shifted, 15);
+    const __m256i previous_2 = _mm256_alignr_epi8(block, shifted, 14);
+    const __m256i previous_3 = _mm256_alignr_epi8(block, shifted, 13);
+
+    const __m256i errors = _mm256_and_si256(
+        _mm256_and_si256(
+            _mm256_shuffle_epi8(first_high_table, _mm256_and_si256(_mm256_srli_epi16(previous_1, 4), nibble_mask)),
+            _mm256_shuffle_epi8(first_low_table, _mm256_and_si256(previous_1, nibble_mask))
+        ),
+        _mm256_shuffle_epi8(second_high_table, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble_mask))
+    );
+
+    // Third bytes of 3 and 4 bytes sequences, and fourth bytes of 4 bytes sequences, must be continuation bytes
+    const __m256i third_byte = _mm256_subs_epu8(previous_2, _mm256_set1_epi8((char) (0xE0 - 0x80)));
+    const __m256i fourth_byte = _mm256_subs_epu8(previous_3, _mm256_set1_epi8((char) (0xF0 - 0x80)));
+    const __m256i continuation_expected = _mm256_and_si256(_mm256_or_si256(third_byte, fourth_byte), _mm256_set1_epi8((char) 0x80));
+
+    return _mm256_xor_si256(continuation_expected, errors);
+}
+#endif
+
+/**
+ * Vectorized version of `json_scan_string_utf8_scalar()`.
+ *
+ * With AVX2, blocks of non-ASCII text are validated at once with `json_utf8_check_block()`.
+ * When a block contains an error or a special character, the scan falls back to the byte-wise search
+ * from the start of the block, to return the exact position.
+ * Otherwise, the ASCII bytes are skipped with `json_scan_string_strict()`, and the UTF-8 sequences are checked one by one.
+ */
+static inline size_t json_scan_string_utf8(const char* json, size_t position, const size_t end) {
+#if defined(JSON_SIMD_AVX2)
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control_max = _mm256_set1_epi8(0x1F);
+    const size_t start = position;
+    __m256i previous = _mm256_setzero_si256();
+    // The last bytes of the previous block are the beginning of a sequence
+    bool previous_incomplete = false;
+
+    while (end - position >= 32) {
+        const __m256i chunk = _mm256_loadu_si256((const __m256i*) (json + position));
+        const __m256i special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+            // unsigned chunk <= 0x1F
+            _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control_max), chunk)
+        );
+        const uint32_t mask = (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(special, chunk));
+
+        if (mask != 0) {
+            if (_mm256_movemask_epi8(special) != 0) {
+                break;
+            }
+
+            const __m256i errors = json_utf8_check_block(chunk, previous);
+
+            if (!_mm256_testz_si256(errors, errors)) {
+                break;
+            }
+
+            const unsigned char* last_bytes = (const unsigned char*) json + position + 29;
+            previous_incomplete = last_bytes[2] >= 0xC0 || last_bytes[1] >= 0xE0 || last_bytes[0] >= 0xF0;
+        } else if (previous_incomplete) {
+            // ASCII block: only a sequence truncated by the end of the previous block is an error
+            break;
+        }
+
+        previous = chunk;
+        position += 32;
+    }
+
+    // Go back to the first byte of the sequence truncated by the last block, if any
+    for (size_t i = 1; position > start && i <= 3; ++i) {
+        const unsigned char current_char = (unsigned char) json[position - i];
+
+        if (current_char < 0x80) {
+            break;
+        }
+
+        if (current_char >= 0xC0) {
+            if ((current_char >= 0xF0 ? 4u : current_char >= 0xE0 ? 3u : 2u) > i) {
+                position -= i;
+            }
+
+            break;
+        }
+    }
+#endif
+
+    while (position < end) {
+        position = json_scan_string_strict(json, position, end);
+
+        if (position >= end || (unsigned char) json[position] < 0x80) {
+            return position;
+        }
+
+        const size_t sequence_length = json_utf8_sequence_length(json, position, end);
+
+        if (sequence_length == 0) {
+            return position;
+        }
+
+        position += sequence_length;
+    }
+
+    return end;
+}
+
+/**
+ * Check if the given character is a JSON whitespace (space, line feed, carriage return or tab).
+ */
+static inline bool json_is_whitespace(const char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+/**
+ * Find the first non-whitespace byte in the range [position, end).
+ *
+ * @return The position of the found byte, or end if the range only contains whitespaces.
+ */
+static inline size_t json_scan_whitespace_scalar(const char* json, size_t position, const size_t end) {
+    while (position < end && json_is_whitespace(json[position])) {
+        ++position;
+    }
+
+    return position;
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+/**
+ * SWAR helper: set the high bit of each byte of the word which is equal to zero, and clear all other bits.
+ * Unlike the usual "has zero byte" trick, the result is exact for every byte as no carry can cross bytes.
+ */
+static inline uint64_t json_swar_zero_bytes(const uint64_t word) {
+    constexpr uint64_t low_bits = 0x7F7F7F7F7F7F7F7FULL;
+    return ~(((word & low_bits) + low_bits) | word | low_bits);
+}
+
+/**
+ * SWAR helper: set the high bit of each byte of the word which is a JSON whitespace.
+ */
+static inline uint64_t json_swar_whitespace_bytes(const uint64_t word) {
+    constexpr uint64_t ones = 0x0101010101010101ULL;
+
+    return json_swar_zero_bytes(word ^ (ones * ' '))
+        | json_swar_zero_bytes(word ^ (ones * '\n'))
+        | json_swar_zero_bytes(word ^ (ones * '\r'))
+        | json_swar_zero_bytes(word ^ (ones * '\t'))
+    ;
+}
+#endif
+
+/**
+ * Vectorized version of `json_scan_whitespace_scalar()`.
+ * When SIMD is not available, 8 bytes words are checked at once.
+ */
+static inline size_t json_scan_whitespace(const char* json, size_t position, const size_t end) {
+    // Fast path for minified input: most values are not preceded by any whitespace
+    if (position >= end || !json_is_whitespace(json[position])) {
+        return position;
+    }
+
+    // Fast path for single space separators, like in "key": value
+    if (++position >= end || !json_is_whitespace(json[position])) {
+        return position;
+    }
+
+#if defined(JSON_SIMD_AVX2)
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i line_feed = _mm256_set1_epi8('\n');
+    const __m256i carriage_return = _mm256_set1_epi8('\r');
+    const __m256i tab = _mm256_set1_epi8('\t');
+
+    while (end - position >= 32) {
+        const __m256i chunk = _mm256_loadu_si256((const __m256i*) (json + position));
+        const __m256i whitespace = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, line_feed)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, carriage_return), _mm256_cmpeq_epi8(chunk, tab))
+        );
+        const uint32_t mask = ~(uint32_t) _mm256_movemask_epi8(whitespace);
+
+        if (mask != 0) {
+            return position + (size_t) __builtin_ctz(mask);
+        }
+
+        position += 32;
+    }
+#endif
+
+#if defined(JSON_SIMD_AVX2) || defined(JSON_SIMD_SSE2)
+    const __m128i space_128 = _mm_set1_epi8(' ');
+    const __m128i line_feed_128 = _mm_set1_epi8('\n');
+    const __m128i carriage_return_128 = _mm_set1_epi8('\r');
+    const __m128i tab_128 = _mm_set1_epi8('\t');
+
+    while (end - position >= 16) {
+        const __m128i chunk = _mm_loadu_si128((const __m128i*) (json + position));
+        const __m128i whitespace = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, space_128), _mm_cmpeq_epi8(chunk, line_feed_128)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, carriage_return_128), _mm_cmpeq_epi8(chunk, tab_128))
+        );
+        const uint32_t mask = ~(uint32_t) _mm_movemask_epi8(whitespace) & 0xFFFF;
+
+        if (mask != 0) {
+            return position + (size_t) __builtin_ctz(mask);
+        }
+
+        position += 16;
+    }
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (end - position >= 8) {
+        uint64_t word;
+        __builtin_memcpy(&word, json + position, sizeof(word));
+
+        const uint64_t mask = ~json_swar_whitespace_bytes(word) & 0x8080808080808080ULL;
+
+        if (mask != 0) {
+            return position + (size_t) (__builtin_ctzll(mask) / 8);
+        }
+
+        position += 8;
+    }
+#endif
+
+    return json_scan_whitespace_scalar(json, position, end);
+}
+
+/**
+ * Find the first line feed in the range [position, end).
+ *
+ * @return The position of the line feed, or end if there is none.
+ */
+static inline size_t json_scan_newline_scalar(const char* json, size_t position, const size_t end) {
+    while (position < end && json[position] != '\n') {
+        ++position;
+    }
+
+    return position;
+}
+
+/**
+ * Vectorized version of `json_scan_newline_scalar()`.
+ */
+static inline size_t json_scan_newline(const char* json, size_t position, const size_t end) {
+#if defined(JSON_SIMD_AVX2)
+    const __m256i line_feed = _mm256_set1_epi8('\n');
+
+    while (end - position >= 32) {
+        const __m256i chunk = _mm256_loadu_si256((const __m256i*) (json + position));
+        const uint32_t mask = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, line_feed));
+
+        if (mask != 0) {
+            return position + (size_t) __builtin_ctz(mask);
+        }
+
+        position += 32;
+    }
+#endif
+
+#if defined(JSON_SIMD_AVX2) || defined(JSON_SIMD_SSE2)
+    const __m128i line_feed_128 = _mm_set1_epi8('\n');
+
+    while (end - position >= 16) {
+        const __m128i chunk = _mm_loadu_si128((const __m128i*) (json + position));
+        const uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, line_feed_128));
+
+        if (mask != 0) {
+            return position + (size_t) __builtin_ctz(mask);
+        }
+
+        position += 16;
+    }
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (end - position >= 8) {
+        uint64_t word;
+        __builtin_memcpy(&word, json + position, sizeof(word));
+
+        const uint64_t mask = json_swar_zero_bytes(word ^ 0x0A0A0A0A0A0A0A0AULL);
+
+        if (mask != 0) {
+            return position + (size_t) (__builtin_ctzll(mask) / 8);
+        }
+
+        position += 8;
+    }
+#endif
+
+    return json_scan_newline_scalar(json, position, end);
+}
+
+/**
+ * Bit masks of the interesting characters of a 64 bytes block.
+ * The bit i is set when the byte i of the block matches.
+ */
+typedef struct {
+    uint64_t quote;
+    uint64_t backslash;
+
+    /**
+     * Structural characters: { } [ ] : ,
+     */
+    uint64_t structural;
+    uint64_t whitespace;
+} json_block_masks_t;
+
+#define JSON_BLOCK_SIZE 64
+
+static inline json_block_masks_t json_scan_block_scalar(const char block[JSON_BLOCK_SIZE]) {
+    json_block_masks_t masks = { 0, 0, 0, 0 };
+
+    for (size_t i = 0; i < JSON_BLOCK_SIZE; ++i) {
+        const uint64_t bit = 1ULL << i;
+
+        switch (block[i]) {
+            case '"':
+                masks.quote |= bit;
+                break;
+
+            case '\\':
+                masks.backslash |= bit;
+                break;
+
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+                masks.structural |= bit;
+                break;
+
+            case ' ':
+            case '\n':
+            case '\r':
+            case '\t':
+                masks.whitespace |= bit;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return masks;
+}
+
+/**
+ * Vectorized version of `json_scan_block_scalar()`.
+ */
+static inline json_block_masks_t json_scan_block(const char block[JSON_BLOCK_SIZE]) {
+#if defined(JSON_SIMD_AVX2)
+    json_block_masks_t masks = { 0, 0, 0, 0 };
+
+    for (size_t offset = 0; offset < JSON_BLOCK_SIZE; offset += 32) {
+        const __m256i chunk = _mm256_loadu_si256((const __m256i*) (block + offset));
+        const __m256i structural = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('{')),
+                _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('}'))
+            ),
+            _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('[')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(']'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(',')))
+            )
+        );
+        const __m256i whitespace = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t')))
+        );
+
+        masks.quote |= (uint64_t) (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'))) << offset;
+        masks.backslash |= (uint64_t) (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'))) << offset;
+        masks.structural |= (uint64_t) (uint32_t) _mm256_movemask_epi8(structural) << offset;
+        masks.whitespace |= (uint64_t) (uint32_t) _mm256_movemask_epi8(whitespace) << offset;
+    }
+
+    return masks;
+#elif defined(JSON_SIMD_SSE2)
+    json_block_masks_t masks = { 0, 0, 0, 0 };
+
+    for (size_t offset = 0; offset < JSON_BLOCK_SIZE; offset += 16) {
+        const __m128i chunk = _mm_loadu_si128((const __m128i*) (block + offset));
+        const __m128i structural = _mm_or_si128(
+            _mm_or_si128(
+                _mm_cmpeq_epi8(chunk, _mm_set1_epi8('{')),
+                _mm_cmpeq_epi8(chunk, _mm_set1_epi8('}'))
+            ),
+            _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('[')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(']'))),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')))
+            )
+        );
+        const __m128i whitespace = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t')))
+        );
+
+        masks.quote |= (uint64_t) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'))) << offset;
+        masks.backslash |= (uint64_t) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))) << offset;
+        masks.structural |= (uint64_t) _mm_movemask_epi8(structural) << offset;
+        masks.whitespace |= (uint64_t) _mm_movemask_epi8(whitespace) << offset;
+    }
+
+    return masks;
+#else
+    return json_scan_block_scalar(block);
+#endif
+}
+
+/**
+ * Masks of the characters needed to match brackets in a block of JSON_BLOCK_SIZE bytes.
+ * The bit i is set when the byte i of the block matches.
+ */
+typedef struct {
+    uint64_t quote;
+    uint64_t backslash;
+
+    /**
+     * Opening brackets: { [
+     */
+    uint64_t open;
+
+    /**
+     * Closing brackets: } ]
+     */
+    uint64_t close;
+} json_bracket_masks_t;
+
+static inline json_bracket_masks_t json_scan_brackets_scalar(const char block[JSON_BLOCK_SIZE]) {
+    json_bracket_masks_t masks = { 0, 0, 0, 0 };
+
+    for (size_t i = 0; i < JSON_BLOCK_SIZE; ++i) {
+        const uint64_t bit = 1ULL << i;
+
+        switch (block[i]) {
+            case '"':
+                masks.quote |= bit;
+                break;
+
+            case '\\':
+                masks.backslash |= bit;
+                break;
+
+            case '{':
+            case '[':
+                masks.open |= bit;
+                break;
+
+            case '}':
+            case ']':
+                masks.close |= bit;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return masks;
+}
+
+/**
+ * Vectorized version of `json_scan_brackets_scalar()`.
+ * The curly and square brackets only differ by the 0x20 bit, so each kind is found with a single comparison.
+ */
+static inline json_bracket_masks_t json_scan_brackets(const char block[JSON_BLOCK_SIZE]) {
+#if defined(JSON_SIMD_AVX2)
+    json_bracket_masks_t masks = { 0, 0, 0, 0 };
+
+    for (size_t offset = 0; offset < JSON_BLOCK_SIZE; offset += 32) {
+        const __m256i chunk = _mm256_loadu_si256((const __m256i*) (block + offset));
+        const __m256i lower = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+
+        masks.quote |= (uint64_t) (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'))) << offset;
+        masks.backslash |= (uint64_t) (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'))) << offset;
+        masks.open |= (uint64_t) (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{'))) << offset;
+        masks.close |= (uint64_t) (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}'))) << offset;
+    }
+
+    return masks;
+#elif defined(JSON_SIMD_SSE2)
+    json_bracket_masks_t masks = { 0, 0, 0, 0 };
+
+    for (size_t offset = 0; offset < JSON_BLOCK_SIZE; offset += 16) {
+        const __m128i chunk = _mm_loadu_si128((const __m128i*) (block + offset));
+        const __m128i lower = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+
+        masks.quote |= (uint64_t) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'))) << offset;
+        masks.backslash |= (uint64_t) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))) << offset;
+        masks.open |= (uint64_t) _mm_movemask_epi8(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{'))) << offset;
+        masks.close |= (uint64_t) _mm_movemask_epi8(_mm_cmpeq_epi8(lower, _mm_set1_epi8('}'))) << offset;
+    }
+
+    return masks;
+#else
+    return json_scan_brackets_scalar(block);
+#endif
+}
+
+/**
+ * Masks of the characters needed to count the values in a block of JSON_BLOCK_SIZE bytes.
+ * The bit i is set when the byte i of the block matches.
+ */
+typedef struct {
+    uint64_t quote;
+    uint64_t backslash;
+
+    /**
+     * Opening brackets: { [
+     */
+    uint64_t open;
+    uint64_t colon;
+
+    /**
+     * Characters ending a literal: structural characters and whitespaces
+     */
+    uint64_t separator;
+} json_value_masks_t;
+
+static inline json_value_masks_t json_scan_values_scalar(const char block[JSON_BLOCK_SIZE]) {
+    json_value_masks_t masks = { 0, 0, 0, 0, 0 };
+
+    for (size_t i = 0; i < JSON_BLOCK_SIZE; ++i) {
+        const uint64_t bit = 1ULL << i;
+
+        switch (block[i]) {
+            case '"':
+                masks.quote |= bit;
+                break;
+
+            case '\\':
+                masks.backslash |= bit;
+                break;
+
+            case '{':
+            case '[':
+                masks.open |= bit;
+                masks.separator |= bit;
+                break;
+
+            case ':':
+                masks.colon |= bit;
+                masks.separator |= bit;
+                break;
+
+            case '}':
+            case ']':
+            case ',':
+            case ' ':
+            case '\n':
+            case '\r':
+            case '\t':
+                masks.separator |= bit;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return masks;
+}
+
+/**
+ * Vectorized version of `json_scan_values_scalar()`.
+ */
+static inline json_value_masks_t json_scan_values(const char block[JSON_BLOCK_SIZE]) {
+#if defined(JSON_SIMD_AVX2)
+    json_value_masks_t masks = { 0, 0, 0, 0, 0 };
+
+    for (size_t offset = 0; offset < JSON_BLOCK_SIZE; offset += 32) {
+        const __m256i chunk = _mm256_loadu_si256((const __m256i*) (block + offset));
+        const __m256i lower = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+        const __m256i open = _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{'));
+        const __m256i colon = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':'));
+        const __m256i separator = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_or_si256(open, colon),
+                _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(',')))
+            ),
+            _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t')))
+            )
+        );
+
+        masks.quote |= (uint64_t) (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'))) << offset;
+        masks.backslash |= (uint64_t) (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'))) << offset;
+        masks.open |= (uint64_t) (uint32_t) _mm256_movemask_epi8(open) << offset;
+        masks.colon |= (uint64_t) (uint32_t) _mm256_movemask_epi8(colon) << offset;
+        masks.separator |= (uint64_t) (uint32_t) _mm256_movemask_epi8(separator) << offset;
+    }
+
+    return masks;
+#elif defined(JSON_SIMD_SSE2)
+    json_value_masks_t masks = { 0, 0, 0, 0, 0 };
+
+    for (size_t offset = 0; offset < JSON_BLOCK_SIZE; offset += 16) {
+        const __m128i chunk = _mm_loadu_si128((const __m128i*) (block + offset));
+        const __m128i lower = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+        const __m128i open = _mm_cmpeq_epi8(lower, _mm_set1_epi8('{'));
+        const __m128i colon = _mm_cmpeq_epi8(chunk, _mm_set1_epi8(':'));
+        const __m128i separator = _mm_or_si128(
+            _mm_or_si128(
+                _mm_or_si128(open, colon),
+                _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('}')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')))
+            ),
+            _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t')))
+            )
+        );
+
+        masks.quote |= (uint64_t) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'))) << offset;
+        masks.backslash |= (uint64_t) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))) << offset;
+        masks.open |= (uint64_t) _mm_movemask_epi8(open) << offset;
+        masks.colon |= (uint64_t) _mm_movemask_epi8(colon) << offset;
+        masks.separator |= (uint64_t) _mm_movemask_epi8(separator) << offset;
+    }
+
+    return masks;
+#else
+    return json_scan_values_scalar(block);
+#endif
+}
+
+#endif //JSON_SCANNER_H
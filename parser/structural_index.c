@@ -0,0 +1,336 @@
+#include "structural_index.h"
+
+#include <string.h>
+
+#include "scanner.h"
+
+#if !defined(JSON_DISABLE_SIMD) && defined(__PCLMUL__)
+#include <wmmintrin.h>
+#endif
+
+void json_structural_index_init(json_structural_index_t* index, const size_t length, const char json[length]) {
+    index->json = json;
+    index->length = length;
+    index->window_start = 0;
+    index->window_end = 0;
+    index->count = 0;
+    index->cursor = 0;
+    index->previous_odd_backslash = 0;
+    index->previous_in_string = 0;
+    // The start of the input is considered as a separator, so a top level literal is indexed
+    index->previous_separator = 1;
+}
+
+/**
+ * Compute the mask of escaped characters, i.e. characters preceded by an odd sequence of backslashes.
+ * Sequences starting on an even position and ending on an odd one (or the opposite) have an odd length.
+ */
+static inline uint64_t json_structural_index_escaped(uint64_t* previous_odd_backslash, const uint64_t backslash) {
+    constexpr uint64_t even_bits = 0x5555555555555555ULL;
+    constexpr uint64_t odd_bits = ~even_bits;
+
+    if (backslash == 0) {
+        const uint64_t escaped = *previous_odd_backslash;
+        *previous_odd_backslash = 0;
+        return escaped;
+    }
+
+    const uint64_t start_edges = backslash & ~(backslash << 1);
+    // A sequence continuing from the previous block has its parity flipped
+    const uint64_t even_start_mask = even_bits ^ *previous_odd_backslash;
+    const uint64_t even_starts = start_edges & even_start_mask;
+    const uint64_t odd_starts = start_edges & ~even_start_mask;
+    const uint64_t even_carries = backslash + even_starts;
+
+    uint64_t odd_carries;
+    const bool ends_odd_backslash = __builtin_add_overflow(backslash, odd_starts, &odd_carries);
+
+    odd_carries |= *previous_odd_backslash;
+    *previous_odd_backslash = ends_odd_backslash ? 1 : 0;
+
+    const uint64_t even_carry_ends = even_carries & ~backslash;
+    const uint64_t odd_carry_ends = odd_carries & ~backslash;
+
+    return (even_carry_ends & odd_bits) | (odd_carry_ends & even_bits);
+}
+
+/**
+ * Compute the prefix xor of the bits, i.e. bit i is the xor of bits 0 to i.
+ * Applied on the quotes, this gives the mask of characters inside strings (including the opening quote).
+ */
+static inline uint64_t json_structural_index_prefix_xor(uint64_t bits) {
+#if !defined(JSON_DISABLE_SIMD) && defined(__PCLMUL__)
+    return (uint64_t) _mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_set_epi64x(0, (int64_t) bits), _mm_set1_epi8((char) 0xFF), 0));
+#else
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+
+    return bits;
+#endif
+}
+
+static inline uint64_t json_structural_index_block(json_structural_index_t* index, const char block[JSON_BLOCK_SIZE]) {
+    const json_block_masks_t masks = json_scan_block(block);
+    const uint64_t escaped = json_structural_index_escaped(&index->previous_odd_backslash, masks.backslash);
+    const uint64_t quotes = masks.quote & ~escaped;
+    const uint64_t in_string = json_structural_index_prefix_xor(quotes) ^ index->previous_in_string;
+    const uint64_t outside = ~in_string;
+
+    index->previous_in_string = (uint64_t) ((int64_t) in_string >> 63);
+
+    const uint64_t structural = masks.structural & outside;
+    const uint64_t separators = ((masks.whitespace | masks.structural) & outside) | (quotes & outside);
+    const uint64_t literals = outside & ~(masks.whitespace | masks.structural | masks.quote);
+    const uint64_t literal_starts = literals & ((separators << 1) | index->previous_separator);
+
+    index->previous_separator = separators >> 63;
+
+    return structural | quotes | literal_starts;
+}
+
+static void json_structural_index_fill_window(json_structural_index_t* index) {
+    const size_t start = index->window_end;
+    const size_t end = index->length - start > JSON_STRUCTURAL_INDEX_WINDOW_SIZE
+        ? start + JSON_STRUCTURAL_INDEX_WINDOW_SIZE
+        : index->length
+    ;
+
+    index->window_start = start;
+    index->window_end = end;
+    index->count = 0;
+    index->cursor = 0;
+
+    for (size_t block_start = start; block_start < end; block_start += JSON_BLOCK_SIZE) {
+        uint64_t mask;
+
+        if (end - block_start >= JSON_BLOCK_SIZE) {
+            mask = json_structural_index_block(index, index->json + block_start);
+        } else {
+            // Copy the last partial block to avoid reading past the end of the input
+            char padded_block[JSON_BLOCK_SIZE];
+            memset(padded_block, ' ', JSON_BLOCK_SIZE);
+            memcpy(padded_block, index->json + block_start, end - block_start);
+
+            mask = json_structural_index_block(index, padded_block);
+        }
+
+        const uint32_t offset = (uint32_t) (block_start - start);
+
+        while (mask != 0) {
+            index->positions[index->count++] = offset + (uint32_t) __builtin_ctzll(mask);
+            mask &= mask - 1;
+        }
+    }
+}
+
+size_t json_structural_index_next(json_structural_index_t* index, const size_t position) {
+    for (;;) {
+        while (index->cursor < index->count) {
+            const size_t current = index->window_start + index->positions[index->cursor];
+
+            if (current >= position) {
+                return current;
+            }
+
+            ++index->cursor;
+        }
+
+        if (index->window_end >= index->length) {
+            return index->length;
+        }
+
+        json_structural_index_fill_window(index);
+    }
+}
+
+size_t json_structural_index_split(const size_t length, const char json[length], const size_t split_count, const size_t targets[split_count], size_t positions[split_count], size_t separator_counts[split_count]) {
+    json_structural_index_t index;
+    size_t depth = 0;
+    size_t separators = 0;
+    size_t found = 0;
+
+    json_structural_index_init(&index, length, json);
+
+    for (size_t block_start = 0; block_start < length && found < split_count; block_start += JSON_BLOCK_SIZE) {
+        char padded_block[JSON_BLOCK_SIZE];
+        const char* block = json + block_start;
+
+        if (length - block_start < JSON_BLOCK_SIZE) {
+            // Copy the last partial block to avoid reading past the end of the input
+            memset(padded_block, ' ', JSON_BLOCK_SIZE);
+            memcpy(padded_block, block, length - block_start);
+            block = padded_block;
+        }
+
+        const json_block_masks_t masks = json_scan_block(block);
+        const uint64_t quotes = masks.quote & ~json_structural_index_escaped(&index.previous_odd_backslash, masks.backslash);
+        const uint64_t in_string = json_structural_index_prefix_xor(quotes) ^ index.previous_in_string;
+        uint64_t structural = masks.structural & ~in_string;
+
+        index.previous_in_string = (uint64_t) ((int64_t) in_string >> 63);
+
+        while (structural != 0) {
+            const size_t offset = (size_t) __builtin_ctzll(structural);
+            structural &= structural - 1;
+
+            switch (block[offset]) {
+                case '[':
+                case '{':
+                    ++depth;
+                    break;
+
+                case ']':
+                case '}':
+                    if (--depth == 0) {
+                        return found;
+                    }
+                    break;
+
+                case ',':
+                    if (depth == 1) {
+                        ++separators;
+
+                        if (block_start + offset >= targets[found]) {
+                            positions[found] = block_start + offset;
+                            separator_counts[found] = separators;
+
+                            if (++found == split_count) {
+                                return found;
+                            }
+                        }
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    return found;
+}
+
+size_t json_structural_index_skip(json_structural_skip_t* skip, const size_t length, const char json[length], size_t position) {
+    while (position < length) {
+        const size_t available = length - position;
+        char padded_block[JSON_BLOCK_SIZE];
+        const char* block = json + position;
+
+        if (available < JSON_BLOCK_SIZE) {
+            // Copy the last partial block to avoid reading past the end of the input
+            memset(padded_block, ' ', JSON_BLOCK_SIZE);
+            memcpy(padded_block, block, available);
+            block = padded_block;
+        }
+
+        const json_bracket_masks_t masks = json_scan_brackets(block);
+        const uint64_t previous_odd_backslash = skip->previous_odd_backslash;
+        const uint64_t quotes = masks.quote & ~json_structural_index_escaped(&skip->previous_odd_backslash, masks.backslash);
+        const uint64_t in_string = json_structural_index_prefix_xor(quotes) ^ skip->previous_in_string;
+        const uint64_t open = masks.open & ~in_string;
+        const uint64_t close = masks.close & ~in_string;
+        const size_t close_count = (size_t) __builtin_popcountll(close);
+
+        skip->previous_in_string = (uint64_t) ((int64_t) in_string >> 63);
+
+        if (close_count < skip->depth) {
+            // The structure cannot be closed in this block, whatever the order of the brackets
+            skip->depth = skip->depth + (size_t) __builtin_popcountll(open) - close_count;
+        } else {
+            for (uint64_t brackets = open | close; brackets != 0; brackets &= brackets - 1) {
+                const uint64_t bit = brackets & -brackets;
+
+                if ((open & bit) != 0) {
+                    ++skip->depth;
+                } else if (--skip->depth == 0) {
+                    return position + (size_t) __builtin_ctzll(bit) + 1;
+                }
+            }
+        }
+
+        if (available < JSON_BLOCK_SIZE) {
+            // The padding is not escaped: keep the parity of the backslashes ending the input for the next chunk
+            size_t backslashes = 0;
+
+            while (backslashes < available && json[length - 1 - backslashes] == '\\') {
+                ++backslashes;
+            }
+
+            skip->previous_odd_backslash = (backslashes % 2) ^ (backslashes == available ? previous_odd_backslash : 0);
+            return length;
+        }
+
+        position += JSON_BLOCK_SIZE;
+    }
+
+    return length;
+}
+
+void json_structural_index_count(const size_t length, const char json[length], json_structural_counts_t* counts) {
+    uint64_t previous_odd_backslash = 0;
+    uint64_t previous_in_string = 0;
+    // The start of the input is considered as a separator, like for the index
+    uint64_t previous_separator = 1;
+    // Twice the decoded bytes: each escape sequence has two raw characters, either two backslashes,
+    // or a backslash and an escaped character, which can be split between two blocks
+    size_t doubled_string_bytes = 0;
+
+    *counts = (json_structural_counts_t) { 0, 0, 0, length, 0 };
+
+    for (size_t block_start = 0; block_start < length; block_start += JSON_BLOCK_SIZE) {
+        char padded_block[JSON_BLOCK_SIZE];
+        const char* block = json + block_start;
+        uint64_t valid = ~0ULL;
+
+        if (length - block_start < JSON_BLOCK_SIZE) {
+            // Copy the last partial block to avoid reading past the end of the input
+            memset(padded_block, ' ', JSON_BLOCK_SIZE);
+            memcpy(padded_block, block, length - block_start);
+            block = padded_block;
+            valid = (1ULL << (length - block_start)) - 1;
+        }
+
+        const json_value_masks_t masks = json_scan_values(block);
+        const uint64_t escaped = json_structural_index_escaped(&previous_odd_backslash, masks.backslash);
+        const uint64_t quotes = masks.quote & ~escaped;
+        const uint64_t in_string = json_structural_index_prefix_xor(quotes) ^ previous_in_string;
+        const uint64_t outside = ~in_string;
+
+        previous_in_string = (uint64_t) ((int64_t) in_string >> 63);
+
+        const uint64_t separators = (masks.separator | quotes) & outside;
+        const uint64_t literal_starts = outside & ~(masks.separator | masks.quote) & ((separators << 1) | previous_separator);
+        // The opening quote is inside the string, but not the closing one
+        const uint64_t content = in_string & ~quotes & valid;
+        const uint64_t escape_characters = (masks.backslash | escaped) & content;
+        const uint64_t colons = masks.colon & outside;
+
+        previous_separator = separators >> 63;
+
+        if (colons != 0) {
+            const size_t last_colon = 63 - (size_t) __builtin_clzll(colons);
+            const uint64_t before_colon = (1ULL << last_colon) - 1;
+
+            counts->last_colon = block_start + last_colon;
+            // No escape sequence is open outside of strings
+            counts->string_bytes_at_last_colon = (
+                doubled_string_bytes
+                + 2 * (size_t) __builtin_popcountll(content & before_colon)
+                - (size_t) __builtin_popcountll(escape_characters & before_colon)
+            ) / 2;
+        }
+
+        counts->values += (size_t) __builtin_popcountll(masks.open & outside)
+            + (size_t) __builtin_popcountll(quotes & in_string)
+            + (size_t) __builtin_popcountll(literal_starts & valid)
+        ;
+        counts->keys += (size_t) __builtin_popcountll(colons);
+        doubled_string_bytes += 2 * (size_t) __builtin_popcountll(content) - (size_t) __builtin_popcountll(escape_characters);
+    }
+
+    counts->string_bytes = doubled_string_bytes / 2;
+}
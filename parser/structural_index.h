@@ -0,0 +1,156 @@
+#ifndef JSON_STRUCTURAL_INDEX_H
+#define JSON_STRUCTURAL_INDEX_H
+
+/**
+ * First stage of the indexed parser: locate the structural characters of a JSON input.
+ * This header is not part of the public API.
+ *
+ * The indexed characters are, outside of strings:
+ * - the structural characters { } [ ] : ,
+ * - the opening and closing quotes of strings
+ * - the first character of each literal or number, i.e. a non-whitespace character following a whitespace,
+ *   a structural character or a closing quote
+ *
+ * So any non-indexed character outside of strings is either a whitespace, or the continuation of a literal.
+ *
+ * The input is indexed lazily, by windows of JSON_STRUCTURAL_INDEX_WINDOW_SIZE bytes,
+ * so the index has a fixed size whatever the input length is.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define JSON_STRUCTURAL_INDEX_WINDOW_SIZE 4096
+
+typedef struct {
+    const char* json;
+    size_t length;
+
+    /**
+     * Absolute position of the first byte of the current window
+     */
+    size_t window_start;
+
+    /**
+     * Absolute position of the first byte after the current window
+     */
+    size_t window_end;
+
+    /**
+     * Number of indexed positions in the current window
+     */
+    size_t count;
+
+    /**
+     * Index of the next position to read in the current window
+     */
+    size_t cursor;
+
+    /**
+     * 1 if the previous block ends with an odd sequence of backslashes, so the first character of the next block is escaped
+     */
+    uint64_t previous_odd_backslash;
+
+    /**
+     * All bits set if the previous block ends inside a string
+     */
+    uint64_t previous_in_string;
+
+    /**
+     * 1 if the last character of the previous block is a separator (whitespace, structural character or closing quote)
+     */
+    uint64_t previous_separator;
+
+    /**
+     * The indexed positions of the current window, relative to window_start
+     */
+    uint32_t positions[JSON_STRUCTURAL_INDEX_WINDOW_SIZE];
+} json_structural_index_t;
+
+/**
+ * Initialize the index on the given input. No character is indexed until the first call to `json_structural_index_next()`.
+ */
+void json_structural_index_init(json_structural_index_t* index, size_t length, const char json[length]);
+
+/**
+ * Get the first indexed position greater than or equal to the given position.
+ * Positions must be requested in increasing order, as the previous windows are discarded.
+ *
+ * @return The found position, or the input length if there is no more indexed character.
+ */
+size_t json_structural_index_next(json_structural_index_t* index, size_t position);
+
+/**
+ * Find the commas separating the elements of the root array or object, i.e. the commas at depth 1, outside of strings.
+ * Used to split the elements of a large document in chunks, without indexing every structural character.
+ * The input is not validated: brackets are only counted, and the scan stops when the root value is closed.
+ *
+ * @param split_count The number of commas to find
+ * @param targets For each comma to find, the minimal position of the comma, in increasing order
+ * @param positions Receive the position of the first comma at depth 1 after each target
+ * @param separator_counts Receive the number of commas at depth 1 up to each found comma, included
+ * @return The number of found commas
+ */
+size_t json_structural_index_split(size_t length, const char json[length], size_t split_count, const size_t targets[split_count], size_t positions[split_count], size_t separator_counts[split_count]);
+
+/**
+ * State of `json_structural_index_skip()`, kept between the chunks of an input.
+ */
+typedef struct {
+    /**
+     * Number of structures not closed yet. Set it to 1 to skip the structure which has just been opened.
+     */
+    size_t depth;
+
+    uint64_t previous_odd_backslash;
+    uint64_t previous_in_string;
+} json_structural_skip_t;
+
+/**
+ * Skip the content of a structure by counting brackets outside of strings, without checking anything else.
+ * The input can be given by chunks: when the structure is not closed at the end of a chunk, call again with the next chunk
+ * and the same state.
+ *
+ * @param skip The skip state, starting after the opening bracket of the structure to skip.
+ * @param position The position of the first character to skip.
+ * @return The position after the bracket closing the structure, or length if the structure is not closed yet (depth is not 0).
+ */
+size_t json_structural_index_skip(json_structural_skip_t* skip, size_t length, const char json[length], size_t position);
+
+/**
+ * Counters computed by `json_structural_index_count()`.
+ */
+typedef struct {
+    /**
+     * Number of opening brackets, strings (including keys) and literals
+     */
+    size_t values;
+
+    /**
+     * Number of colons, i.e. object keys
+     */
+    size_t keys;
+
+    /**
+     * Number of bytes of the strings once decoded, i.e. their raw content without the escape backslashes
+     */
+    size_t string_bytes;
+
+    /**
+     * Position of the last colon, or length if there is none
+     */
+    size_t last_colon;
+
+    /**
+     * Value of string_bytes at the last colon, so including the last key
+     */
+    size_t string_bytes_at_last_colon;
+} json_structural_counts_t;
+
+/**
+ * Count the values, keys and string bytes of the input without indexing it, using only population counts on each block.
+ * The input must start outside of a string, and is not validated: a value is any token start, and nesting is not tracked.
+ */
+void json_structural_index_count(size_t length, const char json[length], json_structural_counts_t* counts);
+
+#endif //JSON_STRUCTURAL_INDEX_H
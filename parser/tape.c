@@ -0,0 +1,219 @@
+#include "tape.h"
+
+#include <string.h>
+
+#include "../type/factory.h"
+
+/**
+ * The tape is written by an instance of the parser template, whose events append words to the tape.
+ * While an array or object is open, the payload of its start word holds the index of the enclosing container instead
+ * of the index of its end word, so no stack is needed.
+ */
+
+#define JSON_TAPE_NO_CONTAINER UINT32_MAX
+
+typedef struct {
+    json_tape_t* tape;
+
+    /**
+     * Index of the start word of the innermost open container, or JSON_TAPE_NO_CONTAINER at the root level
+     */
+    size_t open;
+} json_tape_builder_t;
+
+static inline uint64_t json_tape_word(const json_tape_type_t type, const uint64_t payload) {
+    return (uint64_t) type << 56 | payload;
+}
+
+static inline json_parser_result_t json_tape_push(json_tape_builder_t* builder, const json_tape_type_t type, const uint64_t payload, const json_parse_context_t context) {
+    json_tape_t* tape = builder->tape;
+
+    if (tape->used >= tape->size) {
+        return (json_parser_result_t) { JSON_PARSE_HANDLER_ERROR, context, JSON_ERROR_OUT_OF_MEMORY };
+    }
+
+    tape->words[tape->used++] = json_tape_word(type, payload);
+
+    return json_create_success_result();
+}
+
+/**
+ * Increment the count of elements of the innermost open container, if it is of the given type
+ */
+static inline void json_tape_count_element(json_tape_builder_t* builder, const json_tape_type_t container_type) {
+    if (builder->open == JSON_TAPE_NO_CONTAINER) {
+        return;
+    }
+
+    uint64_t* word = &builder->tape->words[builder->open];
+
+    if ((json_tape_type_t) (*word >> 56) == container_type && (*word & JSON_TAPE_PAYLOAD_MASK) >> 32 < JSON_TAPE_MAX_COUNT) {
+        *word += (uint64_t) 1 << 32;
+    }
+}
+
+static inline json_parser_result_t json_tape_add_value(json_tape_builder_t* builder, const json_tape_type_t type, const uint64_t payload, const json_parse_context_t context) {
+    json_tape_count_element(builder, JSON_TAPE_ARRAY_START);
+
+    return json_tape_push(builder, type, payload, context);
+}
+
+static json_parser_result_t json_tape_add_number(json_tape_builder_t* builder, const json_tape_type_t type, const json_tape_number_t value) {
+    json_tape_t* tape = builder->tape;
+
+    if (tape->numbers_used >= tape->numbers_size) {
+        return (json_parser_result_t) { JSON_PARSE_HANDLER_ERROR, JSON_CONTEXT_NUMBER, JSON_ERROR_OUT_OF_MEMORY };
+    }
+
+    tape->numbers[tape->numbers_used] = value;
+
+    return json_tape_add_value(builder, type, tape->numbers_used++, JSON_CONTEXT_NUMBER);
+}
+
+/**
+ * Decode the raw string in the string buffer, and append its word to the tape
+ */
+static json_parser_result_t json_tape_add_string(json_tape_builder_t* builder, const json_raw_string_t value, const bool is_property_key) {
+    json_tape_t* tape = builder->tape;
+    const json_parse_context_t context = is_property_key ? JSON_CONTEXT_OBJECT_PROPERTY : JSON_CONTEXT_STRING;
+    const size_t offset = tape->strings_used;
+    constexpr size_t overhead = sizeof(uint32_t) + 1;
+
+    if (tape->strings_size - offset < overhead) {
+        return (json_parser_result_t) { JSON_PARSE_HANDLER_ERROR, context, JSON_ERROR_OUT_OF_MEMORY };
+    }
+
+    char* characters = tape->strings + offset + sizeof(uint32_t);
+    const ssize_t length = json_decode_raw_string(value.value, value.length, characters, tape->strings_size - offset - overhead);
+
+    if (length < 0) {
+        return (json_parser_result_t) { JSON_PARSE_HANDLER_ERROR, context, JSON_ERROR_OUT_OF_MEMORY };
+    }
+
+    const uint32_t length_prefix = (uint32_t) length;
+    memcpy(tape->strings + offset, &length_prefix, sizeof(length_prefix));
+    characters[length] = '\0';
+    tape->strings_used = offset + overhead + (size_t) length;
+
+    if (is_property_key) {
+        json_tape_count_element(builder, JSON_TAPE_OBJECT_START);
+
+        return json_tape_push(builder, JSON_TAPE_STRING, offset, context);
+    }
+
+    return json_tape_add_value(builder, JSON_TAPE_STRING, offset, context);
+}
+
+static json_parser_result_t json_tape_start(json_tape_builder_t* builder, const json_tape_type_t type, const json_parse_context_t context) {
+    const size_t index = builder->tape->used;
+    const json_parser_result_t result = json_tape_add_value(builder, type, builder->open, context);
+
+    if (result.code == JSON_PARSE_SUCCESS) {
+        builder->open = index;
+    }
+
+    return result;
+}
+
+static json_parser_result_t json_tape_end(json_tape_builder_t* builder, const json_tape_type_t start_type, const json_tape_type_t end_type, const json_parse_context_t context) {
+    const size_t start = builder->open;
+    const size_t end = builder->tape->used;
+    const uint64_t start_payload = builder->tape->words[start] & JSON_TAPE_PAYLOAD_MASK;
+    const json_parser_result_t result = json_tape_push(builder, end_type, start, context);
+
+    if (result.code != JSON_PARSE_SUCCESS) {
+        return result;
+    }
+
+    // Replace the link to the enclosing container by the index of the end word, and keep the count
+    builder->tape->words[start] = json_tape_word(start_type, (start_payload & ~(uint64_t) UINT32_MAX) | end);
+    builder->open = start_payload & UINT32_MAX;
+
+    return result;
+}
+
+#define JSON_PARSER_NAME json_tape_parse
+#define JSON_PARSER_HANDLER_TYPE json_tape_builder_t
+#define JSON_PARSER_ON_NULL(builder) json_tape_add_value(builder, JSON_TAPE_NULL, 0, JSON_CONTEXT_NULL)
+#define JSON_PARSER_ON_BOOL(builder, value) json_tape_add_value(builder, (value) ? JSON_TAPE_TRUE : JSON_TAPE_FALSE, 0, JSON_CONTEXT_BOOL)
+#define JSON_PARSER_ON_NUMBER(builder, value) json_tape_add_number(builder, JSON_TAPE_NUMBER, (json_tape_number_t) { .number_value = (value) })
+#define JSON_PARSER_ON_STRING(builder, value) json_tape_add_string(builder, value, false)
+#define JSON_PARSER_ON_ARRAY_START(builder) json_tape_start(builder, JSON_TAPE_ARRAY_START, JSON_CONTEXT_ARRAY)
+#define JSON_PARSER_ON_ARRAY_END(builder) json_tape_end(builder, JSON_TAPE_ARRAY_START, JSON_TAPE_ARRAY_END, JSON_CONTEXT_ARRAY)
+#define JSON_PARSER_ON_OBJECT_START(builder) json_tape_start(builder, JSON_TAPE_OBJECT_START, JSON_CONTEXT_OBJECT)
+#define JSON_PARSER_ON_OBJECT_PROPERTY(builder, key) json_tape_add_string(builder, key, true)
+#define JSON_PARSER_ON_OBJECT_END(builder) json_tape_end(builder, JSON_TAPE_OBJECT_START, JSON_TAPE_OBJECT_END, JSON_CONTEXT_OBJECT)
+#define JSON_PARSER_ON_INTEGER(builder, value) json_tape_add_number(builder, JSON_TAPE_INTEGER, (json_tape_number_t) { .integer_value = (value) })
+#include "parser_template.h"
+
+json_parser_result_t json_tape_init(json_tape_t* tape, const size_t size, uint64_t words[size], const size_t strings_size, char strings[strings_size], const size_t numbers_size, json_tape_number_t numbers[numbers_size]) {
+    if (tape == nullptr || words == nullptr || strings == nullptr || numbers == nullptr) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    *tape = (json_tape_t) {
+        .words = words,
+        // Container words store indexes on 32 bits
+        .size = size > UINT32_MAX - 1 ? UINT32_MAX - 1 : size,
+        .used = 0,
+        .strings = strings,
+        .strings_size = strings_size,
+        .strings_used = 0,
+        .numbers = numbers,
+        .numbers_size = numbers_size,
+        .numbers_used = 0,
+    };
+
+    return json_create_success_result();
+}
+
+json_parser_result_t json_parse_to_tape(const size_t length, const char json[length], json_tape_t* tape, const json_parser_options_t options) {
+    if (tape == nullptr) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 };
+    }
+
+    tape->used = 0;
+    tape->strings_used = 0;
+    tape->numbers_used = 0;
+
+    json_tape_builder_t builder = {
+        .tape = tape,
+        .open = JSON_TAPE_NO_CONTAINER,
+    };
+
+    return json_tape_parse(length, json, &builder, options);
+}
+
+size_t json_tape_object_get(const json_tape_t* tape, const size_t index, const char* key, const size_t key_length) {
+    if (json_tape_type(tape, index) != JSON_TAPE_OBJECT_START) {
+        return 0;
+    }
+
+    for (size_t key_index = index + 1; json_tape_type(tape, key_index) != JSON_TAPE_OBJECT_END; key_index = json_tape_next(tape, key_index + 1)) {
+        const json_string_t property = json_tape_string(tape, key_index);
+
+        if (property.length == key_length && memcmp(property.value, key, key_length) == 0) {
+            return key_index + 1;
+        }
+    }
+
+    return 0;
+}
+
+size_t json_tape_array_get(const json_tape_t* tape, const size_t index, const size_t position) {
+    if (json_tape_type(tape, index) != JSON_TAPE_ARRAY_START) {
+        return 0;
+    }
+
+    size_t element = index + 1;
+
+    for (size_t i = 0; i < position; ++i) {
+        if (json_tape_type(tape, element) == JSON_TAPE_ARRAY_END) {
+            return 0;
+        }
+
+        element = json_tape_next(tape, element);
+    }
+
+    return json_tape_type(tape, element) == JSON_TAPE_ARRAY_END ? 0 : element;
+}
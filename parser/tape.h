@@ -0,0 +1,200 @@
+#ifndef JSON_TAPE_H
+#define JSON_TAPE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../type/types.h"
+#include "parser.h"
+
+/**
+ * Number of tape words needed to parse any document of the given length.
+ * Each value is at least one character long, and each array or object takes two words and two characters.
+ */
+#define JSON_TAPE_SIZE(length) ((length) + 1)
+
+/**
+ * Number of bytes of the string buffer needed to parse any document of the given length.
+ * Each string or key is stored with a 4 bytes length prefix and a null terminator, instead of its two quotes.
+ */
+#define JSON_TAPE_STRINGS_SIZE(length) ((length) / 2 * 5 + 5)
+
+/**
+ * Number of entries of the number buffer needed to parse any document of the given length.
+ */
+#define JSON_TAPE_NUMBERS_SIZE(length) ((length) / 2 + 1)
+
+/**
+ * Mask of the payload of a tape word, the type is stored in the 8 upper bits.
+ */
+#define JSON_TAPE_PAYLOAD_MASK 0x00FFFFFFFFFFFFFFULL
+
+/**
+ * Maximal count of elements stored in a container word. Larger containers must be counted by traversing them.
+ */
+#define JSON_TAPE_MAX_COUNT 0xFFFFFF
+
+typedef enum: uint8_t {
+    JSON_TAPE_NULL = 'n',
+    JSON_TAPE_TRUE = 't',
+    JSON_TAPE_FALSE = 'f',
+
+    /**
+     * The payload is the index of the value in the number buffer
+     */
+    JSON_TAPE_NUMBER = 'd',
+
+    /**
+     * The payload is the index of the value in the number buffer
+     */
+    JSON_TAPE_INTEGER = 'l',
+
+    /**
+     * A string value, or an object key. The payload is the offset of the length prefix in the string buffer.
+     */
+    JSON_TAPE_STRING = '"',
+
+    /**
+     * The payload is the index of the matching end word in the 32 lower bits, and the count of elements in the 24 upper bits
+     */
+    JSON_TAPE_ARRAY_START = '[',
+
+    /**
+     * The payload is the index of the matching start word
+     */
+    JSON_TAPE_ARRAY_END = ']',
+
+    /**
+     * Same as arrays. The elements are the properties: each one is a key string word followed by the value words.
+     */
+    JSON_TAPE_OBJECT_START = '{',
+    JSON_TAPE_OBJECT_END = '}',
+} json_tape_type_t;
+
+typedef union {
+    double number_value;
+    int64_t integer_value;
+} json_tape_number_t;
+
+/**
+ * Flat representation of a JSON document: each value is a 64-bit word in the tape, in document order.
+ * Arrays and objects are stored as a start word, the words of their elements, and an end word.
+ *
+ * All the buffers are provided by the caller, and can be reused between documents.
+ * The root value is at index 0.
+ */
+typedef struct {
+    uint64_t* words;
+    size_t size;
+    size_t used;
+
+    /**
+     * The decoded strings and keys, each one stored as a 4 bytes length, the characters, and a null terminator
+     */
+    char* strings;
+    size_t strings_size;
+    size_t strings_used;
+
+    /**
+     * The numbers, stored as double or int64_t depending on the type of the tape word
+     */
+    json_tape_number_t* numbers;
+    size_t numbers_size;
+    size_t numbers_used;
+} json_tape_t;
+
+/**
+ * Initialize the tape with the buffers provided by the caller.
+ * Use `JSON_TAPE_SIZE()`, `JSON_TAPE_STRINGS_SIZE()` and `JSON_TAPE_NUMBERS_SIZE()` to get sizes large enough for any
+ * document of a given length.
+ */
+json_parser_result_t json_tape_init(json_tape_t* tape, size_t size, uint64_t words[size], size_t strings_size, char strings[strings_size], size_t numbers_size, json_tape_number_t numbers[numbers_size]);
+
+/**
+ * Parse the JSON document into the tape. The previous content of the tape is discarded.
+ * If a buffer of the tape is too small, `JSON_PARSE_HANDLER_ERROR` is returned with `JSON_ERROR_OUT_OF_MEMORY`.
+ *
+ * Strings are decoded like `json_parse_value()` does, and do not reference the input.
+ */
+json_parser_result_t json_parse_to_tape(size_t length, const char json[length], json_tape_t* tape, json_parser_options_t options);
+
+static inline json_tape_type_t json_tape_type(const json_tape_t* tape, const size_t index) {
+    return (json_tape_type_t) (tape->words[index] >> 56);
+}
+
+static inline uint64_t json_tape_payload(const json_tape_t* tape, const size_t index) {
+    return tape->words[index] & JSON_TAPE_PAYLOAD_MASK;
+}
+
+/**
+ * Get the index of the value following the one at the given index, skipping the content of arrays and objects.
+ * On the last element of a container, the returned index is the end word of the container.
+ */
+static inline size_t json_tape_next(const json_tape_t* tape, const size_t index) {
+    const json_tape_type_t type = json_tape_type(tape, index);
+
+    if (type == JSON_TAPE_ARRAY_START || type == JSON_TAPE_OBJECT_START) {
+        return (size_t) (json_tape_payload(tape, index) & UINT32_MAX) + 1;
+    }
+
+    return index + 1;
+}
+
+/**
+ * Get the count of elements of the array, or properties of the object, at the given index.
+ * The count is saturated to `JSON_TAPE_MAX_COUNT`.
+ */
+static inline size_t json_tape_count(const json_tape_t* tape, const size_t index) {
+    return (size_t) (json_tape_payload(tape, index) >> 32);
+}
+
+static inline bool json_tape_bool(const json_tape_t* tape, const size_t index) {
+    return json_tape_type(tape, index) == JSON_TAPE_TRUE;
+}
+
+/**
+ * Get the number at the given index, integers are converted to double
+ */
+static inline double json_tape_number(const json_tape_t* tape, const size_t index) {
+    const size_t number_index = (size_t) json_tape_payload(tape, index);
+
+    return json_tape_type(tape, index) == JSON_TAPE_INTEGER
+        ? (double) tape->numbers[number_index].integer_value
+        : tape->numbers[number_index].number_value
+    ;
+}
+
+static inline int64_t json_tape_integer(const json_tape_t* tape, const size_t index) {
+    return tape->numbers[json_tape_payload(tape, index)].integer_value;
+}
+
+/**
+ * Get the decoded string or key at the given index. The value is null-terminated.
+ */
+static inline json_string_t json_tape_string(const json_tape_t* tape, const size_t index) {
+    char* length_prefix = tape->strings + json_tape_payload(tape, index);
+    uint32_t length;
+    memcpy(&length, length_prefix, sizeof(length));
+
+    return (json_string_t) {
+        .length = length,
+        .value = length_prefix + sizeof(length),
+    };
+}
+
+/**
+ * Find the value of a property of the object at the given index.
+ *
+ * @return The index of the value, or 0 if the property is not found. As the root value is at index 0, it cannot be a property value.
+ */
+size_t json_tape_object_get(const json_tape_t* tape, size_t index, const char* key, size_t key_length);
+
+/**
+ * Get the element of the array at the given index.
+ *
+ * @return The index of the element, or 0 if the position is out of bounds.
+ */
+size_t json_tape_array_get(const json_tape_t* tape, size_t index, size_t position);
+
+#endif //JSON_TAPE_H
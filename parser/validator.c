@@ -0,0 +1,412 @@
+#include "parser.h"
+
+#include <string.h>
+
+#include "parser_internal.h"
+#include "scanner.h"
+
+/**
+ * Validator behind `json_validate()`.
+ *
+ * It walks the input once without recursion, and keeps one 32-bit word per open structure:
+ * the highest bit tells if the structure is an object, and the other bits count its elements and separators,
+ * so the depth and size limits are the same as `json_parse()`.
+ */
+
+#define JSON_VALIDATOR_OBJECT_BIT ((uint32_t) 1 << 31)
+
+typedef struct {
+    const char* json;
+    size_t length;
+    size_t position;
+    json_parser_options_t options;
+} json_validator_t;
+
+static inline json_parser_result_t json_validator_error(const json_parse_code_t code, const json_parse_context_t context, const json_parse_error_t error, const uint8_t extra, const size_t position) {
+    return (json_parser_result_t) { code, context, error, extra, position };
+}
+
+static inline bool json_validator_skip_whitespace(json_validator_t* validator) {
+    validator->position = json_scan_whitespace(validator->json, validator->position, validator->length);
+
+    return validator->position < validator->length;
+}
+
+static inline bool json_validator_is_hex_digit(const char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+/**
+ * Check the escape sequence at the current position (backslash), and move the position after it
+ */
+static json_parser_result_t json_validator_escape(json_validator_t* validator, const size_t end, const json_parse_context_t context) {
+    const size_t position = validator->position;
+
+    if (position + 1 >= end) {
+        validator->position = end;
+        return json_create_success_result();
+    }
+
+    switch (validator->json[position + 1]) {
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+            validator->position += 2;
+            return json_create_success_result();
+
+        case 'u':
+            for (size_t i = position + 2; i < position + 6; ++i) {
+                if (i >= end) {
+                    validator->position = end;
+                    return json_create_success_result();
+                }
+
+                if (!json_validator_is_hex_digit(validator->json[i])) {
+                    return json_validator_error(JSON_PARSE_ERROR_INVALID_SYNTAX, context, JSON_ERROR_UNEXPECTED_CHARACTER, 0, i);
+                }
+            }
+
+            validator->position += 6;
+            return json_create_success_result();
+
+        default:
+            return json_validator_error(JSON_PARSE_ERROR_INVALID_SYNTAX, context, JSON_ERROR_UNEXPECTED_CHARACTER, 0, position + 1);
+    }
+}
+
+/**
+ * Check the string at the current position (opening quote), and move the position after the closing quote
+ */
+static json_parser_result_t json_validator_string(json_validator_t* validator, const json_parse_context_t context) {
+    const char* json = validator->json;
+    const size_t start = validator->position++;
+    const size_t end = validator->length - start > validator->options.max_string_size
+        ? start + validator->options.max_string_size
+        : validator->length
+    ;
+
+    while (validator->position < end) {
+        validator->position = json_scan_string_utf8(json, validator->position, end);
+
+        if (validator->position >= end) {
+            break;
+        }
+
+        const unsigned char current_char = (unsigned char) json[validator->position];
+
+        if (current_char == '"') {
+            ++validator->position;
+            return json_create_success_result();
+        }
+
+        if (current_char == '\\') {
+            const json_parser_result_t escape_result = json_validator_escape(validator, end, context);
+
+            if (escape_result.code != JSON_PARSE_SUCCESS) {
+                return escape_result;
+            }
+
+            continue;
+        }
+
+        if (current_char < 0x20) {
+            return json_validator_error(JSON_PARSE_ERROR_INVALID_SYNTAX, context, JSON_ERROR_UNEXPECTED_CHARACTER, current_char, validator->position);
+        }
+
+        // The sequence is invalid, or only truncated by the max string size: check it against the whole input
+        const size_t sequence_length = json_utf8_sequence_length(json, validator->position, validator->length);
+
+        if (sequence_length == 0) {
+            return json_validator_error(JSON_PARSE_ERROR_INVALID_SYNTAX, context, JSON_ERROR_INVALID_UTF8, 0, validator->position);
+        }
+
+        validator->position += sequence_length;
+    }
+
+    if (end < validator->length) {
+        return json_validator_error(JSON_PARSE_ERROR_MAX_STRING_SIZE, context, JSON_ERROR_UNKNOWN, 0, end);
+    }
+
+    validator->position = validator->length;
+
+    return json_validator_error(JSON_PARSE_ERROR_UNEXPECTED_END, context, JSON_ERROR_MISSING_CLOSING_CHARACTER, '"', validator->length);
+}
+
+static inline size_t json_validator_skip_digits(const char* json, const size_t length, size_t position) {
+    while (position < length && json[position] >= '0' && json[position] <= '9') {
+        ++position;
+    }
+
+    return position;
+}
+
+/**
+ * Check the number grammar at the current position, without computing its value
+ */
+static json_parser_result_t json_validator_number(json_validator_t* validator) {
+    const char* json = validator->json;
+    const size_t length = validator->length;
+    size_t position = validator->position;
+
+    if (json[position] == '-') {
+        ++position;
+    }
+
+    if (position >= length) {
+        return json_validator_error(JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_NUMBER, JSON_ERROR_TOO_SMALL, 0, position);
+    }
+
+    if (json[position] == '0') {
+        ++position;
+    } else if (json[position] >= '1' && json[position] <= '9') {
+        position = json_validator_skip_digits(json, length, position + 1);
+    } else {
+        return json_validator_error(JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_NUMBER, JSON_ERROR_UNEXPECTED_CHARACTER, 0, position);
+    }
+
+    if (position < length && json[position] == '.') {
+        const size_t fraction_start = ++position;
+        position = json_validator_skip_digits(json, length, position);
+
+        if (position == fraction_start) {
+            return position >= length
+                ? json_validator_error(JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_NUMBER, JSON_ERROR_TOO_SMALL, 0, position)
+                : json_validator_error(JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_NUMBER, JSON_ERROR_UNEXPECTED_CHARACTER, 0, position)
+            ;
+        }
+    }
+
+    if (position < length && (json[position] == 'e' || json[position] == 'E')) {
+        ++position;
+
+        if (position < length && (json[position] == '+' || json[position] == '-')) {
+            ++position;
+        }
+
+        const size_t exponent_start = position;
+        position = json_validator_skip_digits(json, length, position);
+
+        if (position == exponent_start) {
+            return position >= length
+                ? json_validator_error(JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_NUMBER, JSON_ERROR_TOO_SMALL, 0, position)
+                : json_validator_error(JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_NUMBER, JSON_ERROR_UNEXPECTED_CHARACTER, 0, position)
+            ;
+        }
+    }
+
+    validator->position = position;
+
+    return json_create_success_result();
+}
+
+static json_parser_result_t json_validator_literal(json_validator_t* validator, const char* literal, const size_t literal_length, const json_parse_context_t context) {
+    if (validator->length - validator->position < literal_length) {
+        return json_validator_error(JSON_PARSE_ERROR_UNEXPECTED_END, context, JSON_ERROR_TOO_SMALL, (uint8_t) literal_length, validator->position);
+    }
+
+    if (memcmp(validator->json + validator->position, literal, literal_length) != 0) {
+        return json_validator_error(JSON_PARSE_ERROR_INVALID_SYNTAX, context, JSON_ERROR_UNEXPECTED_CHARACTER, 0, validator->position);
+    }
+
+    validator->position += literal_length;
+
+    return json_create_success_result();
+}
+
+/**
+ * Check the scalar value at the current position
+ */
+static json_parser_result_t json_validator_scalar(json_validator_t* validator) {
+    switch (validator->json[validator->position]) {
+        case '"':
+            return json_validator_string(validator, JSON_CONTEXT_STRING);
+
+        case 'n':
+            return json_validator_literal(validator, "null", 4, JSON_CONTEXT_NULL);
+
+        case 't':
+            return json_validator_literal(validator, "true", 4, JSON_CONTEXT_BOOL);
+
+        case 'f':
+            return json_validator_literal(validator, "false", 5, JSON_CONTEXT_BOOL);
+
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            return json_validator_number(validator);
+
+        default:
+            return json_validator_error(JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNEXPECTED_CHARACTER, 0, validator->position);
+    }
+}
+
+/**
+ * Count an element or a separator in the structure, and check the max struct size
+ */
+static inline bool json_validator_count(uint32_t* structure, const size_t max_struct_size) {
+    if ((*structure & ~JSON_VALIDATOR_OBJECT_BIT) >= max_struct_size) {
+        return false;
+    }
+
+    ++*structure;
+
+    return true;
+}
+
+static json_parser_result_t json_validator_run(json_validator_t* validator, const size_t stack_size, uint32_t stack[stack_size]) {
+    const char* json = validator->json;
+    const json_parser_options_t options = validator->options;
+    size_t stack_used = 0;
+
+    for (;;) {
+        // A value is expected
+        // Like json_parse(), a value inside N structures is at depth 2N, and its content at depth 2N + 1
+        if (2 * stack_used + 1 > options.max_depth) {
+            return json_validator_error(JSON_PARSE_ERROR_MAX_DEPTH, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNKNOWN, 0, validator->position);
+        }
+
+        if (!json_validator_skip_whitespace(validator)) {
+            return json_validator_error(JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_UNKNOWN, JSON_ERROR_EMPTY_VALUE, 0, validator->position);
+        }
+
+        const char value_char = json[validator->position];
+        bool value_complete = true;
+
+        if (value_char == '[' || value_char == '{') {
+            const bool is_object = value_char == '{';
+
+            if (stack_used >= stack_size) {
+                return json_validator_error(JSON_PARSE_ERROR_MAX_DEPTH, is_object ? JSON_CONTEXT_OBJECT : JSON_CONTEXT_ARRAY, JSON_ERROR_STACK_OVERFLOW, 0, validator->position);
+            }
+
+            ++validator->position;
+            stack[stack_used++] = is_object ? JSON_VALIDATOR_OBJECT_BIT : 0;
+
+            if (!json_validator_skip_whitespace(validator)) {
+                return json_validator_error(JSON_PARSE_ERROR_UNEXPECTED_END, is_object ? JSON_CONTEXT_OBJECT : JSON_CONTEXT_ARRAY, JSON_ERROR_MISSING_CLOSING_CHARACTER, is_object ? '}' : ']', validator->position);
+            }
+
+            // Empty structure: handled as a complete value below
+            value_complete = json[validator->position] == (is_object ? '}' : ']');
+
+            if (value_complete) {
+                --stack_used;
+                ++validator->position;
+            }
+        } else {
+            const json_parser_result_t scalar_result = json_validator_scalar(validator);
+
+            if (scalar_result.code != JSON_PARSE_SUCCESS) {
+                return scalar_result;
+            }
+        }
+
+        // After a complete value: close the structures, until a separator is found
+        while (value_complete) {
+            if (stack_used == 0) {
+                if (json_validator_skip_whitespace(validator)) {
+                    return json_validator_error(JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNEXPECTED_CHARACTER, 0, validator->position);
+                }
+
+                return json_create_success_result();
+            }
+
+            uint32_t* structure = &stack[stack_used - 1];
+            const bool is_object = (*structure & JSON_VALIDATOR_OBJECT_BIT) != 0;
+            const json_parse_context_t context = is_object ? JSON_CONTEXT_OBJECT : JSON_CONTEXT_ARRAY;
+
+            if (!json_validator_count(structure, options.max_struct_size)) {
+                return json_validator_error(JSON_PARSE_ERROR_MAX_STRUCT_SIZE, context, JSON_ERROR_UNKNOWN, 0, validator->position);
+            }
+
+            if (!json_validator_skip_whitespace(validator)) {
+                return json_validator_error(JSON_PARSE_ERROR_UNEXPECTED_END, context, JSON_ERROR_MISSING_CLOSING_CHARACTER, is_object ? '}' : ']', validator->position);
+            }
+
+            const char current_char = json[validator->position];
+
+            if (current_char == ',') {
+                if (!json_validator_count(structure, options.max_struct_size)) {
+                    return json_validator_error(JSON_PARSE_ERROR_MAX_STRUCT_SIZE, context, JSON_ERROR_UNKNOWN, 0, validator->position);
+                }
+
+                ++validator->position;
+                value_complete = false;
+            } else if (current_char == (is_object ? '}' : ']')) {
+                ++validator->position;
+                --stack_used;
+            } else {
+                return json_validator_error(JSON_PARSE_ERROR_INVALID_SYNTAX, context, JSON_ERROR_UNEXPECTED_CHARACTER, ',', validator->position);
+            }
+        }
+
+        // Inside an object, the next value is preceded by its key
+        if (stack_used > 0 && (stack[stack_used - 1] & JSON_VALIDATOR_OBJECT_BIT) != 0) {
+            if (!json_validator_skip_whitespace(validator)) {
+                return json_validator_error(JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_MISSING_CLOSING_CHARACTER, '}', validator->position);
+            }
+
+            if (json[validator->position] != '"') {
+                return json_validator_error(JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_OBJECT_PROPERTY, JSON_ERROR_UNEXPECTED_CHARACTER, '"', validator->position);
+            }
+
+            const json_parser_result_t key_result = json_validator_string(validator, JSON_CONTEXT_OBJECT_PROPERTY);
+
+            if (key_result.code != JSON_PARSE_SUCCESS) {
+                return key_result;
+            }
+
+            if (!json_validator_skip_whitespace(validator)) {
+                return json_validator_error(JSON_PARSE_ERROR_UNEXPECTED_END, JSON_CONTEXT_OBJECT, JSON_ERROR_MISSING_CLOSING_CHARACTER, ':', validator->position);
+            }
+
+            if (json[validator->position] != ':') {
+                return json_validator_error(JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_CONTEXT_OBJECT, JSON_ERROR_UNEXPECTED_CHARACTER, ':', validator->position);
+            }
+
+            ++validator->position;
+        }
+    }
+}
+
+json_parser_result_t json_validate(const size_t length, const char json[length], json_parser_options_t options) {
+    options = json_default_parser_options(options);
+
+    if (json == nullptr || length == 0) {
+        return json_validator_error(JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0);
+    }
+
+    const json_parser_result_t options_result = json_parser_check_options(options);
+
+    if (options_result.code != JSON_PARSE_SUCCESS) {
+        return options_result;
+    }
+
+    // The struct size is stored on 31 bits
+    if (options.max_struct_size > ~JSON_VALIDATOR_OBJECT_BIT) {
+        options.max_struct_size = ~JSON_VALIDATOR_OBJECT_BIT;
+    }
+
+    json_validator_t validator = {
+        .json = json,
+        .length = length,
+        .position = 0,
+        .options = options,
+    };
+    uint32_t stack[JSON_PARSER_STACK_SIZE(options.max_depth)];
+
+    return json_validator_run(&validator, JSON_PARSER_STACK_SIZE(options.max_depth), stack);
+}
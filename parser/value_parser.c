@@ -1,12 +1,35 @@
 #include "value_parser.h"
 
+#include <pthread.h>
 #include <stdio.h>
 
 #include "../type/factory.h"
+#include "parser_internal.h"
+#include "scanner.h"
+#include "structural_index.h"
+
+typedef enum: uint8_t {
+    /**
+     * Decode all the strings into the arena
+     */
+    JSON_VALUE_PARSER_COPY_STRINGS,
+
+    /**
+     * Point the strings without escape sequences into the input, and decode the others into the arena
+     */
+    JSON_VALUE_PARSER_BORROW_STRINGS,
+
+    /**
+     * Point all the strings into the input, decoding the escaped ones in place
+     */
+    JSON_VALUE_PARSER_IN_SITU_STRINGS,
+} json_value_parser_strings_t;
 
 typedef struct {
     json_parser_handler_t callbacks;
     json_arena_t* arena;
+    json_value_parser_strings_t strings;
+
     json_value_t* root;
     size_t stack_size;
     size_t stack_used;
@@ -135,9 +158,42 @@ static json_parser_result_t json_value_parser_handler_on_number(json_parser_hand
     return json_value_parser_push(handler, number_value, JSON_CONTEXT_NUMBER);
 }
 
+static json_parser_result_t json_value_parser_handler_on_integer(json_parser_handler_t* self, const int64_t value) {
+    json_value_parser_handler_t* handler = (json_value_parser_handler_t*) self;
+    json_value_t* integer_value = json_create_integer_value(handler->arena, value);
+
+    if (integer_value == nullptr) {
+        return (json_parser_result_t) { JSON_PARSE_HANDLER_ERROR, JSON_CONTEXT_NUMBER, JSON_ERROR_OUT_OF_MEMORY };
+    }
+
+    return json_value_parser_push(handler, integer_value, JSON_CONTEXT_NUMBER);
+}
+
+/**
+ * Get the decoded content of a string of the input, if it can be used without copying it into the arena.
+ *
+ * @return The length of the content, starting after the opening quote, or -1 if the string must be copied.
+ */
+static ssize_t json_value_parser_input_string(const json_value_parser_handler_t* handler, const json_raw_string_t string) {
+    if (handler->strings == JSON_VALUE_PARSER_COPY_STRINGS || (!string.escape_free && handler->strings != JSON_VALUE_PARSER_IN_SITU_STRINGS)) {
+        return -1;
+    }
+
+    if (string.escape_free) {
+        return (ssize_t) string.length - 2;
+    }
+
+    // The input of an in situ parsing is mutable, and the parser never reads the strings it has already scanned
+    return json_decode_raw_string(string.value, string.length, (char*) string.value + 1, string.length - 2);
+}
+
 static json_parser_result_t json_value_parser_handler_on_string(json_parser_handler_t* self, const json_raw_string_t value) {
     json_value_parser_handler_t* handler = (json_value_parser_handler_t*) self;
-    json_value_t* string_value = json_create_string_value(handler->arena, value.value, value.length);
+    const ssize_t input_length = json_value_parser_input_string(handler, value);
+    json_value_t* string_value = input_length >= 0
+        ? json_create_borrowed_string_value(handler->arena, value.value + 1, (size_t) input_length)
+        : json_create_string_value(handler->arena, value.value, value.length)
+    ;
 
     if (string_value == nullptr) {
         return (json_parser_result_t) { JSON_PARSE_HANDLER_ERROR, JSON_CONTEXT_STRING, JSON_ERROR_OUT_OF_MEMORY };
@@ -175,7 +231,11 @@ static json_parser_result_t json_value_parser_handler_on_object_start(json_parse
 
 static json_parser_result_t json_value_parser_handler_on_object_property(json_parser_handler_t* self, json_raw_string_t key) {
     json_value_parser_handler_t* handler = (json_value_parser_handler_t*) self;
-    json_member_entry_t* new_property = json_create_object_member(handler->arena, key.value, key.length);
+    const ssize_t input_length = json_value_parser_input_string(handler, key);
+    json_member_entry_t* new_property = input_length >= 0
+        ? json_create_borrowed_object_member(handler->arena, key.value + 1, (size_t) input_length)
+        : json_create_object_member(handler->arena, key.value, key.length)
+    ;
 
     if (new_property == nullptr) {
         return (json_parser_result_t) { JSON_PARSE_HANDLER_ERROR, JSON_CONTEXT_OBJECT_PROPERTY, JSON_ERROR_OUT_OF_MEMORY };
@@ -215,6 +275,7 @@ const static json_parser_handler_t p_callbacks = {
     .on_null = json_value_parser_handler_on_null,
     .on_bool = json_value_parser_handler_on_bool,
     .on_number = json_value_parser_handler_on_number,
+    .on_integer = json_value_parser_handler_on_integer,
     .on_string = json_value_parser_handler_on_string,
     .on_array_start = json_value_parser_handler_on_array_start,
     .on_array_end = json_value_parser_handler_on_array_end,
@@ -223,10 +284,11 @@ const static json_parser_handler_t p_callbacks = {
     .on_object_end = json_value_parser_handler_on_object_end,
 };
 
-json_value_parser_result_t json_parse_value(const size_t length, const char json[length], json_arena_t* arena, const size_t stack_size, json_value_t* stack[stack_size], json_parser_options_t options) {
+static json_value_parser_result_t json_value_parser_parse(const size_t length, const char json[length], json_arena_t* arena, const json_value_parser_strings_t strings, const size_t stack_size, json_value_t* stack[stack_size], const json_parser_options_t options) {
     json_value_parser_handler_t handler = {
         .callbacks = p_callbacks,
         .arena = arena,
+        .strings = strings,
         .stack_size = stack_size,
         .stack_used = 0,
         .stack = stack,
@@ -235,7 +297,8 @@ json_value_parser_result_t json_parse_value(const size_t length, const char json
 
     const json_parser_result_t result = json_parse(length, json, &handler.callbacks, options);
 
-    if (handler.root != nullptr) {
+    // Keep the parser error when it occurs before the root value is created, like an unterminated string
+    if (handler.root != nullptr || result.code != JSON_PARSE_SUCCESS) {
         return (json_value_parser_result_t) {
             .result = result,
             .value = handler.root,
@@ -252,10 +315,276 @@ json_value_parser_result_t json_parse_value(const size_t length, const char json
     };
 }
 
+json_value_parser_result_t json_parse_value(const size_t length, const char json[length], json_arena_t* arena, const size_t stack_size, json_value_t* stack[stack_size], const json_parser_options_t options) {
+    return json_value_parser_parse(length, json, arena, JSON_VALUE_PARSER_COPY_STRINGS, stack_size, stack, options);
+}
+
+json_value_parser_result_t json_parse_value_borrowed(const size_t length, const char json[length], json_arena_t* arena, const size_t stack_size, json_value_t* stack[stack_size], const json_parser_options_t options) {
+    return json_value_parser_parse(length, json, arena, JSON_VALUE_PARSER_BORROW_STRINGS, stack_size, stack, options);
+}
+
+json_value_parser_result_t json_parse_value_in_situ(const size_t length, char json[length], json_arena_t* arena, const size_t stack_size, json_value_t* stack[stack_size], const json_parser_options_t options) {
+    return json_value_parser_parse(length, json, arena, JSON_VALUE_PARSER_IN_SITU_STRINGS, stack_size, stack, options);
+}
+
 json_value_parser_result_t json_parse_value_defaults(const size_t length, const char json[length], json_arena_t* arena) {
     constexpr size_t stack_size = 32;
     const json_parser_options_t options = json_default_parser_options((json_parser_options_t) { .max_depth = stack_size });
     json_value_t* stack[stack_size];
 
     return json_parse_value(length, json, arena, stack_size, stack, options);
-}
\ No newline at end of file
+}
+/**
+ * A run of consecutive elements of the root array, parsed by one worker of `json_parse_value_parallel()`.
+ */
+typedef struct {
+    const char* json;
+    size_t length;
+    json_parser_options_t options;
+    json_arena_t* arena;
+    size_t stack_size;
+    json_value_t** stack;
+
+    /**
+     * Position of the first element, just after the opening bracket or a comma
+     */
+    size_t start;
+
+    /**
+     * Position of the comma following the last element, or the input length for the last chunk, which ends on the closing bracket
+     */
+    size_t end;
+
+    /**
+     * Index of the first element in the root array, according to the split
+     */
+    size_t first_index;
+
+    /**
+     * Holds the elements of the chunk. Its length starts at the index of the first element, so the keys are the ones of the root array.
+     */
+    json_value_t elements;
+
+    /**
+     * Number of commas between the elements of the chunk, needed to apply the max struct size like `json_parse()`
+     */
+    size_t separators;
+    bool success;
+} json_value_parser_chunk_t;
+
+static void json_value_parser_parse_chunk(json_value_parser_chunk_t* chunk) {
+    json_value_parser_handler_t handler = {
+        .callbacks = p_callbacks,
+        .arena = chunk->arena,
+        .root = &chunk->elements,
+        .stack_size = chunk->stack_size,
+        .stack_used = 1,
+        .stack = chunk->stack,
+    };
+    const bool last = chunk->end == chunk->length;
+    size_t position = chunk->start;
+
+    chunk->success = false;
+
+    // The root array takes the first entry, like with json_parse_value()
+    if (chunk->stack_size < 1) {
+        return;
+    }
+
+    chunk->stack[0] = &chunk->elements;
+
+    for (;;) {
+        // Elements of the root array are at depth 2, see json_parse()
+        if (json_parse_nested_value(chunk->length, chunk->json, &handler.callbacks, chunk->options, 2, &position).code != JSON_PARSE_SUCCESS) {
+            return;
+        }
+
+        position = json_scan_whitespace(chunk->json, position, chunk->length);
+
+        if (position >= chunk->length || position > chunk->end) {
+            return;
+        }
+
+        if (chunk->json[position] == ']' && last) {
+            break;
+        }
+
+        if (chunk->json[position] != ',') {
+            return;
+        }
+
+        if (position == chunk->end) {
+            break;
+        }
+
+        ++chunk->separators;
+        position = json_scan_whitespace(chunk->json, position + 1, chunk->length);
+
+        // Like json_parse(), a trailing comma is accepted
+        if (last && position < chunk->length && chunk->json[position] == ']') {
+            break;
+        }
+    }
+
+    chunk->success = true;
+}
+
+static void* json_value_parser_run_chunk(void* chunk) {
+    json_value_parser_parse_chunk(chunk);
+
+    return nullptr;
+}
+
+/**
+ * Split the elements of the root array in up to `chunk_count` chunks of similar sizes.
+ * The splits are only a guess on malformed input: they are checked when parsing the chunks.
+ *
+ * @return The number of chunks
+ */
+static size_t json_value_parser_split_chunks(const size_t length, const char json[length], const size_t start, const size_t chunk_count, json_value_parser_chunk_t chunks[chunk_count]) {
+    size_t targets[chunk_count];
+    size_t positions[chunk_count];
+    size_t separator_counts[chunk_count];
+
+    for (size_t i = 0; i + 1 < chunk_count; ++i) {
+        targets[i] = (i + 1) * (length / chunk_count);
+    }
+
+    const size_t split_count = json_structural_index_split(length, json, chunk_count - 1, targets, positions, separator_counts);
+
+    chunks[0].start = start;
+    chunks[0].first_index = 0;
+
+    for (size_t i = 0; i < split_count; ++i) {
+        chunks[i].end = positions[i];
+        chunks[i + 1].start = positions[i] + 1;
+        chunks[i + 1].first_index = separator_counts[i];
+    }
+
+    chunks[split_count].end = length;
+
+    return split_count + 1;
+}
+
+json_value_parser_result_t json_parse_value_parallel(
+    const size_t length,
+    const char json[length],
+    const size_t worker_count,
+    json_arena_t* arenas[worker_count],
+    const size_t stack_size,
+    json_value_t* stacks[JSON_VALUE_PARSER_STACKS_SIZE(worker_count, stack_size)],
+    json_parser_options_t options
+) {
+    options = json_default_parser_options(options);
+
+    if (arenas == nullptr || worker_count == 0 || arenas[0] == nullptr || (stacks == nullptr && stack_size > 0)) {
+        return (json_value_parser_result_t) {
+            .result = { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 },
+            .value = nullptr,
+        };
+    }
+
+    const json_parser_result_t options_result = json_parser_check_options(options);
+
+    if (options_result.code != JSON_PARSE_SUCCESS) {
+        return (json_value_parser_result_t) {
+            .result = options_result,
+            .value = nullptr,
+        };
+    }
+
+    const size_t start = json == nullptr ? length : json_scan_whitespace(json, 0, length);
+
+    // Only a root array with several elements can be split: parse other documents on a single thread
+    if (worker_count < 2 || start >= length || json[start] != '[' || options.max_depth < 2) {
+        return json_parse_value(length, json, arenas[0], stack_size, stacks, options);
+    }
+
+    for (size_t worker = 1; worker < worker_count; ++worker) {
+        if (arenas[worker] == nullptr) {
+            return (json_value_parser_result_t) {
+                .result = { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_NULL_POINTER, 0, 0 },
+                .value = nullptr,
+            };
+        }
+    }
+
+    json_value_parser_chunk_t chunks[worker_count];
+    const size_t chunk_count = json_value_parser_split_chunks(length, json, start + 1, worker_count, chunks);
+    const json_arena_mark_t initial_mark = json_arena_mark(arenas[0]);
+    json_value_t* root = json_create_empty_array(arenas[0]);
+
+    if (chunk_count < 2 || root == nullptr) {
+        json_arena_rollback(arenas[0], initial_mark);
+
+        return json_parse_value(length, json, arenas[0], stack_size, stacks, options);
+    }
+
+    pthread_t threads[chunk_count];
+    bool started[chunk_count];
+    json_arena_mark_t initial_marks[chunk_count];
+
+    for (size_t i = 0; i < chunk_count; ++i) {
+        chunks[i].json = json;
+        chunks[i].length = length;
+        chunks[i].options = options;
+        chunks[i].arena = arenas[i];
+        chunks[i].stack_size = stack_size;
+        chunks[i].stack = stacks + i * stack_size;
+        chunks[i].elements.type = JSON_ARRAY;
+        chunks[i].elements.array_value.length = chunks[i].first_index;
+        chunks[i].elements.array_value.head = nullptr;
+        chunks[i].elements.array_value.tail = nullptr;
+        chunks[i].separators = 0;
+        initial_marks[i] = json_arena_mark(arenas[i]);
+
+        // If a thread cannot be started, the chunk is parsed by the calling thread
+        started[i] = i > 0 && pthread_create(&threads[i], nullptr, json_value_parser_run_chunk, &chunks[i]) == 0;
+    }
+
+    for (size_t i = 0; i < chunk_count; ++i) {
+        if (started[i]) {
+            pthread_join(threads[i], nullptr);
+        } else {
+            json_value_parser_parse_chunk(&chunks[i]);
+        }
+    }
+
+    // Link the elements of the chunks, after checking that each chunk starts where the previous one ended
+    json_array_t* elements = &root->array_value;
+    size_t separators = chunk_count - 1;
+    bool success = true;
+
+    for (size_t i = 0; i < chunk_count && success; ++i) {
+        const json_array_t* chunk_elements = &chunks[i].elements.array_value;
+
+        success = chunks[i].success && (i + 1 == chunk_count || chunk_elements->length == chunks[i + 1].first_index);
+        separators += chunks[i].separators;
+
+        if (elements->tail == nullptr) {
+            elements->head = chunk_elements->head;
+        } else {
+            elements->tail->next = chunk_elements->head;
+        }
+
+        elements->tail = chunk_elements->tail;
+        elements->length = chunk_elements->length;
+    }
+
+    // json_parse() counts the elements and the separators in the struct size
+    if (success && elements->length + separators <= options.max_struct_size) {
+        return (json_value_parser_result_t) {
+            .result = json_create_success_result(),
+            .value = root,
+        };
+    }
+
+    // On error, parse the whole document again to get the same error as json_parse_value()
+    for (size_t i = 0; i < chunk_count; ++i) {
+        json_arena_rollback(arenas[i], initial_marks[i]);
+    }
+
+    json_arena_rollback(arenas[0], initial_mark);
+
+    return json_parse_value(length, json, arenas[0], stack_size, stacks, options);
+}
@@ -33,6 +33,27 @@ typedef struct {
  */
 json_value_parser_result_t json_parse_value(size_t length, const char json[length], json_arena_t* arena, size_t stack_size, json_value_t* stack[stack_size], json_parser_options_t options);
 
+/**
+ * Parse the JSON string as a value like `json_parse_value()`, without copying the strings which have no escape sequence:
+ * their values and keys point directly into the input, so only the escaped strings are decoded into the arena.
+ * The parser reports the strings without escape sequences while validating them, so the input is not scanned again.
+ *
+ * The input must outlive the returned value, and must not be modified while it is used.
+ * The strings of the value are still not null-terminated.
+ */
+json_value_parser_result_t json_parse_value_borrowed(size_t length, const char json[length], json_arena_t* arena, size_t stack_size, json_value_t* stack[stack_size], json_parser_options_t options);
+
+/**
+ * Parse the JSON string as a value like `json_parse_value()`, decoding the strings inside the input buffer itself:
+ * the escape sequences are replaced in place, and the values and keys point into the input, so the string pool
+ * of the arena is not used, and can have a size of 0.
+ *
+ * The input is modified, even if the parsing fails: only the content of the strings is valid after the parsing,
+ * the bytes between the end of a decoded string and its closing quote are left as is.
+ * The input must outlive the returned value.
+ */
+json_value_parser_result_t json_parse_value_in_situ(size_t length, char json[length], json_arena_t* arena, size_t stack_size, json_value_t* stack[stack_size], json_parser_options_t options);
+
 /**
  * Parse the JSON string as a value, using default options.
  * The maximum depth is set to 32.
@@ -43,4 +64,60 @@ json_value_parser_result_t json_parse_value(size_t length, const char json[lengt
  */
 json_value_parser_result_t json_parse_value_defaults(size_t length, const char json[length], json_arena_t* arena);
 
+/**
+ * Number of stack entries needed by `json_parse_value_parallel()` for the given count of threads and stack size per thread.
+ */
+#define JSON_VALUE_PARSER_STACKS_SIZE(worker_count, stack_size) ((worker_count) * (stack_size))
+
+/**
+ * Parse the JSON string as a value like `json_parse_value()`, using several threads when the root value is an array.
+ *
+ * The elements of the root array are split in chunks of similar sizes, which are parsed in parallel, each one in its own arena.
+ * The element lists of the chunks are then linked, so the result is identical to the one of `json_parse_value()`:
+ * the root array is allocated in the first arena, and its elements in the arena of the chunk which parsed them.
+ * Other documents, and small arrays, are parsed by the calling thread in the first arena.
+ *
+ * On error, the document is parsed again by the calling thread to report the same error as `json_parse_value()`.
+ * The arenas are then restored to their initial state, except the first one which contains the partial values.
+ *
+ * @param length The length of the JSON input string.
+ * @param json The JSON input string to parse. Null-terminated is not required.
+ * @param worker_count The number of threads to use, including the calling thread.
+ * @param arenas One arena per thread. Each one must be large enough for the values of its chunk.
+ * @param stack_size The size of the stack of each thread, see `json_parse_value()`. It should be equals to `options.max_depth`.
+ * @param stacks The stacks of the threads, one after the other. The first one is used by the calling thread. See `JSON_VALUE_PARSER_STACKS_SIZE()`.
+ * @param options The parser options to use.
+ */
+json_value_parser_result_t json_parse_value_parallel(
+    size_t length,
+    const char json[length],
+    size_t worker_count,
+    json_arena_t* arenas[worker_count],
+    size_t stack_size,
+    json_value_t* stacks[JSON_VALUE_PARSER_STACKS_SIZE(worker_count, stack_size)],
+    json_parser_options_t options
+);
+
+/**
+ * The arena pool sizes needed to parse a document with `json_parse_value()`.
+ */
+typedef struct {
+    json_parser_result_t result;
+    size_t string_pool_size;
+    size_t value_pool_size;
+    size_t key_pool_size;
+} json_measure_result_t;
+
+/**
+ * Compute the exact pool sizes needed by `json_parse_value()` for the JSON string, so the arena can be allocated at once:
+ * `json_arena_size()` of the sizes gives the arena size, and the parsing cannot fail with `JSON_ERROR_OUT_OF_MEMORY`.
+ *
+ * The values are counted from the structural index, without parsing them, so this is much faster than the parsing.
+ * But the input is not validated: for an invalid document, the sizes are only meaningful up to the first error.
+ *
+ * @param length The length of the JSON input string.
+ * @param json The JSON input string to measure. Null-terminated is not required.
+ */
+json_measure_result_t json_measure(size_t length, const char json[length]);
+
 #endif //JSON_VALUE_PARSER_H
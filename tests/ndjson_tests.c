@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tests.h"
+#include "../formater/formater.h"
+#include "../parser/ndjson.h"
+#include "../parser/scanner.h"
+
+TEST_CASE(ndjson)
+
+#define TEST_MAX_WORKERS 4
+#define TEST_STACK_SIZE 32
+
+/**
+ * Write each received record on a line of the log: "<line>:<formatted value>" or "<line>!<error code>@<position>"
+ */
+typedef struct {
+    json_ndjson_handler_t handler;
+    char log[16384];
+    size_t log_used;
+    size_t count;
+    size_t stop_after;
+} test_ndjson_handler_t;
+
+static json_arena_t* test_arenas[TEST_MAX_WORKERS] = { nullptr };
+
+static json_parser_result_t test_on_record(json_ndjson_handler_t* self, const json_ndjson_record_t* record) {
+    test_ndjson_handler_t* handler = (test_ndjson_handler_t*) self;
+    char* log = handler->log + handler->log_used;
+    const size_t available = sizeof(handler->log) - handler->log_used;
+
+    if (record->result.result.code == JSON_PARSE_SUCCESS) {
+        const int prefix = snprintf(log, available, "%zu:", record->line);
+        const json_formater_result_t formatted = json_format_value(record->result.value, log + prefix, available - (size_t) prefix);
+
+        handler->log_used += (size_t) prefix + formatted.result.length;
+    } else {
+        handler->log_used += (size_t) snprintf(log, available, "%zu!%d@%zu", record->line, record->result.result.code, record->result.result.position);
+    }
+
+    handler->log[handler->log_used++] = '\n';
+    handler->log[handler->log_used] = '\0';
+
+    if (++handler->count == handler->stop_after) {
+        return (json_parser_result_t) { JSON_PARSE_HANDLER_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNKNOWN };
+    }
+
+    return json_create_success_result();
+}
+
+static json_parser_result_t parse_ndjson(const char* json, test_ndjson_handler_t* handler, const size_t worker_count, const size_t batch_size, const size_t value_pool_size) {
+    json_ndjson_record_t records[JSON_NDJSON_RECORDS_SIZE(worker_count, batch_size)];
+    json_value_t* stacks[JSON_NDJSON_STACKS_SIZE(worker_count, TEST_STACK_SIZE)];
+    const size_t arena_size = json_arena_size(1024, value_pool_size, 64);
+
+    for (size_t i = 0; i < TEST_MAX_WORKERS; ++i) {
+        free(test_arenas[i]);
+        test_arenas[i] = (json_arena_t*) malloc(arena_size);
+        json_arena_init(test_arenas[i], arena_size, 1024, value_pool_size, 64);
+    }
+
+    *handler = (test_ndjson_handler_t) { .handler = { test_on_record } };
+
+    return json_parse_ndjson(strlen(json), json, &handler->handler, (json_parser_options_t) { .max_depth = TEST_STACK_SIZE }, worker_count, test_arenas, TEST_STACK_SIZE, stacks, batch_size, records);
+}
+
+TEST_TEARDOWN {
+    for (size_t i = 0; i < TEST_MAX_WORKERS; ++i) {
+        free(test_arenas[i]);
+        test_arenas[i] = nullptr;
+    }
+}
+
+TEST(records_in_order) {
+    const char* json =
+        "{\"id\":1,\"tags\":[\"a\",\"b\"]}\n"
+        "[1,2,3]\r\n"
+        "\n"
+        "   \t\n"
+        "\"text\"\n"
+        "null\n"
+        "-12.5\n"
+        "true"
+    ;
+    const char* expected =
+        "0:{\"id\": 1, \"tags\": [\"a\", \"b\"]}\n"
+        "1:[1, 2, 3]\n"
+        "4:\"text\"\n"
+        "5:null\n"
+        "6:-12.500000\n"
+        "7:true\n"
+    ;
+    test_ndjson_handler_t handler;
+
+    for (size_t worker_count = 1; worker_count <= TEST_MAX_WORKERS; ++worker_count) {
+        for (size_t batch_size = 1; batch_size <= 5; ++batch_size) {
+            ASSERT_INT(JSON_PARSE_SUCCESS, parse_ndjson(json, &handler, worker_count, batch_size, 64).code);
+            ASSERT_STR(expected, handler.log);
+        }
+    }
+}
+
+TEST(malformed_lines_are_skipped) {
+    const char* json = "1\n[1,\n{\"a\" 2}\n2\n\"abc\n3\n";
+    const char* expected =
+        "0:1\n"
+        "1!2@3\n"
+        "2!1@5\n"
+        "3:2\n"
+        "4!2@4\n"
+        "5:3\n"
+    ;
+    test_ndjson_handler_t handler;
+
+    for (size_t worker_count = 1; worker_count <= TEST_MAX_WORKERS; ++worker_count) {
+        ASSERT_INT(JSON_PARSE_SUCCESS, parse_ndjson(json, &handler, worker_count, 2, 64).code);
+        ASSERT_STR(expected, handler.log);
+    }
+}
+
+TEST(full_arena_cuts_the_batch) {
+    // Each array takes 4 values: the arena can hold one array, and the numbers of the next lines
+    const char* json = "[1,2,3]\n[4,5,6]\n7\n[1,2,3,4,5,6,7,8]\n8\n";
+    const char* expected =
+        "0:[1, 2, 3]\n"
+        "1:[4, 5, 6]\n"
+        "2:7\n"
+        "3!6@0\n"
+        "4:8\n"
+    ;
+    test_ndjson_handler_t handler;
+
+    for (size_t worker_count = 1; worker_count <= TEST_MAX_WORKERS; ++worker_count) {
+        for (size_t batch_size = 1; batch_size <= 5; ++batch_size) {
+            ASSERT_INT(JSON_PARSE_SUCCESS, parse_ndjson(json, &handler, worker_count, batch_size, 5).code);
+            ASSERT_STR(expected, handler.log);
+        }
+    }
+}
+
+TEST(handler_stops_parsing) {
+    test_ndjson_handler_t handler;
+    json_ndjson_record_t records[4];
+    json_value_t* stacks[JSON_NDJSON_STACKS_SIZE(2, 2)];
+    json_arena_t* arenas[2] = { nullptr, nullptr };
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_ndjson("", &handler, 2, 2, 16).code);
+    ASSERT_INT(0, handler.count);
+
+    handler = (test_ndjson_handler_t) { .handler = { test_on_record }, .stop_after = 2 };
+    arenas[0] = test_arenas[0];
+    arenas[1] = test_arenas[1];
+
+    const json_parser_result_t result = json_parse_ndjson(7, "1\n2\n3\n4", &handler.handler, (json_parser_options_t) {}, 2, arenas, 2, stacks, 2, records);
+    ASSERT_INT(JSON_PARSE_HANDLER_ERROR, result.code);
+    ASSERT_STR("0:1\n1:2\n", handler.log);
+
+    // The lines deeper than the stacks are reported like with json_parse_value()
+    handler = (test_ndjson_handler_t) { .handler = { test_on_record } };
+    ASSERT_INT(JSON_PARSE_SUCCESS, json_parse_ndjson(11, "[1]\n[[2]]\n3", &handler.handler, (json_parser_options_t) {}, 2, arenas, 1, stacks, 2, records).code);
+    ASSERT_STR("0:[1]\n1!6@0\n2:3\n", handler.log);
+
+    arenas[1] = nullptr;
+    ASSERT_INT(JSON_ERROR_NULL_POINTER, json_parse_ndjson(7, "1\n2\n3\n4", &handler.handler, (json_parser_options_t) {}, 2, arenas, 2, stacks, 2, records).error);
+    ASSERT_INT(JSON_ERROR_NULL_POINTER, json_parse_ndjson(7, "1\n2\n3\n4", &handler.handler, (json_parser_options_t) {}, 2, test_arenas, 2, nullptr, 2, records).error);
+    ASSERT_INT(JSON_ERROR_TOO_SMALL, json_parse_ndjson(7, "1\n2\n3\n4", &handler.handler, (json_parser_options_t) {}, 0, arenas, 2, stacks, 2, records).error);
+}
+
+TEST(newline_scanner_match_scalar_implementation) {
+    char buffer[100];
+
+    for (size_t newline_position = 0; newline_position <= sizeof(buffer); ++newline_position) {
+        // Use bytes close to the line feed as regular characters
+        for (size_t i = 0; i < sizeof(buffer); ++i) {
+            buffer[i] = (char) (0x0B + (i * 37) % 0xF0);
+        }
+
+        if (newline_position < sizeof(buffer)) {
+            buffer[newline_position] = '\n';
+        }
+
+        for (size_t start = 0; start < 40; ++start) {
+            for (size_t end = start; end <= sizeof(buffer); end += 5) {
+                ASSERT_INT(
+                    json_scan_newline_scalar(buffer, start, end),
+                    json_scan_newline(buffer, start, end)
+                );
+            }
+        }
+    }
+}
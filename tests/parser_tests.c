@@ -2,11 +2,18 @@
 // Created by vincent on 08/12/2025.
 //
 
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "tests.h"
+#include "../parser/file.h"
 #include "../parser/parser.h"
+#include "../parser/push_parser.h"
+#include "../parser/reader.h"
+#include "../parser/scanner.h"
+#include "../parser/structural_index.h"
 
 TEST_CASE(parser)
 
@@ -161,6 +168,196 @@ TEST(parse_number) {
     ASSERT_DOUBLE(-42.0, *(double*) test_call_stack.entries[0].parameter, 0.0);
 }
 
+static bool parse_number_as_strtod(const char* json) {
+    const json_parser_result_t result = parse_json(json);
+
+    if (result.code != JSON_PARSE_SUCCESS || test_call_stack.count != 1) {
+        fprintf(stderr, "Cannot parse number %s\n", json);
+        return false;
+    }
+
+    const double expected = strtod(json, nullptr);
+    const double actual = *(double*) test_call_stack.entries[0].parameter;
+
+    if (memcmp(&expected, &actual, sizeof(double)) != 0) {
+        fprintf(stderr, "Number %s parsed as %.17g, but strtod() returns %.17g\n", json, actual, expected);
+        return false;
+    }
+
+    return true;
+}
+
+TEST(parse_number_exponent) {
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("1e10").code);
+    ASSERT_DOUBLE(1e10, *(double*) test_call_stack.entries[0].parameter, 0.0);
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("1E+2").code);
+    ASSERT_DOUBLE(100.0, *(double*) test_call_stack.entries[0].parameter, 0.0);
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("-2.5e-3").code);
+    ASSERT_DOUBLE(-0.0025, *(double*) test_call_stack.entries[0].parameter, 0.0);
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("0e0").code);
+    ASSERT_DOUBLE(0.0, *(double*) test_call_stack.entries[0].parameter, 0.0);
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("1e400").code);
+    ASSERT_TRUE(*(double*) test_call_stack.entries[0].parameter > 1.7976931348623157e308);
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("1e-400").code);
+    ASSERT_DOUBLE(0.0, *(double*) test_call_stack.entries[0].parameter, 0.0);
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("[1e2,2E-1]").code);
+    ASSERT_INT(4, test_call_stack.count);
+    ASSERT_DOUBLE(100.0, *(double*) test_call_stack.entries[1].parameter, 0.0);
+    ASSERT_DOUBLE(0.2, *(double*) test_call_stack.entries[2].parameter, 0.0);
+}
+
+TEST(parse_number_match_strtod) {
+    const char* numbers[] = {
+        "0", "-0", "0.1", "0.3", "123.456", "3.141592653589793", "-1.5e-7",
+        "9007199254740991", "9007199254740992", "9007199254740993", "18446744073709551615", "18446744073709551616",
+        "1.7976931348623157e308", "1.7976931348623158e308", "1.7976931348623159e308",
+        "2.2250738585072011e-308", "2.2250738585072014e-308", "4.9406564584124654e-324", "2.4703282292062327e-324", "2.4703282292062328e-324",
+        "7.2057594037927933e16", "9.5e-8", "1e23", "8.98846567431158e307", "1448997445238699", "0.000000000000000000000000001234",
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203124",
+        "1.00000000000000011102230246251565404236316680908203126",
+        "9007199254740993.0000000000000000000000000000000000001",
+        "123456789012345678901234567890e-10", "0.0000000000000000000000000000000123456789012345678901234567890",
+        "2.4703282292062327208828439643411068618252990130716238221279284125033775363510437593264991818081799618989828234772285886546332835517796989819938739800539093906315035659515570226392290858392449105184435931802849936536152500319370457678249219365623669863658480757001585769269903706311928279558551332927834338409351978015531246597263579574622766465272827220056374006485499977096599470454020828166226237857393450736339007967761930577506740176324673600968951340535537458516661134223766678604162159680461914467291840300530057530849048765391711386591646239524912623653881879636239373280423891018672348497668235089863388587925628302755995657524455507255189313690836254779186948667994968324049705821028513185451396213837722826145437693412532098591327667236328125e-324",
+    };
+
+    for (size_t i = 0; i < sizeof(numbers) / sizeof(numbers[0]); ++i) {
+        ASSERT_TRUE(parse_number_as_strtod(numbers[i]));
+    }
+
+    // Random numbers around the fast path limits: up to 30 significant digits, and exponents of subnormal and huge numbers
+    char buffer[64];
+    srand(42);
+
+    for (size_t i = 0; i < 20000; ++i) {
+        size_t length = 0;
+        const size_t integer_digits = 1 + rand() % 20;
+        const size_t fraction_digits = rand() % 12;
+
+        if (rand() % 2) {
+            buffer[length++] = '-';
+        }
+
+        buffer[length++] = (char) ('1' + rand() % 9);
+
+        for (size_t j = 1; j < integer_digits; ++j) {
+            buffer[length++] = (char) ('0' + rand() % 10);
+        }
+
+        if (fraction_digits > 0) {
+            buffer[length++] = '.';
+
+            for (size_t j = 0; j < fraction_digits; ++j) {
+                buffer[length++] = (char) ('0' + rand() % 10);
+            }
+        }
+
+        snprintf(buffer + length, sizeof(buffer) - length, "e%d", rand() % 700 - 350);
+
+        ASSERT_TRUE(parse_number_as_strtod(buffer));
+    }
+}
+
+TEST(parse_number_long_fraction) {
+    char buffer[2048];
+
+    // The fraction digits past the 768 kept significant digits must not shift the exponent
+    strcpy(buffer, "9007199254740993.");
+    memset(buffer + strlen(buffer), '0', 800);
+    strcpy(buffer + strlen("9007199254740993.") + 800, "1");
+
+    ASSERT_TRUE(parse_number_as_strtod(buffer));
+    ASSERT_DOUBLE(9007199254740994.0, *(double*) test_call_stack.entries[0].parameter, 0.0);
+
+    // Leading zeros of the fraction, then more significant digits than kept
+    strcpy(buffer, "-0.000000000123");
+    for (size_t i = strlen(buffer); i < 1000; ++i) {
+        buffer[i] = (char) ('0' + i % 10);
+    }
+    strcpy(buffer + 1000, "e-20");
+
+    ASSERT_TRUE(parse_number_as_strtod(buffer));
+
+    // Truncated integer digits, followed by a fraction
+    buffer[0] = '1';
+    memset(buffer + 1, '0', 799);
+    strcpy(buffer + 800, ".5e-790");
+
+    ASSERT_TRUE(parse_number_as_strtod(buffer));
+}
+
+static json_parser_result_t on_integer(json_parser_handler_t* self, int64_t value) {
+    test_call_stack.entries[test_call_stack.count].function_name = "on_integer";
+    test_call_stack.entries[test_call_stack.count].parameter = malloc(sizeof(int64_t));
+    *((int64_t*)test_call_stack.entries[test_call_stack.count].parameter) = value;
+
+    ++test_call_stack.count;
+
+    return json_create_success_result();
+}
+
+TEST(parse_integer) {
+    json_parser_handler_t handler = init_handler();
+    handler.on_integer = on_integer;
+    const char* json = "[12, -3, 1.5, 2e2, 9223372036854775807, 9223372036854775808, -9223372036854775808, -0]";
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, json_parse(strlen(json), json, &handler, (json_parser_options_t) {32, 1024, 1024 }).code);
+    ASSERT_INT(10, test_call_stack.count);
+
+    ASSERT_STR("on_integer", test_call_stack.entries[1].function_name);
+    ASSERT_TRUE(*(int64_t*) test_call_stack.entries[1].parameter == 12);
+    ASSERT_STR("on_integer", test_call_stack.entries[2].function_name);
+    ASSERT_TRUE(*(int64_t*) test_call_stack.entries[2].parameter == -3);
+    ASSERT_STR("on_number", test_call_stack.entries[3].function_name);
+    ASSERT_DOUBLE(1.5, *(double*) test_call_stack.entries[3].parameter, 0.0);
+    ASSERT_STR("on_number", test_call_stack.entries[4].function_name);
+    ASSERT_DOUBLE(200.0, *(double*) test_call_stack.entries[4].parameter, 0.0);
+    ASSERT_STR("on_integer", test_call_stack.entries[5].function_name);
+    ASSERT_TRUE(*(int64_t*) test_call_stack.entries[5].parameter == INT64_MAX);
+    ASSERT_STR("on_number", test_call_stack.entries[6].function_name);
+    ASSERT_DOUBLE(9223372036854775808.0, *(double*) test_call_stack.entries[6].parameter, 0.0);
+    ASSERT_STR("on_integer", test_call_stack.entries[7].function_name);
+    ASSERT_TRUE(*(int64_t*) test_call_stack.entries[7].parameter == INT64_MIN);
+    ASSERT_STR("on_number", test_call_stack.entries[8].function_name);
+
+    // on_integer is the last member, so positional initializers of the other callbacks are not shifted
+    const json_parser_handler_t positional = { nullptr, nullptr, on_number, on_string };
+    ASSERT_TRUE(positional.on_string == on_string);
+    ASSERT_NULL(positional.on_integer);
+}
+
+TEST(parse_number_error) {
+    const struct {
+        const char* json;
+        json_parse_code_t code;
+        size_t position;
+    } errors[] = {
+        { "01", JSON_PARSE_ERROR_INVALID_SYNTAX, 1 },
+        { "-01", JSON_PARSE_ERROR_INVALID_SYNTAX, 2 },
+        { "-", JSON_PARSE_ERROR_UNEXPECTED_END, 1 },
+        { "-a", JSON_PARSE_ERROR_INVALID_SYNTAX, 1 },
+        { "1.", JSON_PARSE_ERROR_UNEXPECTED_END, 2 },
+        { "1.e5", JSON_PARSE_ERROR_INVALID_SYNTAX, 2 },
+        { "1e", JSON_PARSE_ERROR_UNEXPECTED_END, 2 },
+        { "1e+", JSON_PARSE_ERROR_UNEXPECTED_END, 3 },
+        { "1E-x", JSON_PARSE_ERROR_INVALID_SYNTAX, 3 },
+        { "[1,-]", JSON_PARSE_ERROR_INVALID_SYNTAX, 4 },
+    };
+
+    for (size_t i = 0; i < sizeof(errors) / sizeof(errors[0]); ++i) {
+        const json_parser_result_t result = parse_json(errors[i].json);
+        ASSERT_INT(errors[i].code, result.code);
+        ASSERT_INT(JSON_CONTEXT_NUMBER, result.context);
+        ASSERT_INT(errors[i].position, result.position);
+    }
+}
+
 TEST(parse_null) {
     ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("null").code);
     ASSERT_INT(1, test_call_stack.count);
@@ -189,6 +386,195 @@ TEST(parse_string) {
     ASSERT_STRN("\"Hello, World!\"", str.value, 15);
 }
 
+TEST(parse_long_string_with_escapes) {
+    // Escapes are placed around the 16 and 32 bytes boundaries of the vectorized scanner
+    const char* json = "\"0123456789abcd\\\"0123456789abcdefghijklm\\\\0123456789abcdefghijklmnopqrstuvwxyz\"";
+    const size_t length = strlen(json);
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json(json).code);
+    ASSERT_INT(1, test_call_stack.count);
+    ASSERT_STR("on_string", test_call_stack.entries[0].function_name);
+
+    json_raw_string_t str = *(json_raw_string_t*) test_call_stack.entries[0].parameter;
+    ASSERT_INT(length, str.length);
+    ASSERT_TRUE(str.value == json);
+}
+
+TEST(parse_string_error_positions) {
+    {
+        const json_parser_result_t result = parse_json("\"0123456789abcdefghijklmnopqrstuvwxyz0123456789");
+        ASSERT_INT(JSON_PARSE_ERROR_UNEXPECTED_END, result.code);
+        ASSERT_INT(JSON_CONTEXT_STRING, result.context);
+        ASSERT_INT(JSON_ERROR_MISSING_CLOSING_CHARACTER, result.error);
+        ASSERT_INT(47, result.position);
+    }
+
+    {
+        const json_parser_result_t result = parse_json("\"0123456789abcdefghijklmnopqrstuvwxyz012345678\\");
+        ASSERT_INT(JSON_PARSE_ERROR_UNEXPECTED_END, result.code);
+        ASSERT_INT(JSON_ERROR_MISSING_CLOSING_CHARACTER, result.error);
+        ASSERT_INT(47, result.position);
+    }
+
+    {
+        // The escape is the last character allowed by max_string_size
+        char long_string[1100];
+        memset(long_string, 'a', sizeof(long_string) - 1);
+        long_string[0] = '"';
+        long_string[1023] = '\\';
+        long_string[sizeof(long_string) - 2] = '"';
+        long_string[sizeof(long_string) - 1] = '\0';
+
+        const json_parser_result_t result = parse_json(long_string);
+        ASSERT_INT(JSON_PARSE_ERROR_MAX_STRING_SIZE, result.code);
+        ASSERT_INT(JSON_CONTEXT_STRING, result.context);
+        ASSERT_INT(1024, result.position);
+    }
+}
+
+TEST(parse_string_invalid_characters) {
+    const struct {
+        const char* json;
+        json_parse_context_t context;
+        json_parse_error_t error;
+        size_t position;
+    } inputs[] = {
+        { "\"a\tb\"", JSON_CONTEXT_STRING, JSON_ERROR_UNEXPECTED_CHARACTER, 2 },
+        { "[\"abc\ndef\"]", JSON_CONTEXT_STRING, JSON_ERROR_UNEXPECTED_CHARACTER, 5 },
+        { "{\"\x01\": 1}", JSON_CONTEXT_OBJECT_PROPERTY, JSON_ERROR_UNEXPECTED_CHARACTER, 2 },
+        { "\"\x80\"", JSON_CONTEXT_STRING, JSON_ERROR_INVALID_UTF8, 1 },
+        { "\"\xC0\xAF\"", JSON_CONTEXT_STRING, JSON_ERROR_INVALID_UTF8, 1 },
+        { "\"ab\xE0\x80\xAF\"", JSON_CONTEXT_STRING, JSON_ERROR_INVALID_UTF8, 3 },
+        { "\"\xED\xA0\x80\"", JSON_CONTEXT_STRING, JSON_ERROR_INVALID_UTF8, 1 },
+        { "\"\xF4\x90\x80\x80\"", JSON_CONTEXT_STRING, JSON_ERROR_INVALID_UTF8, 1 },
+        { "\"\xE2\x82\"", JSON_CONTEXT_STRING, JSON_ERROR_INVALID_UTF8, 1 },
+        { "\"\xE2\x82", JSON_CONTEXT_STRING, JSON_ERROR_INVALID_UTF8, 1 },
+        { "{\"k\xFF\": 1}", JSON_CONTEXT_OBJECT_PROPERTY, JSON_ERROR_INVALID_UTF8, 3 },
+        // Errors after a block of valid multi-byte sequences, and in a sequence crossing two blocks
+        { "\"\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xFF\"", JSON_CONTEXT_STRING, JSON_ERROR_INVALID_UTF8, 41 },
+        { "\"0123456789abcdefghijklmnopqrstu\xF0\x9F\x98!0123456789abcdefghijklmnopqrstuvwxyz\"", JSON_CONTEXT_STRING, JSON_ERROR_INVALID_UTF8, 32 },
+        { "\"0123456789abcdefghijklmnopqrstu\xF0\x9F\x98\x80\x80" "123456789abcdefghijklmnopqrstuvwxyz\"", JSON_CONTEXT_STRING, JSON_ERROR_INVALID_UTF8, 36 },
+    };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        const json_parser_result_t result = parse_json(inputs[i].json);
+
+        if (result.error != inputs[i].error || result.position != inputs[i].position) {
+            fprintf(stderr, "[INFO] Input: %s\n", inputs[i].json);
+        }
+
+        ASSERT_INT(JSON_PARSE_ERROR_INVALID_SYNTAX, result.code);
+        ASSERT_INT(inputs[i].context, result.context);
+        ASSERT_INT(inputs[i].error, result.error);
+        ASSERT_INT(inputs[i].position, result.position);
+    }
+
+    {
+        // A valid sequence cut by max_string_size is not an UTF-8 error
+        char long_string[1100];
+        memset(long_string, 'a', sizeof(long_string) - 1);
+        long_string[0] = '"';
+        memcpy(long_string + 1022, "\xE2\x82\xAC", 3);
+        long_string[sizeof(long_string) - 2] = '"';
+        long_string[sizeof(long_string) - 1] = '\0';
+
+        const json_parser_result_t result = parse_json(long_string);
+        ASSERT_INT(JSON_PARSE_ERROR_MAX_STRING_SIZE, result.code);
+        ASSERT_INT(1024, result.position);
+    }
+
+    {
+        // The escape sequences are not checked by the parser: a valid sequence following a backslash is not an UTF-8 error
+        ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("\"\\\xC3\xA9\"").code);
+
+        const json_parser_result_t result = parse_json("\"\\\xC3\"");
+        ASSERT_INT(JSON_ERROR_INVALID_UTF8, result.error);
+        ASSERT_INT(2, result.position);
+    }
+
+    {
+        const json_parser_result_t result = parse_json("\"caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80\"");
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.code);
+        ASSERT_STR("Syntax error: Invalid UTF-8 sequence at position 1 while parsing string value", json_parse_error_message(parse_json("\"\xFF\"")));
+    }
+}
+
+TEST(string_scanner_match_scalar_implementation) {
+    const char specials[] = { '"', '\\', '\n', '\0', 0x1F };
+    char buffer[160];
+
+    for (size_t special = 0; special < sizeof(specials); ++special) {
+        for (size_t special_position = 0; special_position < sizeof(buffer); special_position += 3) {
+            // Use bytes around the control characters limit, and non-ASCII bytes, as regular characters
+            for (size_t i = 0; i < sizeof(buffer); ++i) {
+                buffer[i] = (char) (0x20 + (i * 37) % 0xE0);
+
+                if (buffer[i] == '"' || buffer[i] == '\\') {
+                    buffer[i] = 'a';
+                }
+            }
+
+            buffer[special_position] = specials[special];
+
+            for (size_t start = 0; start < 40; ++start) {
+                for (size_t end = start; end <= sizeof(buffer); end += 7) {
+                    ASSERT_INT(
+                        json_scan_string_special_scalar(buffer, start, end),
+                        json_scan_string_special(buffer, start, end)
+                    );
+                }
+            }
+        }
+    }
+}
+
+TEST(whitespace_scanner_match_scalar_implementation) {
+    const char whitespaces[] = { ' ', '\n', '\r', '\t' };
+    const char others[] = { 'a', '\0', 0x0B, 0x0C, '"', (char) 0xA0 };
+    char buffer[100];
+
+    for (size_t other = 0; other < sizeof(others); ++other) {
+        for (size_t other_position = 0; other_position <= sizeof(buffer); ++other_position) {
+            for (size_t i = 0; i < sizeof(buffer); ++i) {
+                buffer[i] = whitespaces[(i * 7) % sizeof(whitespaces)];
+            }
+
+            if (other_position < sizeof(buffer)) {
+                buffer[other_position] = others[other];
+            }
+
+            for (size_t start = 0; start < 40; ++start) {
+                for (size_t end = start; end <= sizeof(buffer); end += 5) {
+                    ASSERT_INT(
+                        json_scan_whitespace_scalar(buffer, start, end),
+                        json_scan_whitespace(buffer, start, end)
+                    );
+                }
+            }
+        }
+    }
+}
+
+TEST(parse_pretty_printed) {
+    const char* json =
+        "{\n"
+        "                                        \"items\": [\n"
+        "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\ttrue\r\n"
+        "                                                                     ,  null\n"
+        "                                        ]\n"
+        "}\n";
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json(json).code);
+    ASSERT_INT(7, test_call_stack.count);
+    ASSERT_STR("on_object_start", test_call_stack.entries[0].function_name);
+    ASSERT_STR("on_object_property", test_call_stack.entries[1].function_name);
+    ASSERT_STR("on_array_start", test_call_stack.entries[2].function_name);
+    ASSERT_STR("on_bool", test_call_stack.entries[3].function_name);
+    ASSERT_STR("on_null", test_call_stack.entries[4].function_name);
+    ASSERT_STR("on_array_end", test_call_stack.entries[5].function_name);
+    ASSERT_STR("on_object_end", test_call_stack.entries[6].function_name);
+}
+
 TEST(parse_array_simple) {
     ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("[]").code);
     ASSERT_INT(2, test_call_stack.count);
@@ -492,3 +878,1590 @@ TEST(max_struct_length_exceeded) {
     ASSERT_INT(2565, result.position);
     ASSERT_STR("Maximum structure size exceeded:  at position 2565 while parsing object value", json_parse_error_message(result));
 }
+
+TEST(thread_failure_error_message) {
+    const json_parser_result_t result = { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_THREAD_FAILURE, 0, 0 };
+    ASSERT_STR("Internal error: Cannot start or synchronize worker threads at position 0 ", json_parse_error_message(result));
+}
+
+static json_parser_result_t parse_json_indexed(const char* json) {
+    json_parser_handler_t handler = init_handler();
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+
+    return json_parse_indexed(strlen(json), json, &handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack);
+}
+
+static json_parser_result_t parse_json_iterative(const char* json) {
+    json_parser_handler_t handler = init_handler();
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+
+    return json_parse_iterative(strlen(json), json, &handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack);
+}
+
+/**
+ * Read all the tokens, and record them as the corresponding handler calls
+ */
+static json_parser_result_t parse_json_reader(const char* json) {
+    json_parser_handler_t handler = init_handler();
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+    json_reader_t reader;
+    json_token_t token;
+
+    const json_parser_result_t init_result = json_reader_init(&reader, strlen(json), json, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack);
+
+    if (init_result.code != JSON_PARSE_SUCCESS) {
+        return init_result;
+    }
+
+    for (;;) {
+        switch (json_reader_next(&reader, &token)) {
+            case JSON_TOKEN_ERROR:
+                return reader.error;
+            case JSON_TOKEN_END:
+                return json_create_success_result();
+            case JSON_TOKEN_NULL:
+                on_null(&handler);
+                break;
+            case JSON_TOKEN_BOOL:
+                on_bool(&handler, token.bool_value);
+                break;
+            case JSON_TOKEN_NUMBER:
+                on_number(&handler, token.number_value);
+                break;
+            case JSON_TOKEN_STRING:
+                on_string(&handler, token.raw);
+                break;
+            case JSON_TOKEN_ARRAY_START:
+                on_array_start(&handler);
+                break;
+            case JSON_TOKEN_ARRAY_END:
+                on_array_end(&handler);
+                break;
+            case JSON_TOKEN_OBJECT_START:
+                on_object_start(&handler);
+                break;
+            case JSON_TOKEN_OBJECT_PROPERTY:
+                on_object_property(&handler, token.raw);
+                break;
+            case JSON_TOKEN_OBJECT_END:
+                on_object_end(&handler);
+                break;
+            case JSON_TOKEN_INTEGER:
+                on_number(&handler, (double) token.integer_value);
+                break;
+        }
+    }
+}
+
+#define JSON_PARSER_NAME parse_json_specialized_instance
+#define JSON_PARSER_HANDLER_TYPE json_parser_handler_t
+#define JSON_PARSER_ON_NULL(handler) on_null(handler)
+#define JSON_PARSER_ON_BOOL(handler, value) on_bool(handler, value)
+#define JSON_PARSER_ON_NUMBER(handler, value) on_number(handler, value)
+#define JSON_PARSER_ON_STRING(handler, value) on_string(handler, value)
+#define JSON_PARSER_ON_ARRAY_START(handler) on_array_start(handler)
+#define JSON_PARSER_ON_ARRAY_END(handler) on_array_end(handler)
+#define JSON_PARSER_ON_OBJECT_START(handler) on_object_start(handler)
+#define JSON_PARSER_ON_OBJECT_PROPERTY(handler, key) on_object_property(handler, key)
+#define JSON_PARSER_ON_OBJECT_END(handler) on_object_end(handler)
+#define JSON_PARSER_MAX_DEPTH 32
+#define JSON_PARSER_MAX_STRING_SIZE 1024
+#define JSON_PARSER_MAX_STRUCT_SIZE 1024
+#include "../parser/parser_template.h"
+
+static json_parser_result_t parse_json_specialized(const char* json) {
+    json_parser_handler_t handler = init_handler();
+
+    return parse_json_specialized_instance(strlen(json), json, &handler, (json_parser_options_t) {});
+}
+
+TEST(parser_engines_match_json_parse) {
+    json_parser_result_t (*engines[])(const char*) = { parse_json_indexed, parse_json_iterative, parse_json_reader, parse_json_specialized };
+
+    const char* inputs[] = {
+        "123", "-12.5", "null", "true", "false", "\"Hello, World!\"", "  \"\\\\\\\"\"  ",
+        "[]", "{}", "[123, true]", "{\"foo\": 42}", " [ 1 , [ 2 , { \"a\" : [ ] } ] , \"x\" ] ",
+        "{\"a\\\"b\": \"c\\\\\", \"d\": [null, false, \"{[,:]}\"]}",
+        "[1,]", "[,1]", "[1 2]", "[12abc]", "[1-2]", "[1\"a\"]", "[\"a\"1]", "{\"a\":1,}", "{,}",
+        "{]sdfdsfoi", "tr", "trsssssssssss", "[,]", "{test}", "{\"test\"}", "{\"test\":}", "  ", "[", "{",
+        "[1", "[1,", "{\"a\"", "{\"a\":", "{\"a\":1", "\"abc", "\"abc\\", "\"", "[\"a\", \"b", "nul", "[}", "{]",
+        "[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]",
+        "{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{}}}}}}}}}}}}}}}}}",
+        "123 456", "[1] 2", "\\", "[\\\"]",
+        "\"caf\xC3\xA9\"", "[\"\xE2\x82\xAC\", \"a\xF0\x9F\x98\x80\"]", "\"a\xC3\"", "\"\xED\xA0\x80\"", "{\"k\xFF\": 1}", "[\"a\tb\"]",
+        "\"0123456789abcdefghijklmnopqrstuvwxyz\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\xC0\xAF\"", "\"\xC3", "\"\\\xC3\xA9\"", "{\"\\\xC3\xA9\": \"\\\xC3\"}",
+    };
+
+    for (size_t engine = 0; engine < sizeof(engines) / sizeof(engines[0]); ++engine) {
+        for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+            const json_parser_result_t expected = parse_json(inputs[i]);
+            const size_t expected_count = test_call_stack.count;
+            const char* expected_names[128];
+            json_raw_string_t expected_strings[128];
+            memset(expected_strings, 0, sizeof(expected_strings));
+
+            for (size_t j = 0; j < expected_count; ++j) {
+                expected_names[j] = test_call_stack.entries[j].function_name;
+
+                if (strcmp(expected_names[j], "on_string") == 0 || strcmp(expected_names[j], "on_object_property") == 0) {
+                    memcpy(&expected_strings[j], test_call_stack.entries[j].parameter, sizeof(json_raw_string_t));
+                }
+            }
+
+            const json_parser_result_t actual = engines[engine](inputs[i]);
+
+            if (expected.code != actual.code || expected.position != actual.position) {
+                fprintf(stderr, "[INFO] Input: %s\n", inputs[i]);
+            }
+
+            ASSERT_INT(expected.code, actual.code);
+            ASSERT_INT(expected.context, actual.context);
+            ASSERT_INT(expected.error, actual.error);
+            ASSERT_INT(expected.extra, actual.extra);
+            ASSERT_INT(expected.position, actual.position);
+            ASSERT_INT(expected_count, test_call_stack.count);
+
+            for (size_t j = 0; j < expected_count; ++j) {
+                ASSERT_STR(expected_names[j], test_call_stack.entries[j].function_name);
+
+                if (expected_strings[j].value != nullptr) {
+                    const json_raw_string_t actual_string = *(json_raw_string_t*) test_call_stack.entries[j].parameter;
+                    ASSERT_INT(expected_strings[j].length, actual_string.length);
+                    ASSERT_TRUE(expected_strings[j].value == actual_string.value);
+                }
+            }
+        }
+    }
+}
+
+#define JSON_PARSER_NAME count_integers
+#define JSON_PARSER_HANDLER_TYPE size_t
+#define JSON_PARSER_ON_INTEGER(count, value) (*(count) += (value), json_create_success_result())
+#define JSON_PARSER_MAX_DEPTH 3
+#define JSON_PARSER_MAX_STRING_SIZE 4
+#include "../parser/parser_template.h"
+
+TEST(parser_template_instance) {
+    const char* json = "[1, 2.5, \"a\", true, null, 10]";
+    size_t sum = 0;
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, count_integers(strlen(json), json, &sum, (json_parser_options_t) { .max_depth = 100 }).code);
+    ASSERT_INT(11, sum);
+
+    const json_parser_result_t result = count_integers(5, "[[1]]", &sum, (json_parser_options_t) { .max_depth = 100 });
+    ASSERT_INT(JSON_PARSE_ERROR_MAX_DEPTH, result.code);
+    ASSERT_INT(2, result.position);
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, count_integers(5, "[-3 ]", &sum, (json_parser_options_t) {}).code);
+    ASSERT_INT(8, sum);
+    ASSERT_INT(JSON_PARSE_ERROR_INVALID_SYNTAX, count_integers(4, "[1 2", &sum, (json_parser_options_t) {}).code);
+
+    const json_parser_result_t string_result = count_integers(8, "[\"abcd\"]", &sum, (json_parser_options_t) { .max_string_size = 100 });
+    ASSERT_INT(JSON_PARSE_ERROR_MAX_STRING_SIZE, string_result.code);
+    ASSERT_INT(JSON_CONTEXT_STRING, string_result.context);
+    ASSERT_INT(5, string_result.position);
+    ASSERT_INT(JSON_PARSE_SUCCESS, count_integers(6, "[\"ab\"]", &sum, (json_parser_options_t) {}).code);
+}
+
+TEST(reader_tokens) {
+    const char* json = "{\"id\": 42, \"price\": -1.5e2, \"tags\": [\"a\\\"b\", true, null]}";
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+    json_reader_t reader;
+    json_token_t token;
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, json_reader_init(&reader, strlen(json), json, (json_parser_options_t) {}, JSON_PARSER_STACK_SIZE(32), stack).code);
+
+    ASSERT_INT(JSON_TOKEN_OBJECT_START, json_reader_next(&reader, &token));
+    ASSERT_TRUE(token.raw.value == json);
+    ASSERT_INT(1, token.raw.length);
+
+    ASSERT_INT(JSON_TOKEN_OBJECT_PROPERTY, json_reader_next(&reader, &token));
+    ASSERT_STRN("\"id\"", token.raw.value, token.raw.length);
+
+    ASSERT_INT(JSON_TOKEN_INTEGER, json_reader_next(&reader, &token));
+    ASSERT_INT(42, token.integer_value);
+    ASSERT_STRN("42", token.raw.value, token.raw.length);
+
+    ASSERT_INT(JSON_TOKEN_OBJECT_PROPERTY, json_reader_next(&reader, &token));
+    ASSERT_INT(JSON_TOKEN_NUMBER, json_reader_next(&reader, &token));
+    ASSERT_DOUBLE(-150.0, token.number_value, 0.0);
+    ASSERT_STRN("-1.5e2", token.raw.value, token.raw.length);
+
+    ASSERT_INT(JSON_TOKEN_OBJECT_PROPERTY, json_reader_next(&reader, &token));
+    ASSERT_INT(JSON_TOKEN_ARRAY_START, json_reader_next(&reader, &token));
+    ASSERT_INT(JSON_TOKEN_STRING, json_reader_next(&reader, &token));
+    ASSERT_STRN("\"a\\\"b\"", token.raw.value, token.raw.length);
+    ASSERT_INT(JSON_TOKEN_BOOL, json_reader_next(&reader, &token));
+    ASSERT_TRUE(token.bool_value);
+    ASSERT_INT(JSON_TOKEN_NULL, json_reader_next(&reader, &token));
+    ASSERT_INT(JSON_TOKEN_ARRAY_END, json_reader_next(&reader, &token));
+    ASSERT_INT(JSON_TOKEN_OBJECT_END, json_reader_next(&reader, &token));
+    ASSERT_TRUE(token.raw.value == json + strlen(json) - 1);
+
+    ASSERT_INT(JSON_TOKEN_END, json_reader_next(&reader, &token));
+    ASSERT_INT(JSON_TOKEN_END, json_reader_next(&reader, &token));
+    ASSERT_INT(JSON_PARSE_SUCCESS, reader.error.code);
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, json_reader_init(&reader, 3, "[1}", (json_parser_options_t) {}, JSON_PARSER_STACK_SIZE(32), stack).code);
+    ASSERT_INT(JSON_TOKEN_ARRAY_START, json_reader_next(&reader, &token));
+    ASSERT_INT(JSON_TOKEN_INTEGER, json_reader_next(&reader, &token));
+    ASSERT_INT(JSON_TOKEN_ERROR, json_reader_next(&reader, &token));
+    ASSERT_INT(JSON_TOKEN_ERROR, json_reader_next(&reader, &token));
+    ASSERT_INT(JSON_PARSE_ERROR_INVALID_SYNTAX, reader.error.code);
+    ASSERT_INT(2, reader.error.position);
+
+    ASSERT_INT(JSON_PARSE_CONFIG_ERROR, json_reader_init(&reader, 0, "", (json_parser_options_t) {}, JSON_PARSER_STACK_SIZE(32), stack).code);
+}
+
+TEST(indexed_parser_limits) {
+    {
+        char long_string[2049];
+        memset(long_string, 'a', 2047);
+        long_string[0] = '"';
+        long_string[2047] = '"';
+        long_string[2048] = '\0';
+
+        const json_parser_result_t result = parse_json_indexed(long_string);
+        ASSERT_INT(JSON_PARSE_ERROR_MAX_STRING_SIZE, result.code);
+        ASSERT_INT(JSON_CONTEXT_STRING, result.context);
+        ASSERT_INT(1024, result.position);
+    }
+
+    {
+        char large_array[2053];
+        large_array[0] = '[';
+        for (size_t i = 1; i < 2050; i += 2) {
+            large_array[i] = '0';
+            large_array[i + 1] = ',';
+        }
+        large_array[2051] = ']';
+        large_array[2052] = '\0';
+
+        json_parser_handler_t handler = {};
+        json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+        const json_parser_result_t result = json_parse_indexed(strlen(large_array), large_array, &handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack);
+        ASSERT_INT(JSON_PARSE_ERROR_MAX_STRUCT_SIZE, result.code);
+        ASSERT_INT(JSON_CONTEXT_ARRAY, result.context);
+        ASSERT_INT(1026, result.position);
+    }
+}
+
+TEST(iterative_parser_deep_nesting) {
+    // Far deeper than what the recursive parser can handle with the default C stack
+    constexpr size_t nesting = 200000;
+    char* json = malloc(2 * nesting);
+    memset(json, '[', nesting);
+    memset(json + nesting, ']', nesting);
+
+    json_parser_frame_t* stack = malloc(JSON_PARSER_STACK_SIZE(1000000) * sizeof(json_parser_frame_t));
+    json_parser_handler_t handler = {};
+
+    {
+        const json_parser_result_t result = json_parse_iterative(2 * nesting, json, &handler, (json_parser_options_t) { .max_depth = 1000000 }, JSON_PARSER_STACK_SIZE(1000000), stack);
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.code);
+    }
+
+    {
+        const json_parser_result_t result = json_parse_iterative(2 * nesting, json, &handler, (json_parser_options_t) { .max_depth = 1000 }, JSON_PARSER_STACK_SIZE(1000000), stack);
+        ASSERT_INT(JSON_PARSE_ERROR_MAX_DEPTH, result.code);
+        ASSERT_INT(500, result.position);
+    }
+
+    {
+        // The stack is smaller than the max depth
+        const json_parser_result_t result = json_parse_iterative(2 * nesting, json, &handler, (json_parser_options_t) { .max_depth = 1000000 }, 10, stack);
+        ASSERT_INT(JSON_PARSE_ERROR_MAX_DEPTH, result.code);
+        ASSERT_INT(JSON_ERROR_STACK_OVERFLOW, result.error);
+        ASSERT_INT(10, result.position);
+    }
+
+    {
+        const json_parser_result_t result = json_parse_iterative(2, "12", &handler, (json_parser_options_t) {}, 0, nullptr);
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.code);
+    }
+
+    {
+        const json_parser_result_t result = json_parse_indexed(2 * nesting, json, &handler, (json_parser_options_t) { .max_depth = 1000000 }, JSON_PARSER_STACK_SIZE(1000000), stack);
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.code);
+    }
+
+    {
+        const json_parser_result_t result = json_parse_indexed(2 * nesting, json, &handler, (json_parser_options_t) { .max_depth = 1000000 }, 10, stack);
+        ASSERT_INT(JSON_PARSE_ERROR_MAX_DEPTH, result.code);
+        ASSERT_INT(JSON_ERROR_STACK_OVERFLOW, result.error);
+        ASSERT_INT(10, result.position);
+    }
+
+    free(json);
+    free(stack);
+}
+
+/**
+ * Record the string with a copy of its content, as the push parser buffers do not outlive the parsing.
+ */
+static json_parser_result_t record_string_copy(const char* function_name, const json_raw_string_t value) {
+    json_raw_string_t* copy = malloc(sizeof(json_raw_string_t) + value.length);
+    char* content = (char*) (copy + 1);
+    memcpy(content, value.value, value.length);
+    memcpy(copy, &(json_raw_string_t) { .length = value.length, .value = content }, sizeof(json_raw_string_t));
+
+    test_call_stack.entries[test_call_stack.count].function_name = function_name;
+    test_call_stack.entries[test_call_stack.count].parameter = copy;
+
+    ++test_call_stack.count;
+
+    return json_create_success_result();
+}
+
+static json_parser_result_t on_string_copy(json_parser_handler_t* self, json_raw_string_t value) {
+    return record_string_copy("on_string", value);
+}
+
+static json_parser_result_t on_object_property_copy(json_parser_handler_t* self, json_raw_string_t key) {
+    return record_string_copy("on_object_property", key);
+}
+
+static json_parser_result_t parse_json_push(const char* json, const size_t chunk_size) {
+    json_parser_handler_t handler = init_handler();
+    handler.on_string = on_string_copy;
+    handler.on_object_property = on_object_property_copy;
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+    char buffer[JSON_PUSH_PARSER_BUFFER_SIZE(1024)];
+    json_push_parser_t parser;
+
+    const json_parser_result_t init_result = json_push_parser_init(&parser, &handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack, sizeof(buffer), buffer);
+
+    if (init_result.code != JSON_PARSE_SUCCESS) {
+        return init_result;
+    }
+
+    const size_t length = strlen(json);
+
+    for (size_t position = 0; position < length; position += chunk_size) {
+        // Copy the chunk, so strings split between chunks cannot be read from the input
+        char chunk[64];
+        const size_t current_size = length - position < chunk_size ? length - position : chunk_size;
+        memcpy(chunk, json + position, current_size);
+
+        const json_parser_result_t result = json_parser_feed(&parser, current_size, chunk);
+
+        if (result.code != JSON_PARSE_SUCCESS) {
+            return result;
+        }
+    }
+
+    return json_parser_finish(&parser);
+}
+
+TEST(push_parser_match_json_parse) {
+    const char* inputs[] = {
+        "123", "-12.5", "1e10", "null", "true", "false", "\"Hello, World!\"", "  \"\\\\\\\"\"  ", "\"a\\u00e9b\\n\"",
+        "[]", "{}", "[123, true]", "{\"foo\": 42}", " [ 1 , [ 2 , { \"a\" : [ ] } ] , \"x\" ] ",
+        "{\"a\\\"b\": \"c\\\\\", \"d\": [null, false, \"{[,:]}\"]}", "[1.5e3,-0,0.25,12345678901234567890]",
+        "[1,]", "[,1]", "[1 2]", "[12abc]", "[1-2]", "[1\"a\"]", "[\"a\"1]", "{\"a\":1,}", "{,}", "[01]", "[1.]",
+        "{]sdfdsfoi", "tr", "trsssssssssss", "[,]", "{test}", "{\"test\"}", "{\"test\":}", "  ", "[nul]", "[truex]",
+        "[", "{", "\"", "[1", "[1,", "{\"a\"", "{\"a\":", "{\"a\":1", "\"abc", "\"abc\\", "nul", "[}", "{]", "{1:2}",
+        "[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]",
+        "123 456", "[1] 2", "\\", "[\\\"]",
+        "\"caf\xC3\xA9\"", "[\"\xE2\x82\xAC\", \"a\xF0\x9F\x98\x80\"]", "\"a\xC3\"", "\"\xED\xA0\x80\"", "{\"k\xFF\": 1}", "[\"a\tb\"]",
+        "\"0123456789abcdefghijklmnopqrstuvwxyz\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\xC0\xAF\"", "\"\xC3", "\"\\\xC3\xA9\"", "{\"\\\xC3\xA9\": \"\\\xC3\"}",
+        "{\"name\": \"Alice\", \"tags\": [\"a\\\"b\", \"\\\\\", \"\\u00e9\"], \"scores\": [12.5, -314, 1e-3, 0], \"ok\": true, \"none\": null}",
+    };
+    const size_t chunk_sizes[] = { 1, 2, 3, 4, 5, 7, 64 };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        const json_parser_result_t expected = parse_json(inputs[i]);
+        const size_t expected_count = test_call_stack.count;
+        const char* expected_names[128];
+        char expected_strings[128][64];
+        memset(expected_strings, 0, sizeof(expected_strings));
+
+        for (size_t j = 0; j < expected_count; ++j) {
+            expected_names[j] = test_call_stack.entries[j].function_name;
+
+            if (strcmp(expected_names[j], "on_string") == 0 || strcmp(expected_names[j], "on_object_property") == 0) {
+                const json_raw_string_t string = *(json_raw_string_t*) test_call_stack.entries[j].parameter;
+                memcpy(expected_strings[j], string.value, string.length);
+            }
+        }
+
+        for (size_t chunk = 0; chunk < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++chunk) {
+            const json_parser_result_t actual = parse_json_push(inputs[i], chunk_sizes[chunk]);
+
+            if (expected.code != actual.code || expected.error != actual.error || expected.position != actual.position) {
+                fprintf(stderr, "[INFO] Input: %s, chunk size: %zu\n", inputs[i], chunk_sizes[chunk]);
+            }
+
+            ASSERT_INT(expected.code, actual.code);
+            ASSERT_INT(expected.context, actual.context);
+            ASSERT_INT(expected.error, actual.error);
+            ASSERT_INT(expected.position, actual.position);
+
+            if (expected.code != JSON_PARSE_SUCCESS) {
+                continue;
+            }
+
+            ASSERT_INT(expected_count, test_call_stack.count);
+
+            for (size_t j = 0; j < expected_count; ++j) {
+                ASSERT_STR(expected_names[j], test_call_stack.entries[j].function_name);
+
+                if (expected_strings[j][0] != '\0') {
+                    const json_raw_string_t actual_string = *(json_raw_string_t*) test_call_stack.entries[j].parameter;
+                    ASSERT_STRN(expected_strings[j], actual_string.value, actual_string.length);
+                }
+            }
+        }
+    }
+}
+
+TEST(push_parser_limits) {
+    {
+        char long_string[2049];
+        memset(long_string, 'a', 2047);
+        long_string[0] = '"';
+        long_string[2047] = '"';
+        long_string[2048] = '\0';
+
+        const json_parser_result_t result = parse_json_push(long_string, 7);
+        ASSERT_INT(JSON_PARSE_ERROR_MAX_STRING_SIZE, result.code);
+        ASSERT_INT(JSON_CONTEXT_STRING, result.context);
+        ASSERT_INT(1024, result.position);
+    }
+
+    {
+        // Numbers are only limited by the parser buffer
+        char long_number[2049];
+        memset(long_number, '1', 2048);
+        long_number[2048] = '\0';
+
+        const json_parser_result_t result = parse_json_push(long_number, 64);
+        ASSERT_INT(JSON_PARSE_ERROR_MAX_STRING_SIZE, result.code);
+        ASSERT_INT(JSON_CONTEXT_NUMBER, result.context);
+        ASSERT_INT(1025, result.position);
+    }
+
+    {
+        json_parser_handler_t handler = {};
+        json_push_parser_t parser;
+        char buffer[1024];
+
+        const json_parser_result_t result = json_push_parser_init(&parser, &handler, (json_parser_options_t) {32, 1024, 1024 }, 0, nullptr, sizeof(buffer), buffer);
+        ASSERT_INT(JSON_PARSE_CONFIG_ERROR, result.code);
+        ASSERT_INT(JSON_ERROR_INVALID_MAX_STRING_SIZE, result.error);
+    }
+
+    {
+        // The error is kept after a failure
+        json_parser_handler_t handler = {};
+        json_push_parser_t parser;
+        char buffer[JSON_PUSH_PARSER_BUFFER_SIZE(1024)];
+
+        ASSERT_INT(JSON_PARSE_SUCCESS, json_push_parser_init(&parser, &handler, (json_parser_options_t) {32, 1024, 1024 }, 0, nullptr, sizeof(buffer), buffer).code);
+        ASSERT_INT(JSON_PARSE_SUCCESS, json_parser_feed(&parser, 2, "  ").code);
+
+        const json_parser_result_t result = json_parser_feed(&parser, 3, "[1]");
+        ASSERT_INT(JSON_PARSE_ERROR_MAX_DEPTH, result.code);
+        ASSERT_INT(JSON_ERROR_STACK_OVERFLOW, result.error);
+        ASSERT_INT(2, result.position);
+        ASSERT_INT(JSON_PARSE_ERROR_MAX_DEPTH, json_parser_feed(&parser, 1, "1").code);
+        ASSERT_INT(JSON_PARSE_ERROR_MAX_DEPTH, json_parser_finish(&parser).code);
+    }
+}
+
+/**
+ * Reference implementation of the structural index, one character at a time.
+ */
+static size_t reference_structural_index(const char* json, const size_t length, size_t positions[]) {
+    size_t count = 0;
+    bool in_string = false;
+    bool escaped = false;
+    bool previous_separator = true;
+
+    for (size_t i = 0; i < length; ++i) {
+        const char c = json[i];
+
+        if (in_string) {
+            if (escaped) {
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+            } else if (c == '"') {
+                in_string = false;
+                positions[count++] = i;
+                previous_separator = true;
+            }
+
+            continue;
+        }
+
+        const bool is_escaped = escaped;
+        escaped = !escaped && c == '\\';
+
+        if (c == '"' && !is_escaped) {
+            in_string = true;
+            positions[count++] = i;
+            continue;
+        }
+
+        const bool is_structural = c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+        const bool is_whitespace = c == ' ' || c == '\n' || c == '\r' || c == '\t';
+
+        if (is_structural || (!is_whitespace && c != '"' && previous_separator)) {
+            positions[count++] = i;
+        }
+
+        previous_separator = is_structural || is_whitespace;
+    }
+
+    return count;
+}
+
+TEST(structural_index_match_reference_implementation) {
+    const char alphabet[] = { '"', '"', '\\', '\\', '[', ']', '{', '}', ':', ',', ' ', '\n', 'a', '1', 'e' };
+    static char json[10000];
+    static size_t expected[10000];
+    uint32_t seed = 42;
+
+    for (size_t run = 0; run < 20; ++run) {
+        const size_t length = run < 10 ? 100 + run * 37 : sizeof(json) - run;
+
+        for (size_t i = 0; i < length; ++i) {
+            seed = seed * 1103515245 + 12345;
+            json[i] = alphabet[(seed >> 16) % sizeof(alphabet)];
+        }
+
+        const size_t expected_count = reference_structural_index(json, length, expected);
+        json_structural_index_t index;
+        json_structural_index_init(&index, length, json);
+
+        size_t position = 0;
+
+        for (size_t i = 0; i < expected_count; ++i) {
+            position = json_structural_index_next(&index, position);
+            ASSERT_INT(expected[i], position);
+            ++position;
+        }
+
+        ASSERT_INT(length, json_structural_index_next(&index, position));
+    }
+}
+
+static json_parser_result_t validate_json(const char* json) {
+    return json_validate(strlen(json), json, (json_parser_options_t) {32, 1024, 1024 });
+}
+
+TEST(validate_valid_documents) {
+    const char* inputs[] = {
+        "0", "-0", "-0.5e-3", "12E+4", "1.25", "null", "true", "false", "\"\"", " \t\r\n[] \n", "{}",
+        "\"\\\"\\\\\\/\\b\\f\\n\\r\\t\\u00e9\\uD83D\\uDE00\"",
+        "\"caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80 \xF4\x8F\xBF\xBF \xED\x9F\xBF\"",
+        "{\"a\": [1, {\"b\": null}, [[]], \"\xC3\xA9\"], \"c\": {\"d\": true}}",
+        "[\"a very long string, longer than a SIMD block, to use the vectorized scanner: \xC3\xA9\xC3\xA9\xC3\xA9\"]",
+    };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        const json_parser_result_t result = validate_json(inputs[i]);
+
+        if (result.code != JSON_PARSE_SUCCESS) {
+            fprintf(stderr, "[INFO] Input: %s\n", inputs[i]);
+        }
+
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.code);
+    }
+}
+
+TEST(validate_invalid_documents) {
+    const struct {
+        const char* json;
+        json_parse_code_t code;
+        json_parse_error_t error;
+        size_t position;
+    } inputs[] = {
+        { "[1,]", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_UNEXPECTED_CHARACTER, 3 },
+        { "{\"a\":1,}", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_UNEXPECTED_CHARACTER, 7 },
+        { "123 456", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_UNEXPECTED_CHARACTER, 4 },
+        { "[1] 2", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_UNEXPECTED_CHARACTER, 4 },
+        { "01", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_UNEXPECTED_CHARACTER, 1 },
+        { "[1.]", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_UNEXPECTED_CHARACTER, 3 },
+        { "1e", JSON_PARSE_ERROR_UNEXPECTED_END, JSON_ERROR_TOO_SMALL, 2 },
+        { "-", JSON_PARSE_ERROR_UNEXPECTED_END, JSON_ERROR_TOO_SMALL, 1 },
+        { "[-a]", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_UNEXPECTED_CHARACTER, 2 },
+        { "\"\\x\"", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_UNEXPECTED_CHARACTER, 2 },
+        { "\"\\u12G4\"", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_UNEXPECTED_CHARACTER, 5 },
+        { "\"\\\xC3\xA9\"", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_UNEXPECTED_CHARACTER, 2 },
+        { "\"a\tb\"", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_UNEXPECTED_CHARACTER, 2 },
+        { "\"\xC0\xAF\"", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_INVALID_UTF8, 1 },
+        { "\"ab\xE0\x80\xAF\"", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_INVALID_UTF8, 3 },
+        { "\"\xED\xA0\x80\"", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_INVALID_UTF8, 1 },
+        { "\"\xF4\x90\x80\x80\"", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_INVALID_UTF8, 1 },
+        { "\"\xF5\x80\x80\x80\"", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_INVALID_UTF8, 1 },
+        { "\"\x80\"", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_INVALID_UTF8, 1 },
+        { "\"\xE2\x82\"", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_INVALID_UTF8, 1 },
+        { "\"\xE2\x82", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_INVALID_UTF8, 1 },
+        { "{\"k\xFF\": 1}", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_INVALID_UTF8, 3 },
+        { "{\"a\" 1}", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_UNEXPECTED_CHARACTER, 5 },
+        { "{1: 2}", JSON_PARSE_ERROR_INVALID_SYNTAX, JSON_ERROR_UNEXPECTED_CHARACTER, 1 },
+    };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        const json_parser_result_t result = validate_json(inputs[i].json);
+
+        if (result.code != inputs[i].code || result.position != inputs[i].position) {
+            fprintf(stderr, "[INFO] Input: %s\n", inputs[i].json);
+        }
+
+        ASSERT_INT(inputs[i].code, result.code);
+        ASSERT_INT(inputs[i].error, result.error);
+        ASSERT_INT(inputs[i].position, result.position);
+    }
+
+    ASSERT_INT(JSON_ERROR_NULL_POINTER, json_validate(0, nullptr, (json_parser_options_t) {}).error);
+    ASSERT_STR(
+        "Syntax error: Invalid UTF-8 sequence at position 1 while parsing string value",
+        json_parse_error_message(validate_json("\"\xFF\""))
+    );
+}
+
+TEST(validate_match_json_parse) {
+    // Inputs valid for both, or rejected by both for the same reason. The error details may differ.
+    const char* inputs[] = {
+        "123", "-12.5", "null", "true", "false", "\"Hello, World!\"", "  \"\\\\\\\"\"  ",
+        "[]", "{}", "[123, true]", "{\"foo\": 42}", " [ 1 , [ 2 , { \"a\" : [ ] } ] , \"x\" ] ",
+        "{\"a\\\"b\": \"c\\\\\", \"d\": [null, false, \"{[,:]}\"]}",
+        "[,1]", "[1 2]", "[12abc]", "[1-2]", "[1\"a\"]", "[\"a\"1]", "{,}",
+        "{]sdfdsfoi", "tr", "trsssssssssss", "[,]", "{test}", "{\"test\"}", "{\"test\":}", "  ", "[", "{",
+        "[1", "[1,", "{\"a\"", "{\"a\":", "{\"a\":1", "\"abc", "\"abc\\", "\"", "[\"a\", \"b", "nul", "[}",
+        "[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]",
+        "[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]", "[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]",
+        "{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{}}}}}}}}}}}}}}}}}",
+        "\\", "[\\\"]",
+    };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        const json_parser_result_t expected = parse_json_no_handler(inputs[i]);
+        const json_parser_result_t actual = validate_json(inputs[i]);
+
+        if (expected.code != actual.code) {
+            fprintf(stderr, "[INFO] Input: %s\n", inputs[i]);
+        }
+
+        ASSERT_INT(expected.code, actual.code);
+    }
+}
+
+TEST(validate_limits) {
+    char json[5128];
+
+    // Same inputs as the max_*_exceeded tests
+    memset(json, 'a', 2047);
+    json[0] = '"';
+    json[2047] = '"';
+    json[2048] = '\0';
+    ASSERT_INT(JSON_PARSE_ERROR_MAX_STRING_SIZE, validate_json(json).code);
+    ASSERT_INT(1024, validate_json(json).position);
+
+    json[1023] = '"';
+    json[1024] = '\0';
+    ASSERT_INT(JSON_PARSE_SUCCESS, validate_json(json).code);
+
+    json[0] = '[';
+    for (size_t i = 1; i < 2050; i += 2) {
+        json[i] = '0';
+        json[i + 1] = ',';
+    }
+    json[2050] = '0';
+    json[2051] = ']';
+    json[2052] = '\0';
+    ASSERT_INT(parse_json_no_handler(json).code, validate_json(json).code);
+    ASSERT_INT(parse_json_no_handler(json).position, validate_json(json).position);
+
+    json[0] = '{';
+    for (size_t i = 1; i < 5125; i += 5) {
+        memcpy(json + i, "\"\":0,", 5);
+    }
+    json[5125] = '0';
+    json[5126] = '}';
+    json[5127] = '\0';
+    ASSERT_INT(parse_json_no_handler(json).code, validate_json(json).code);
+    ASSERT_INT(parse_json_no_handler(json).position, validate_json(json).position);
+}
+
+TEST(string_strict_scanner_match_scalar_implementation) {
+    const char specials[] = { '"', '\\', '\n', '\0', 0x1F, (char) 0x80, (char) 0xC3, (char) 0xFF };
+    char buffer[160];
+
+    for (size_t special = 0; special < sizeof(specials); ++special) {
+        for (size_t special_position = 0; special_position < sizeof(buffer); special_position += 3) {
+            // Use all printable ASCII characters as regular characters
+            for (size_t i = 0; i < sizeof(buffer); ++i) {
+                buffer[i] = (char) (0x20 + (i * 37) % 0x60);
+
+                if (buffer[i] == '"' || buffer[i] == '\\' || buffer[i] == 0x7F) {
+                    buffer[i] = 'a';
+                }
+            }
+
+            buffer[special_position] = specials[special];
+
+            for (size_t start = 0; start < 40; ++start) {
+                for (size_t end = start; end <= sizeof(buffer); end += 7) {
+                    ASSERT_INT(
+                        json_scan_string_strict_scalar(buffer, start, end),
+                        json_scan_string_strict(buffer, start, end)
+                    );
+                }
+            }
+        }
+    }
+}
+
+TEST(utf8_string_scanner_match_scalar_implementation) {
+    // Valid sequences of each length, invalid or truncated ones, and special characters
+    const char* pieces[] = {
+        "a", "0123456789", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xF4\x8F\xBF\xBF", "\xED\x9F\xBF", "\xEF\xBF\xBF",
+        "\x80", "\xC0\xAF", "\xE0\x80\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xF5", "\xFF", "\xC3", "\xE2\x82", "\xF0\x9F\x98",
+        "\"", "\\\\", "\n",
+    };
+    constexpr size_t valid_pieces = 8;
+    char buffer[200];
+    uint32_t seed = 42;
+
+    for (size_t run = 0; run < 2000; ++run) {
+        size_t length = 0;
+
+        // Mostly valid text, with a few invalid pieces
+        while (length < sizeof(buffer) - 10) {
+            seed = seed * 1103515245 + 12345;
+            const size_t piece = (seed >> 16) % 64 == 0
+                ? valid_pieces + (seed >> 8) % (sizeof(pieces) / sizeof(pieces[0]) - valid_pieces)
+                : (seed >> 16) % valid_pieces
+            ;
+            const size_t piece_length = strlen(pieces[piece]);
+
+            memcpy(buffer + length, pieces[piece], piece_length);
+            length += piece_length;
+        }
+
+        for (size_t start = 0; start < 4; ++start) {
+            for (size_t end = start; end <= length; end += 13) {
+                ASSERT_INT(
+                    json_scan_string_utf8_scalar(buffer, start, end),
+                    json_scan_string_utf8(buffer, start, end)
+                );
+            }
+
+            ASSERT_INT(
+                json_scan_string_utf8_scalar(buffer, start, length),
+                json_scan_string_utf8(buffer, start, length)
+            );
+        }
+    }
+}
+
+static bool is_skipped_key(const json_raw_string_t key) {
+    return key.length >= 5 && memcmp(key.value, "\"skip", 5) == 0;
+}
+
+static json_parser_result_t on_object_property_skip(json_parser_handler_t* self, json_raw_string_t key) {
+    on_object_property(self, key);
+
+    return is_skipped_key(key) ? json_create_skip_result() : json_create_success_result();
+}
+
+static json_parser_result_t on_object_property_copy_skip(json_parser_handler_t* self, json_raw_string_t key) {
+    on_object_property_copy(self, key);
+
+    return is_skipped_key(key) ? json_create_skip_result() : json_create_success_result();
+}
+
+static json_parser_result_t on_array_start_skip(json_parser_handler_t* self) {
+    on_array_start(self);
+
+    return json_create_skip_result();
+}
+
+static json_parser_result_t on_object_start_skip(json_parser_handler_t* self) {
+    on_object_start(self);
+
+    return json_create_skip_result();
+}
+
+/**
+ * Handler skipping all arrays, and the values of the properties starting with "skip"
+ */
+static json_parser_handler_t init_skip_handler() {
+    json_parser_handler_t handler = init_handler();
+    handler.on_array_start = on_array_start_skip;
+    handler.on_object_property = on_object_property_skip;
+
+    return handler;
+}
+
+static json_parser_result_t parse_json_skip(const char* json) {
+    json_parser_handler_t handler = init_skip_handler();
+
+    return json_parse(strlen(json), json, &handler, (json_parser_options_t) {32, 1024, 1024 });
+}
+
+TEST(parse_skip_values) {
+    {
+        const json_parser_result_t result = parse_json_skip("{\"a\": 1, \"skip\": {\"x\": [1, \"]}\", {\"y\": \"\\\"}\"}]}, \"b\": [1, [2]], \"c\": true}");
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.code);
+        ASSERT_INT(9, test_call_stack.count);
+        ASSERT_STR("on_object_start", test_call_stack.entries[0].function_name);
+        ASSERT_STR("on_object_property", test_call_stack.entries[1].function_name);
+        ASSERT_STR("on_number", test_call_stack.entries[2].function_name);
+        ASSERT_STR("on_object_property", test_call_stack.entries[3].function_name);
+        ASSERT_STR("on_object_property", test_call_stack.entries[4].function_name);
+        ASSERT_STR("on_array_start", test_call_stack.entries[5].function_name);
+        ASSERT_STR("on_object_property", test_call_stack.entries[6].function_name);
+        ASSERT_STR("on_bool", test_call_stack.entries[7].function_name);
+        ASSERT_STR("on_object_end", test_call_stack.entries[8].function_name);
+    }
+
+    {
+        // Scalars are skipped without being parsed
+        const json_parser_result_t result = parse_json_skip("{\"skip1\": \"a\\\"b\", \"skip2\": 12.5e3 , \"skip3\": tru, \"d\": null}");
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.code);
+        ASSERT_INT(7, test_call_stack.count);
+        ASSERT_STR("on_object_property", test_call_stack.entries[4].function_name);
+        ASSERT_STR("on_null", test_call_stack.entries[5].function_name);
+        ASSERT_STR("on_object_end", test_call_stack.entries[6].function_name);
+    }
+
+    {
+        // The content of the skipped values is not checked, nor counted in the limits
+        const json_parser_result_t result = parse_json_skip("{\"skip\": [tru, {], [[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]], \"a\": 1}");
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.code);
+        ASSERT_INT(5, test_call_stack.count);
+    }
+
+    {
+        json_parser_handler_t handler = init_handler();
+        handler.on_object_start = on_object_start_skip;
+        const char* json = "{\"a\": [1, 2], \"b\": {}} trailing";
+
+        const json_parser_result_t result = json_parse(strlen(json), json, &handler, (json_parser_options_t) {});
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.code);
+        ASSERT_INT(1, test_call_stack.count);
+        ASSERT_STR("on_object_start", test_call_stack.entries[0].function_name);
+    }
+
+    {
+        const json_parser_result_t result = parse_json_skip("[1, \"]\", [2, 3]");
+        ASSERT_INT(JSON_PARSE_ERROR_UNEXPECTED_END, result.code);
+        ASSERT_INT(JSON_CONTEXT_ARRAY, result.context);
+        ASSERT_INT(JSON_ERROR_MISSING_CLOSING_CHARACTER, result.error);
+        ASSERT_CHAR(']', result.extra);
+        ASSERT_INT(15, result.position);
+    }
+
+    {
+        const json_parser_result_t result = parse_json_skip("{\"skip\": \"abc\\\"}");
+        ASSERT_INT(JSON_PARSE_ERROR_UNEXPECTED_END, result.code);
+        ASSERT_INT(JSON_CONTEXT_STRING, result.context);
+        ASSERT_INT(JSON_ERROR_MISSING_CLOSING_CHARACTER, result.error);
+        ASSERT_INT(16, result.position);
+    }
+
+    {
+        const json_parser_result_t result = parse_json_skip("{\"skip\": , \"a\": 1}");
+        ASSERT_INT(JSON_PARSE_ERROR_INVALID_SYNTAX, result.code);
+        ASSERT_INT(JSON_ERROR_UNEXPECTED_CHARACTER, result.error);
+        ASSERT_INT(9, result.position);
+    }
+
+    {
+        // The skip result is only supported by the property and structure start handlers
+        json_parser_handler_t handler = init_handler();
+        handler.on_null = on_object_start_skip;
+
+        const json_parser_result_t result = json_parse(6, "[null]", &handler, (json_parser_options_t) {});
+        ASSERT_INT(JSON_PARSE_CONFIG_ERROR, result.code);
+        ASSERT_INT(JSON_ERROR_INVALID_CODE, result.error);
+    }
+}
+
+#define JSON_PARSER_NAME parse_json_skip_specialized_instance
+#define JSON_PARSER_HANDLER_TYPE json_parser_handler_t
+#define JSON_PARSER_ON_NULL(handler) on_null(handler)
+#define JSON_PARSER_ON_BOOL(handler, value) on_bool(handler, value)
+#define JSON_PARSER_ON_NUMBER(handler, value) on_number(handler, value)
+#define JSON_PARSER_ON_STRING(handler, value) on_string(handler, value)
+#define JSON_PARSER_ON_ARRAY_START(handler) on_array_start_skip(handler)
+#define JSON_PARSER_ON_ARRAY_END(handler) on_array_end(handler)
+#define JSON_PARSER_ON_OBJECT_START(handler) on_object_start(handler)
+#define JSON_PARSER_ON_OBJECT_PROPERTY(handler, key) on_object_property_skip(handler, key)
+#define JSON_PARSER_ON_OBJECT_END(handler) on_object_end(handler)
+#include "../parser/parser_template.h"
+
+static json_parser_result_t parse_json_skip_specialized(const char* json, const size_t) {
+    json_parser_handler_t handler = init_handler();
+
+    return parse_json_skip_specialized_instance(strlen(json), json, &handler, (json_parser_options_t) {32, 1024, 1024 });
+}
+
+static json_parser_result_t parse_json_skip_indexed(const char* json, const size_t) {
+    json_parser_handler_t handler = init_skip_handler();
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+
+    return json_parse_indexed(strlen(json), json, &handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack);
+}
+
+static json_parser_result_t parse_json_skip_iterative(const char* json, const size_t) {
+    json_parser_handler_t handler = init_skip_handler();
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+
+    return json_parse_iterative(strlen(json), json, &handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack);
+}
+
+static json_parser_result_t parse_json_skip_push(const char* json, const size_t chunk_size) {
+    json_parser_handler_t handler = init_skip_handler();
+    handler.on_string = on_string_copy;
+    handler.on_object_property = on_object_property_copy_skip;
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+    char buffer[JSON_PUSH_PARSER_BUFFER_SIZE(1024)];
+    json_push_parser_t parser;
+
+    const json_parser_result_t init_result = json_push_parser_init(&parser, &handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack, sizeof(buffer), buffer);
+
+    if (init_result.code != JSON_PARSE_SUCCESS) {
+        return init_result;
+    }
+
+    const size_t length = strlen(json);
+
+    for (size_t position = 0; position < length; position += chunk_size) {
+        const size_t current_size = length - position < chunk_size ? length - position : chunk_size;
+        const json_parser_result_t result = json_parser_feed(&parser, current_size, json + position);
+
+        if (result.code != JSON_PARSE_SUCCESS) {
+            return result;
+        }
+    }
+
+    return json_parser_finish(&parser);
+}
+
+TEST(skip_engines_match_json_parse) {
+    json_parser_result_t (*engines[])(const char*, size_t) = { parse_json_skip_specialized, parse_json_skip_indexed, parse_json_skip_iterative, parse_json_skip_push };
+    const size_t chunk_sizes[] = { 1, 2, 3, 5, 7, 64, 1000 };
+
+    const char* inputs[] = {
+        "[1, 2]", "[1, 2", "{\"a\": [1, {\"b\": 2}], \"c\": 3}", "{\"skip\": 1}", "{\"skip\": 1, \"a\": \"x\"}", "{\"skip\":\"x\",\"a\":2}",
+        "{\"skip\": {\"a\": [1, \"]}\\\"\"]}, \"b\": null}", "{\"skip\": \"a\\\\\", \"b\": false}", "{\"skip\": \"\\\\\\\"]\", \"b\": [3]}",
+        "{\"skip\": [\"\\\\\\\\\", \"}\"], \"b\": {\"skip2\": -1.5e3, \"c\": true}}", "{\"skip\": tru , \"a\": 1}",
+        "{\"skip\": [[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]}",
+        "{\"skip\": ", "{\"skip\": {", "{\"skip\": \"abc", "{\"skip\": \"abc\\", "{\"skip\": , \"a\": 1}", "{\"skip\"}", "{\"skip\": 1",
+        "[\"\\\"", "{\"a\": [\"\\\\\", \"\\\"]\"}",
+        "{\"skip\": {\"long\": \"0123456789012345678901234567890123456789012345678901234567890123456789\\\\\\\\\\\"}\"}, \"z\": 1}",
+    };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        const json_parser_result_t expected = parse_json_skip(inputs[i]);
+        const size_t expected_count = test_call_stack.count;
+        const char* expected_names[128];
+
+        for (size_t j = 0; j < expected_count; ++j) {
+            expected_names[j] = test_call_stack.entries[j].function_name;
+        }
+
+        for (size_t engine = 0; engine < sizeof(engines) / sizeof(engines[0]); ++engine) {
+            for (size_t chunk = 0; chunk < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++chunk) {
+                const json_parser_result_t actual = engines[engine](inputs[i], chunk_sizes[chunk]);
+
+                if (expected.code != actual.code || expected.position != actual.position || expected_count != test_call_stack.count) {
+                    fprintf(stderr, "[INFO] Input: %s, engine: %zu, chunk size: %zu\n", inputs[i], engine, chunk_sizes[chunk]);
+                }
+
+                ASSERT_INT(expected.code, actual.code);
+                ASSERT_INT(expected.context, actual.context);
+                ASSERT_INT(expected.error, actual.error);
+                ASSERT_INT(expected.extra, actual.extra);
+                ASSERT_INT(expected.position, actual.position);
+                ASSERT_INT(expected_count, test_call_stack.count);
+
+                for (size_t j = 0; j < expected_count; ++j) {
+                    ASSERT_STR(expected_names[j], test_call_stack.entries[j].function_name);
+                }
+            }
+        }
+    }
+}
+
+static json_parser_result_t on_null_skip(json_parser_handler_t* self) {
+    on_null(self);
+
+    return json_create_skip_result();
+}
+
+static json_parser_result_t on_string_skip(json_parser_handler_t* self, json_raw_string_t value) {
+    on_string_copy(self, value);
+
+    return json_create_skip_result();
+}
+
+static json_parser_result_t on_array_end_skip(json_parser_handler_t* self) {
+    on_array_end(self);
+
+    return json_create_skip_result();
+}
+
+/**
+ * Handler returning a skip result from handlers which do not support it
+ */
+static json_parser_handler_t init_unsupported_skip_handler() {
+    json_parser_handler_t handler = init_handler();
+    handler.on_null = on_null_skip;
+    handler.on_string = on_string_skip;
+    handler.on_array_end = on_array_end_skip;
+
+    return handler;
+}
+
+static json_parser_result_t parse_json_unsupported_skip_indexed(const char* json, const size_t) {
+    json_parser_handler_t handler = init_unsupported_skip_handler();
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+
+    return json_parse_indexed(strlen(json), json, &handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack);
+}
+
+static json_parser_result_t parse_json_unsupported_skip_iterative(const char* json, const size_t) {
+    json_parser_handler_t handler = init_unsupported_skip_handler();
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+
+    return json_parse_iterative(strlen(json), json, &handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack);
+}
+
+static json_parser_result_t parse_json_unsupported_skip_push(const char* json, const size_t chunk_size) {
+    json_parser_handler_t handler = init_unsupported_skip_handler();
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+    char buffer[JSON_PUSH_PARSER_BUFFER_SIZE(1024)];
+    json_push_parser_t parser;
+
+    const json_parser_result_t init_result = json_push_parser_init(&parser, &handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack, sizeof(buffer), buffer);
+
+    if (init_result.code != JSON_PARSE_SUCCESS) {
+        return init_result;
+    }
+
+    const size_t length = strlen(json);
+
+    for (size_t position = 0; position < length; position += chunk_size) {
+        const size_t current_size = length - position < chunk_size ? length - position : chunk_size;
+        const json_parser_result_t result = json_parser_feed(&parser, current_size, json + position);
+
+        if (result.code != JSON_PARSE_SUCCESS) {
+            return result;
+        }
+    }
+
+    return json_parser_finish(&parser);
+}
+
+TEST(unsupported_skip_engines_match_json_parse) {
+    json_parser_result_t (*engines[])(const char*, size_t) = { parse_json_unsupported_skip_indexed, parse_json_unsupported_skip_iterative, parse_json_unsupported_skip_push };
+    const size_t chunk_sizes[] = { 1, 3, 1000 };
+    const char* inputs[] = { "null", "[null]", "[1, [true, null], 2]", "\"a\"", "[1, \"a\"]", "{\"a\": \"b\"}", "[]", "[[1], 2]", "{\"a\": []}" };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        json_parser_handler_t handler = init_unsupported_skip_handler();
+        const json_parser_result_t expected = json_parse(strlen(inputs[i]), inputs[i], &handler, (json_parser_options_t) {32, 1024, 1024 });
+        const size_t expected_count = test_call_stack.count;
+
+        ASSERT_INT(JSON_PARSE_CONFIG_ERROR, expected.code);
+        ASSERT_INT(JSON_ERROR_INVALID_CODE, expected.error);
+        ASSERT_INT(JSON_PARSE_SKIP, expected.extra);
+
+        for (size_t engine = 0; engine < sizeof(engines) / sizeof(engines[0]); ++engine) {
+            for (size_t chunk = 0; chunk < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++chunk) {
+                const json_parser_result_t actual = engines[engine](inputs[i], chunk_sizes[chunk]);
+
+                if (expected.code != actual.code || expected.position != actual.position) {
+                    fprintf(stderr, "[INFO] Input: %s, engine: %zu, chunk size: %zu\n", inputs[i], engine, chunk_sizes[chunk]);
+                }
+
+                ASSERT_INT(expected.code, actual.code);
+                ASSERT_INT(expected.context, actual.context);
+                ASSERT_INT(expected.error, actual.error);
+                ASSERT_INT(expected.extra, actual.extra);
+                ASSERT_INT(expected.position, actual.position);
+                ASSERT_INT(expected_count, test_call_stack.count);
+            }
+        }
+    }
+}
+
+TEST(bracket_scanner_match_scalar_implementation) {
+    const char alphabet[] = { '"', '\\', '[', ']', '{', '}', 'z', 'a', 0x5B | 0x20, ' ', (char) 0xDB, (char) 0xFD };
+    char block[JSON_BLOCK_SIZE];
+    uint32_t seed = 42;
+
+    for (size_t run = 0; run < 1000; ++run) {
+        for (size_t i = 0; i < sizeof(block); ++i) {
+            seed = seed * 1103515245 + 12345;
+            block[i] = alphabet[(seed >> 16) % sizeof(alphabet)];
+        }
+
+        const json_bracket_masks_t expected = json_scan_brackets_scalar(block);
+        const json_bracket_masks_t actual = json_scan_brackets(block);
+
+        ASSERT_TRUE(expected.quote == actual.quote);
+        ASSERT_TRUE(expected.backslash == actual.backslash);
+        ASSERT_TRUE(expected.open == actual.open);
+        ASSERT_TRUE(expected.close == actual.close);
+    }
+}
+
+TEST(value_scanner_match_scalar_implementation) {
+    const char alphabet[] = { '"', '\\', '[', ']', '{', '}', ':', ',', 'z', 'a', 0x5B | 0x20, 0x3A | 0x20, ' ', '\n', '\t', '\r', (char) 0xDB, (char) 0xFD };
+    char block[JSON_BLOCK_SIZE];
+    uint32_t seed = 42;
+
+    for (size_t run = 0; run < 1000; ++run) {
+        for (size_t i = 0; i < sizeof(block); ++i) {
+            seed = seed * 1103515245 + 12345;
+            block[i] = alphabet[(seed >> 16) % sizeof(alphabet)];
+        }
+
+        const json_value_masks_t expected = json_scan_values_scalar(block);
+        const json_value_masks_t actual = json_scan_values(block);
+
+        ASSERT_TRUE(expected.quote == actual.quote);
+        ASSERT_TRUE(expected.backslash == actual.backslash);
+        ASSERT_TRUE(expected.open == actual.open);
+        ASSERT_TRUE(expected.colon == actual.colon);
+        ASSERT_TRUE(expected.separator == actual.separator);
+    }
+}
+
+/**
+ * Reference implementation of `json_structural_index_skip()`, one character at a time.
+ */
+static size_t reference_structural_skip(const char* json, const size_t length, const size_t position) {
+    size_t depth = 1;
+    bool in_string = false;
+    bool escaped = false;
+
+    for (size_t i = position; i < length; ++i) {
+        const char c = json[i];
+        const bool is_escaped = escaped;
+        escaped = !escaped && c == '\\';
+
+        // Like the structural index, backslashes only escape quotes
+        if (c == '"' && !is_escaped) {
+            in_string = !in_string;
+        } else if (!in_string && (c == '[' || c == '{')) {
+            ++depth;
+        } else if (!in_string && (c == ']' || c == '}') && --depth == 0) {
+            return i + 1;
+        }
+    }
+
+    return length;
+}
+
+TEST(structural_skip_match_reference_implementation) {
+    // Mostly opening brackets, so the structures are not closed too early
+    const char alphabet[] = { '"', '\\', '\\', '[', '[', '[', '{', '{', '}', ']', 'a', ' ' };
+    static char json[5000];
+    uint32_t seed = 42;
+
+    for (size_t run = 0; run < 200; ++run) {
+        const size_t length = 10 + run * 23;
+
+        for (size_t i = 0; i < length; ++i) {
+            seed = seed * 1103515245 + 12345;
+            json[i] = alphabet[(seed >> 16) % sizeof(alphabet)];
+        }
+
+        // Close all the structures at the end
+        memset(json + length, ']', sizeof(json) - length);
+
+        const size_t start = run % 7;
+        const size_t expected = reference_structural_skip(json, sizeof(json), start);
+
+        {
+            json_structural_skip_t skip = { .depth = 1 };
+            const size_t actual = json_structural_index_skip(&skip, sizeof(json), json, start);
+
+            ASSERT_INT(expected, actual);
+            ASSERT_INT(expected == sizeof(json) ? 1 : 0, skip.depth > 0);
+        }
+
+        {
+            // Feed by chunks, relative to the chunk start
+            json_structural_skip_t skip = { .depth = 1 };
+            const size_t chunk_size = 1 + run % 97;
+            size_t chunk_start = start;
+            size_t actual = sizeof(json);
+
+            while (chunk_start < sizeof(json)) {
+                const size_t current_size = sizeof(json) - chunk_start < chunk_size ? sizeof(json) - chunk_start : chunk_size;
+                const size_t end = json_structural_index_skip(&skip, current_size, json + chunk_start, 0);
+
+                if (skip.depth == 0) {
+                    actual = chunk_start + end;
+                    break;
+                }
+
+                chunk_start += current_size;
+            }
+
+            ASSERT_INT(expected, actual);
+        }
+    }
+}
+
+static json_parser_result_t extract_json(const char* json, const char* pointer, json_raw_string_t* out) {
+    return json_extract(strlen(json), json, pointer, (json_parser_options_t) {32, 1024, 1024 }, out);
+}
+
+TEST(extract_pointer) {
+    const char* json = " {\"meta\": {\"request_id\": \"abc\", \"n\": [1, 2]}, \"items\": [{\"id\": 1}, {\"id\": 2, \"x\": \"\\\"}]\"}],"
+        " \"a/b\": 1, \"m~n\": 2, \"caf\\u00e9\": 3, \"\": 4, \"esc\\\"aped\": 5, \"\\ud83d\\ude00\": 6, \"a\": 7} ";
+    const struct {
+        const char* pointer;
+        const char* expected;
+    } cases[] = {
+        { "", "{\"meta\": {\"request_id\": \"abc\", \"n\": [1, 2]}, \"items\": [{\"id\": 1}, {\"id\": 2, \"x\": \"\\\"}]\"}],"
+            " \"a/b\": 1, \"m~n\": 2, \"caf\\u00e9\": 3, \"\": 4, \"esc\\\"aped\": 5, \"\\ud83d\\ude00\": 6, \"a\": 7}" },
+        { "/meta/request_id", "\"abc\"" },
+        { "/meta/n/1", "2" },
+        { "/items/1", "{\"id\": 2, \"x\": \"\\\"}]\"}" },
+        { "/items/1/id", "2" },
+        { "/a~1b", "1" },
+        { "/m~0n", "2" },
+        { "/caf\xC3\xA9", "3" },
+        { "/", "4" },
+        { "/esc\"aped", "5" },
+        { "/\xF0\x9F\x98\x80", "6" },
+        { "/a", "7" },
+        { "/items/2", nullptr },
+        { "/items/-", nullptr },
+        { "/items/01", nullptr },
+        { "/items/id", nullptr },
+        { "/meta/request_id/0", nullptr },
+        { "/nope", nullptr },
+        { "/m~1n", nullptr },
+        { "/caf", nullptr },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        json_raw_string_t value;
+        const json_parser_result_t result = extract_json(json, cases[i].pointer, &value);
+
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.code);
+
+        if (cases[i].expected == nullptr) {
+            ASSERT_NULL(value.value);
+            continue;
+        }
+
+        ASSERT_TRUE(value.value != nullptr);
+        ASSERT_INT(strlen(cases[i].expected), value.length);
+        ASSERT_STRN(cases[i].expected, value.value, value.length);
+    }
+}
+
+TEST(extract_errors) {
+    json_raw_string_t value;
+
+    {
+        const json_parser_result_t result = extract_json("{\"a\": 1}", "a", &value);
+        ASSERT_INT(JSON_PARSE_CONFIG_ERROR, result.code);
+        ASSERT_INT(JSON_ERROR_INVALID_POINTER, result.error);
+        ASSERT_INT(0, result.position);
+        ASSERT_STR("Internal error: Invalid JSON pointer at position 0 ", json_parse_error_message(result));
+    }
+
+    {
+        const json_parser_result_t result = extract_json("{\"a\": 1}", "/a~2", &value);
+        ASSERT_INT(JSON_PARSE_CONFIG_ERROR, result.code);
+        ASSERT_INT(JSON_ERROR_INVALID_POINTER, result.error);
+        ASSERT_INT(2, result.position);
+    }
+
+    {
+        // The input is not read after the target value, and the skipped values are not checked
+        const json_parser_result_t result = extract_json("{\"x\": [tru, {]], \"a\": 12, \"b\": [nul", "/a", &value);
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.code);
+        ASSERT_STRN("12", value.value, value.length);
+    }
+
+    {
+        // The target value is checked
+        const json_parser_result_t result = extract_json("{\"a\": [1,, 2]}", "/a", &value);
+        ASSERT_INT(JSON_PARSE_ERROR_INVALID_SYNTAX, result.code);
+        ASSERT_INT(9, result.position);
+        ASSERT_NULL(value.value);
+    }
+
+    {
+        const json_parser_result_t result = extract_json("{\"x\": \"abc, \"a\": 1}", "/a", &value);
+        ASSERT_INT(JSON_PARSE_ERROR_INVALID_SYNTAX, result.code);
+        ASSERT_INT(JSON_ERROR_UNEXPECTED_CHARACTER, result.error);
+        ASSERT_CHAR(',', result.extra);
+        ASSERT_INT(13, result.position);
+    }
+
+    {
+        const json_parser_result_t result = extract_json("{\"x\": [1, 2, \"a\": 1}", "/a", &value);
+        ASSERT_INT(JSON_PARSE_ERROR_UNEXPECTED_END, result.code);
+        ASSERT_INT(JSON_CONTEXT_OBJECT, result.context);
+        ASSERT_CHAR('}', result.extra);
+    }
+
+    {
+        const json_parser_result_t result = extract_json("[1, 2", "/5", &value);
+        ASSERT_INT(JSON_PARSE_ERROR_UNEXPECTED_END, result.code);
+        ASSERT_INT(JSON_CONTEXT_ARRAY, result.context);
+        ASSERT_CHAR(']', result.extra);
+        ASSERT_INT(5, result.position);
+    }
+
+    {
+        // The depth of the target value in the document is applied
+        const char* json = "{\"a\": {\"b\": [1]}}";
+        json_parser_handler_t handler = {};
+
+        const json_parser_result_t expected = json_parse(strlen(json), json, &handler, (json_parser_options_t) { .max_depth = 4 });
+        const json_parser_result_t result = json_extract(strlen(json), json, "/a/b", (json_parser_options_t) { .max_depth = 4 }, &value);
+        ASSERT_INT(JSON_PARSE_ERROR_MAX_DEPTH, expected.code);
+        ASSERT_INT(expected.code, result.code);
+        ASSERT_INT(expected.position, result.position);
+
+        ASSERT_INT(JSON_PARSE_SUCCESS, json_parse(strlen(json), json, &handler, (json_parser_options_t) { .max_depth = 7 }).code);
+        ASSERT_INT(JSON_PARSE_SUCCESS, json_extract(strlen(json), json, "/a/b/0", (json_parser_options_t) { .max_depth = 7 }, &value).code);
+        ASSERT_STRN("1", value.value, value.length);
+    }
+}
+
+/**
+ * Write the content in a new temporary file, and store its path
+ */
+static void write_temporary_file(char path[32], const size_t length, const char content[length]) {
+    strcpy(path, "/tmp/json_test_XXXXXX");
+    const int fd = mkstemp(path);
+
+    if (fd >= 0) {
+        write(fd, content, length);
+        close(fd);
+    }
+}
+
+TEST(parse_file) {
+    char path[32];
+
+    {
+        const char* json = "{\"name\": \"Alice\", \"tags\": [\"a\\\"b\", \"\\u00e9\"], \"score\": 12.5, \"ok\": true, \"none\": null}";
+        const json_parser_result_t expected = parse_json(json);
+        const size_t expected_count = test_call_stack.count;
+        const char* expected_names[128];
+
+        for (size_t i = 0; i < expected_count; ++i) {
+            expected_names[i] = test_call_stack.entries[i].function_name;
+        }
+
+        write_temporary_file(path, strlen(json), json);
+
+        json_parser_handler_t handler = init_handler();
+        handler.on_string = on_string_copy;
+        handler.on_object_property = on_object_property_copy;
+
+        const json_parser_result_t result = json_parse_file(path, &handler, (json_parser_options_t) {32, 1024, 1024 });
+        unlink(path);
+
+        ASSERT_INT(expected.code, result.code);
+        ASSERT_INT(expected_count, test_call_stack.count);
+
+        for (size_t i = 0; i < expected_count; ++i) {
+            ASSERT_STR(expected_names[i], test_call_stack.entries[i].function_name);
+        }
+
+        ASSERT_STRN("\"a\\\"b\"", ((json_raw_string_t*) test_call_stack.entries[5].parameter)->value, 6);
+    }
+
+    {
+        // The file ends at a page boundary: the scanners must not read past the mapping
+        char json[4096];
+        memset(json, 'a', sizeof(json));
+        json[0] = '"';
+        json[sizeof(json) - 1] = '"';
+        write_temporary_file(path, sizeof(json), json);
+
+        json_parser_handler_t handler = {};
+        const json_parser_result_t result = json_parse_file(path, &handler, (json_parser_options_t) {32, 8192, 1024 });
+
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.code);
+
+        // Truncated document
+        truncate(path, sizeof(json) - 1);
+        const json_parser_result_t truncated_result = json_parse_file(path, &handler, (json_parser_options_t) {32, 8192, 1024 });
+        const json_parser_result_t expected = json_parse(sizeof(json) - 1, json, &handler, (json_parser_options_t) {32, 8192, 1024 });
+        unlink(path);
+
+        ASSERT_INT(expected.code, truncated_result.code);
+        ASSERT_INT(expected.position, truncated_result.position);
+    }
+
+    {
+        // An empty file is parsed as an empty input
+        write_temporary_file(path, 0, "");
+
+        json_parser_handler_t handler = {};
+        const json_parser_result_t result = json_parse_file(path, &handler, (json_parser_options_t) {});
+        const json_parser_result_t expected = json_parse(0, "", &handler, (json_parser_options_t) {});
+        unlink(path);
+
+        ASSERT_INT(expected.code, result.code);
+        ASSERT_INT(expected.error, result.error);
+    }
+
+    {
+        json_parser_handler_t handler = {};
+        const json_parser_result_t result = json_parse_file("/tmp/json_test_missing_file", &handler, (json_parser_options_t) {});
+
+        ASSERT_INT(JSON_PARSE_CONFIG_ERROR, result.code);
+        ASSERT_INT(JSON_ERROR_IO_FAILURE, result.error);
+        ASSERT_INT(ENOENT, errno);
+        ASSERT_STR("Internal error: Cannot read the input file at position 0 ", json_parse_error_message(result));
+    }
+
+    {
+        json_parser_handler_t handler = {};
+        const json_parser_result_t result = json_parse_file("/tmp", &handler, (json_parser_options_t) {});
+
+        ASSERT_INT(JSON_ERROR_IO_FAILURE, result.error);
+        ASSERT_INT(EINVAL, errno);
+        ASSERT_INT(JSON_ERROR_NULL_POINTER, json_parse_file(nullptr, &handler, (json_parser_options_t) {}).error);
+    }
+}
+
+/**
+ * Parse the input from a pipe, read by blocks of the given size
+ */
+static json_parser_result_t parse_json_fd(const char* json, const size_t read_size) {
+    json_parser_handler_t handler = init_handler();
+    handler.on_string = on_string_copy;
+    handler.on_object_property = on_object_property_copy;
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+    char buffer[JSON_PARSE_FD_BUFFER_SIZE(1024, 64)];
+    int fds[2];
+
+    if (pipe(fds) != 0) {
+        return (json_parser_result_t) { JSON_PARSE_CONFIG_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_IO_FAILURE, 0, 0 };
+    }
+
+    write(fds[1], json, strlen(json));
+    close(fds[1]);
+
+    const json_parser_result_t result = json_parse_fd(fds[0], &handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack, JSON_PARSE_FD_BUFFER_SIZE(1024, read_size), buffer);
+    close(fds[0]);
+
+    return result;
+}
+
+TEST(parse_fd) {
+    const char* inputs[] = {
+        "123", "-12.5", "null", "true", "\"Hello, World!\"", "  \"\\\\\\\"\"  ", "[]", "{}",
+        "{\"name\": \"Alice\", \"tags\": [\"a\\\"b\", \"\\\\\", \"\\u00e9\"], \"scores\": [12.5, -314, 1e-3, 0], \"ok\": true, \"none\": null}",
+        "[1,]", "[1 2]", "{\"a\":1", "\"abc", "nul", "[1] 2", "  ",
+        "\"0123456789abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz\"",
+    };
+    const size_t read_sizes[] = { 1, 3, 7, 64 };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        const json_parser_result_t expected = parse_json(inputs[i]);
+        const size_t expected_count = test_call_stack.count;
+        const char* expected_names[128];
+        char expected_strings[128][128];
+        memset(expected_strings, 0, sizeof(expected_strings));
+
+        for (size_t j = 0; j < expected_count; ++j) {
+            expected_names[j] = test_call_stack.entries[j].function_name;
+
+            if (strcmp(expected_names[j], "on_string") == 0 || strcmp(expected_names[j], "on_object_property") == 0) {
+                const json_raw_string_t string = *(json_raw_string_t*) test_call_stack.entries[j].parameter;
+                memcpy(expected_strings[j], string.value, string.length);
+            }
+        }
+
+        for (size_t size = 0; size < sizeof(read_sizes) / sizeof(read_sizes[0]); ++size) {
+            const json_parser_result_t actual = parse_json_fd(inputs[i], read_sizes[size]);
+
+            if (expected.code != actual.code || expected.position != actual.position) {
+                fprintf(stderr, "[INFO] Input: %s, read size: %zu\n", inputs[i], read_sizes[size]);
+            }
+
+            ASSERT_INT(expected.code, actual.code);
+            ASSERT_INT(expected.error, actual.error);
+            ASSERT_INT(expected.position, actual.position);
+
+            if (expected.code != JSON_PARSE_SUCCESS) {
+                continue;
+            }
+
+            ASSERT_INT(expected_count, test_call_stack.count);
+
+            for (size_t j = 0; j < expected_count; ++j) {
+                ASSERT_STR(expected_names[j], test_call_stack.entries[j].function_name);
+
+                if (expected_strings[j][0] != '\0') {
+                    const json_raw_string_t actual_string = *(json_raw_string_t*) test_call_stack.entries[j].parameter;
+                    ASSERT_STRN(expected_strings[j], actual_string.value, actual_string.length);
+                }
+            }
+        }
+    }
+}
+
+TEST(parse_fd_stop_after_root_value) {
+    json_parser_handler_t handler = {};
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+    char buffer[JSON_PARSE_FD_BUFFER_SIZE(1024, 64)];
+    int fds[2];
+
+    ASSERT_INT(0, pipe(fds));
+    write(fds[1], "[1, 2] [3]", 10);
+
+    // The write end stays open: reading after the root value would block
+    const json_parser_result_t result = json_parse_fd(fds[0], &handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack, JSON_PARSE_FD_BUFFER_SIZE(1024, 2), buffer);
+    ASSERT_INT(JSON_PARSE_SUCCESS, result.code);
+
+    char remaining[8];
+    close(fds[1]);
+    ASSERT_INT(4, read(fds[0], remaining, sizeof(remaining)));
+    ASSERT_STRN("[3]", remaining + 1, 3);
+    close(fds[0]);
+
+    {
+        const json_parser_result_t error = json_parse_fd(-1, &handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack, sizeof(buffer), buffer);
+        ASSERT_INT(JSON_PARSE_CONFIG_ERROR, error.code);
+        ASSERT_INT(JSON_ERROR_IO_FAILURE, error.error);
+        ASSERT_INT(EBADF, errno);
+    }
+
+    {
+        const json_parser_result_t error = json_parse_fd(0, &handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack, JSON_PUSH_PARSER_BUFFER_SIZE(1024), buffer);
+        ASSERT_INT(JSON_PARSE_CONFIG_ERROR, error.code);
+        ASSERT_INT(JSON_ERROR_TOO_SMALL, error.error);
+    }
+}
+
+TEST(string_escape_free_flag) {
+    json_parser_result_t (*parsers[])(const char*) = { parse_json, parse_json_indexed, parse_json_iterative };
+    const char* json = "{\"plain\": \"café\", \"e\\\"k\": \"a\\nb\", \"\": \"\\\\\"}";
+    const bool expected[] = { true, true, false, false, true, false };
+
+    for (size_t i = 0; i < sizeof(parsers) / sizeof(parsers[0]); ++i) {
+        ASSERT_INT(JSON_PARSE_SUCCESS, parsers[i](json).code);
+        ASSERT_INT(8, test_call_stack.count);
+
+        for (size_t j = 0; j < 6; ++j) {
+            const json_raw_string_t* string = test_call_stack.entries[j + 1].parameter;
+            ASSERT_INT(expected[j], string->escape_free);
+        }
+    }
+}
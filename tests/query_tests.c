@@ -0,0 +1,269 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tests.h"
+#include "../parser/parser.h"
+#include "../parser/push_parser.h"
+#include "../parser/query.h"
+
+TEST_CASE(query)
+
+#define TEST_QUERY_MAX_NODES 32
+
+/**
+ * Write each match in the log as "<path id>=<value>;", with strings as raw JSON, and structures as "[" or "{"
+ */
+typedef struct {
+    json_query_handler_t handler;
+    char log[1024];
+    size_t log_used;
+} test_query_handler_t;
+
+static json_parser_result_t test_on_match(json_query_handler_t* self, const size_t path_id, const json_token_t* value) {
+    test_query_handler_t* handler = (test_query_handler_t*) self;
+    char* log = handler->log + handler->log_used;
+    const size_t available = sizeof(handler->log) - handler->log_used;
+
+    switch (value->kind) {
+        case JSON_TOKEN_NULL:
+            handler->log_used += (size_t) snprintf(log, available, "%zu=null;", path_id);
+            break;
+        case JSON_TOKEN_BOOL:
+            handler->log_used += (size_t) snprintf(log, available, "%zu=%s;", path_id, value->bool_value ? "true" : "false");
+            break;
+        case JSON_TOKEN_NUMBER:
+            handler->log_used += (size_t) snprintf(log, available, "%zu=%g;", path_id, value->number_value);
+            break;
+        case JSON_TOKEN_INTEGER:
+            handler->log_used += (size_t) snprintf(log, available, "%zu=%" PRId64 ";", path_id, value->integer_value);
+            break;
+        case JSON_TOKEN_STRING:
+            handler->log_used += (size_t) snprintf(log, available, "%zu=%.*s;", path_id, (int) value->raw.length, value->raw.value);
+            break;
+        case JSON_TOKEN_ARRAY_START:
+            handler->log_used += (size_t) snprintf(log, available, "%zu=[;", path_id);
+            break;
+        case JSON_TOKEN_OBJECT_START:
+            handler->log_used += (size_t) snprintf(log, available, "%zu={;", path_id);
+            break;
+        default:
+            return (json_parser_result_t) { JSON_PARSE_HANDLER_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNKNOWN };
+    }
+
+    return json_create_success_result();
+}
+
+static json_parser_result_t test_on_match_stop(json_query_handler_t* self, const size_t path_id, const json_token_t* value) {
+    test_on_match(self, path_id, value);
+
+    return (json_parser_result_t) { JSON_PARSE_HANDLER_ERROR, JSON_CONTEXT_UNKNOWN, JSON_ERROR_UNKNOWN };
+}
+
+typedef struct {
+    json_query_t query;
+    json_query_node_t nodes[TEST_QUERY_MAX_NODES];
+    json_query_frame_t frames[TEST_QUERY_MAX_NODES];
+    uint32_t active[TEST_QUERY_MAX_NODES];
+    json_query_runner_t runner;
+    test_query_handler_t handler;
+} test_query_t;
+
+static json_parser_result_t init_query(test_query_t* test, const size_t path_count, const char* const paths[path_count]) {
+    test->handler = (test_query_handler_t) { .handler = { .on_match = test_on_match } };
+
+    const json_parser_result_t compile_result = json_query_compile(&test->query, path_count, paths, TEST_QUERY_MAX_NODES, test->nodes);
+
+    if (compile_result.code != JSON_PARSE_SUCCESS) {
+        return compile_result;
+    }
+
+    return json_query_runner_init(&test->runner, &test->query, &test->handler.handler, test->query.depth, test->frames, test->query.node_count, test->active);
+}
+
+static json_parser_result_t run_query(test_query_t* test, const char* json) {
+    test->handler.log_used = 0;
+    test->handler.log[0] = '\0';
+
+    return json_parse_query(&test->runner, strlen(json), json, (json_parser_options_t) {32, 1024, 1024 });
+}
+
+static json_parser_result_t run_query_iterative(test_query_t* test, const char* json) {
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+
+    test->handler.log_used = 0;
+    test->handler.log[0] = '\0';
+    json_query_runner_reset(&test->runner);
+
+    return json_parse_iterative(strlen(json), json, &test->runner.handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack);
+}
+
+static json_parser_result_t run_query_push(test_query_t* test, const char* json, const size_t chunk_size) {
+    json_parser_frame_t stack[JSON_PARSER_STACK_SIZE(32)];
+    char buffer[JSON_PUSH_PARSER_BUFFER_SIZE(1024)];
+    json_push_parser_t parser;
+
+    test->handler.log_used = 0;
+    test->handler.log[0] = '\0';
+    json_query_runner_reset(&test->runner);
+
+    const json_parser_result_t init_result = json_push_parser_init(&parser, &test->runner.handler, (json_parser_options_t) {32, 1024, 1024 }, JSON_PARSER_STACK_SIZE(32), stack, sizeof(buffer), buffer);
+
+    if (init_result.code != JSON_PARSE_SUCCESS) {
+        return init_result;
+    }
+
+    const size_t length = strlen(json);
+
+    for (size_t position = 0; position < length; position += chunk_size) {
+        const size_t current_size = length - position < chunk_size ? length - position : chunk_size;
+        const json_parser_result_t result = json_parser_feed(&parser, current_size, json + position);
+
+        if (result.code != JSON_PARSE_SUCCESS) {
+            return result;
+        }
+    }
+
+    return json_parser_finish(&parser);
+}
+
+TEST(query_compile) {
+    const char* paths[] = { "/items/*/id", "/items/0/name", "/meta", "/items/*/tags/0" };
+    json_query_node_t nodes[TEST_QUERY_MAX_NODES];
+    json_query_t query;
+
+    ASSERT_INT(12, json_query_node_count(4, paths));
+    ASSERT_INT(JSON_PARSE_SUCCESS, json_query_compile(&query, 4, paths, TEST_QUERY_MAX_NODES, nodes).code);
+
+    // root, items, *, id, 0, name, meta, tags, 0: the node count is an upper bound, as prefixes are shared
+    ASSERT_INT(9, query.node_count);
+    ASSERT_INT(4, query.depth);
+
+    {
+        const json_parser_result_t result = json_query_compile(&query, 4, paths, 8, nodes);
+        ASSERT_INT(JSON_PARSE_CONFIG_ERROR, result.code);
+        ASSERT_INT(JSON_ERROR_OUT_OF_MEMORY, result.error);
+        ASSERT_INT(3, result.position);
+    }
+
+    {
+        const char* invalid_paths[] = { "/a", "b" };
+        const json_parser_result_t result = json_query_compile(&query, 2, invalid_paths, TEST_QUERY_MAX_NODES, nodes);
+        ASSERT_INT(JSON_PARSE_CONFIG_ERROR, result.code);
+        ASSERT_INT(JSON_ERROR_INVALID_POINTER, result.error);
+        ASSERT_INT(1, result.position);
+    }
+
+    {
+        const char* invalid_paths[] = { "/a/~2" };
+        const json_parser_result_t result = json_query_compile(&query, 1, invalid_paths, TEST_QUERY_MAX_NODES, nodes);
+        ASSERT_INT(JSON_ERROR_INVALID_POINTER, result.error);
+        ASSERT_INT(0, result.position);
+    }
+
+    {
+        const char* duplicated_paths[] = { "/a/b", "/a", "/a/b" };
+        const json_parser_result_t result = json_query_compile(&query, 3, duplicated_paths, TEST_QUERY_MAX_NODES, nodes);
+        ASSERT_INT(JSON_ERROR_INVALID_POINTER, result.error);
+        ASSERT_INT(2, result.position);
+    }
+
+    {
+        json_query_frame_t frames[TEST_QUERY_MAX_NODES];
+        uint32_t active[TEST_QUERY_MAX_NODES];
+        json_query_runner_t runner;
+        test_query_handler_t handler = { .handler = { .on_match = test_on_match } };
+
+        ASSERT_INT(JSON_PARSE_SUCCESS, json_query_compile(&query, 4, paths, TEST_QUERY_MAX_NODES, nodes).code);
+        ASSERT_INT(JSON_ERROR_TOO_SMALL, json_query_runner_init(&runner, &query, &handler.handler, 3, frames, TEST_QUERY_MAX_NODES, active).error);
+        ASSERT_INT(JSON_ERROR_TOO_SMALL, json_query_runner_init(&runner, &query, &handler.handler, 4, frames, 8, active).error);
+        ASSERT_INT(JSON_ERROR_NULL_POINTER, json_query_runner_init(&runner, &query, nullptr, 4, frames, 9, active).error);
+    }
+}
+
+TEST(query_match_paths) {
+    const char* json = "{\"meta\": {\"id\": \"r1\", \"n\": 2.5}, \"items\": [{\"id\": 1, \"name\": \"a\\\"b\", \"tags\": [\"x\", \"y\"]},"
+        " {\"id\": 2, \"tags\": []}, {\"name\": null}], \"a/b\": true, \"m~n\": false, \"caf\\u00e9\": 3, \"*\": 4,"
+        " \"\\u0061b\": 5, \"x\\\\y\": 6, \"x\\by\": 7}";
+    const struct {
+        const char* paths[5];
+        size_t path_count;
+        const char* expected;
+    } cases[] = {
+        { { "/meta/id", "/meta/n" }, 2, "0=\"r1\";1=2.5;" },
+        { { "/items/1/id", "/items/0/name" }, 2, "1=\"a\\\"b\";0=2;" },
+        { { "/items/*/id" }, 1, "0=1;0=2;" },
+        { { "/items/*/name", "/items/0/*" }, 2, "1=1;1=\"a\\\"b\";0=\"a\\\"b\";1=[;0=null;" },
+        { { "/items/*/tags/*" }, 1, "0=\"x\";0=\"y\";" },
+        { { "/meta", "/items/1/tags", "" }, 3, "2={;0={;1=[;" },
+        { { "/a~1b", "/m~0n", "/caf\xC3\xA9" }, 3, "0=true;1=false;2=3;" },
+        { { "/ab", "/x\\y" }, 2, "0=5;1=6;" },
+        { { "/*" }, 1, "0={;0=[;0=true;0=false;0=3;0=4;0=5;0=6;0=7;" },
+        { { "/items/3", "/items/-", "/items/01", "/meta/id/0", "/nope" }, 5, "" },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        test_query_t test;
+
+        ASSERT_INT(JSON_PARSE_SUCCESS, init_query(&test, cases[i].path_count, cases[i].paths).code);
+        ASSERT_INT(JSON_PARSE_SUCCESS, run_query(&test, json).code);
+        ASSERT_STR(cases[i].expected, test.handler.log);
+
+        // The runner can be reused
+        ASSERT_INT(JSON_PARSE_SUCCESS, run_query(&test, json).code);
+        ASSERT_STR(cases[i].expected, test.handler.log);
+    }
+}
+
+TEST(query_prune_values) {
+    const char* paths[] = { "/b", "/c/1" };
+    test_query_t test;
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, init_query(&test, 2, paths).code);
+
+    {
+        // The values which cannot match are skipped without being checked
+        ASSERT_INT(JSON_PARSE_SUCCESS, run_query(&test, "{\"a\": [tru, {]], \"b\": 1, \"c\": [{\"x\": nul}, 2, [3, nul]]}").code);
+        ASSERT_STR("0=1;1=2;", test.handler.log);
+    }
+
+    {
+        // But the structures which may contain a match are
+        const json_parser_result_t result = run_query(&test, "{\"c\": [1, 2, 3,, 4]}");
+        ASSERT_INT(JSON_PARSE_ERROR_INVALID_SYNTAX, result.code);
+        ASSERT_INT(15, result.position);
+        ASSERT_STR("1=2;", test.handler.log);
+    }
+
+    {
+        test.handler.handler.on_match = test_on_match_stop;
+
+        const json_parser_result_t result = run_query(&test, "{\"b\": 1, \"c\": [1, 2]}");
+        ASSERT_INT(JSON_PARSE_HANDLER_ERROR, result.code);
+        ASSERT_STR("0=1;", test.handler.log);
+    }
+}
+
+TEST(query_engines_match_json_parse) {
+    const char* paths[] = { "/items/*/id", "/items/0/name", "/meta/k~1ey", "/items/*/tags/1" };
+    const char* json = "  {\"meta\": {\"k/ey\": \"v\\u00e9\", \"skip\": [1, {\"a\": \"}]\\\"\"}]}, \"items\": [{\"id\": 1, \"name\": \"first\","
+        " \"tags\": [\"a\", \"b\"]}, {\"other\": [], \"id\": -2.5e3, \"tags\": [true, false, null]}, 12, {\"id\": {\"x\": 1}}]} ";
+    test_query_t test;
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, init_query(&test, 4, paths).code);
+    ASSERT_INT(JSON_PARSE_SUCCESS, run_query(&test, json).code);
+
+    char expected[1024];
+    strcpy(expected, test.handler.log);
+    ASSERT_STR("2=\"v\\u00e9\";0=1;1=\"first\";3=\"b\";0=-2500;3=false;0={;", expected);
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, run_query_iterative(&test, json).code);
+    ASSERT_STR(expected, test.handler.log);
+
+    const size_t chunk_sizes[] = { 1, 2, 3, 7, 64 };
+
+    for (size_t i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++i) {
+        ASSERT_INT(JSON_PARSE_SUCCESS, run_query_push(&test, json, chunk_sizes[i]).code);
+        ASSERT_STR(expected, test.handler.log);
+    }
+}
@@ -0,0 +1,154 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "tests.h"
+#include "../parser/tape.h"
+
+TEST_CASE(tape)
+
+static uint64_t test_words[256];
+static char test_strings[1024];
+static json_tape_number_t test_numbers[64];
+
+static json_parser_result_t parse_json(const char* json, json_tape_t* tape) {
+    json_tape_init(tape, 256, test_words, 1024, test_strings, 64, test_numbers);
+
+    return json_parse_to_tape(strlen(json), json, tape, (json_parser_options_t) {32, 1024, 1024 });
+}
+
+TEST(parse_scalars) {
+    json_tape_t tape;
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("null", &tape).code);
+    ASSERT_INT(1, tape.used);
+    ASSERT_INT(JSON_TAPE_NULL, json_tape_type(&tape, 0));
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("false", &tape).code);
+    ASSERT_INT(JSON_TAPE_FALSE, json_tape_type(&tape, 0));
+    ASSERT_TRUE(!json_tape_bool(&tape, 0));
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("-9007199254740993", &tape).code);
+    ASSERT_INT(JSON_TAPE_INTEGER, json_tape_type(&tape, 0));
+    ASSERT_TRUE(json_tape_integer(&tape, 0) == -9007199254740993LL);
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("12.5e-1", &tape).code);
+    ASSERT_INT(JSON_TAPE_NUMBER, json_tape_type(&tape, 0));
+    ASSERT_DOUBLE(1.25, json_tape_number(&tape, 0), 0.0);
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("\"a\\nb\\\"\"", &tape).code);
+    ASSERT_INT(JSON_TAPE_STRING, json_tape_type(&tape, 0));
+    const json_string_t string = json_tape_string(&tape, 0);
+    ASSERT_INT(4, string.length);
+    ASSERT_STR("a\nb\"", string.value);
+}
+
+TEST(parse_structures) {
+    json_tape_t tape;
+    const char* json = "{\"id\": 42, \"name\": \"foo\", \"tags\": [\"x\", true, null, 1.5, []], \"empty\": {}}";
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json(json, &tape).code);
+    ASSERT_INT(18, tape.used);
+
+    ASSERT_INT(JSON_TAPE_OBJECT_START, json_tape_type(&tape, 0));
+    ASSERT_INT(4, json_tape_count(&tape, 0));
+    ASSERT_INT(18, json_tape_next(&tape, 0));
+    ASSERT_INT(JSON_TAPE_OBJECT_END, json_tape_type(&tape, 17));
+    ASSERT_INT(0, json_tape_payload(&tape, 17));
+
+    const size_t id = json_tape_object_get(&tape, 0, "id", 2);
+    ASSERT_INT(2, id);
+    ASSERT_INT(42, json_tape_integer(&tape, id));
+    ASSERT_DOUBLE(42.0, json_tape_number(&tape, id), 0.0);
+
+    const size_t name = json_tape_object_get(&tape, 0, "name", 4);
+    ASSERT_STR("foo", json_tape_string(&tape, name).value);
+
+    const size_t tags = json_tape_object_get(&tape, 0, "tags", 4);
+    ASSERT_INT(6, tags);
+    ASSERT_INT(JSON_TAPE_ARRAY_START, json_tape_type(&tape, tags));
+    ASSERT_INT(5, json_tape_count(&tape, tags));
+    ASSERT_INT(JSON_TAPE_ARRAY_END, json_tape_type(&tape, json_tape_next(&tape, tags) - 1));
+    ASSERT_STR("x", json_tape_string(&tape, json_tape_array_get(&tape, tags, 0)).value);
+    ASSERT_TRUE(json_tape_bool(&tape, json_tape_array_get(&tape, tags, 1)));
+    ASSERT_INT(JSON_TAPE_NULL, json_tape_type(&tape, json_tape_array_get(&tape, tags, 2)));
+    ASSERT_DOUBLE(1.5, json_tape_number(&tape, json_tape_array_get(&tape, tags, 3)), 0.0);
+
+    const size_t nested = json_tape_array_get(&tape, tags, 4);
+    ASSERT_INT(JSON_TAPE_ARRAY_START, json_tape_type(&tape, nested));
+    ASSERT_INT(0, json_tape_count(&tape, nested));
+    ASSERT_INT(nested + 2, json_tape_next(&tape, nested));
+    ASSERT_INT(0, json_tape_array_get(&tape, tags, 5));
+    ASSERT_INT(0, json_tape_array_get(&tape, nested, 0));
+
+    const size_t empty = json_tape_object_get(&tape, 0, "empty", 5);
+    ASSERT_INT(JSON_TAPE_OBJECT_START, json_tape_type(&tape, empty));
+    ASSERT_INT(0, json_tape_count(&tape, empty));
+    ASSERT_INT(0, json_tape_object_get(&tape, empty, "id", 2));
+
+    ASSERT_INT(0, json_tape_object_get(&tape, 0, "missing", 7));
+    ASSERT_INT(0, json_tape_object_get(&tape, tags, "id", 2));
+}
+
+TEST(parse_error) {
+    json_tape_t tape;
+
+    {
+        const json_parser_result_t result = parse_json("[1, 2", &tape);
+        ASSERT_INT(JSON_PARSE_ERROR_UNEXPECTED_END, result.code);
+        ASSERT_INT(JSON_CONTEXT_ARRAY, result.context);
+    }
+
+    {
+        const json_parser_result_t result = parse_json("{\"a\" 1}", &tape);
+        ASSERT_INT(JSON_PARSE_ERROR_INVALID_SYNTAX, result.code);
+        ASSERT_INT(5, result.position);
+    }
+}
+
+TEST(buffers_too_small) {
+    json_tape_t tape;
+    uint64_t words[4];
+    char strings[8];
+    json_tape_number_t numbers[1];
+
+    json_tape_init(&tape, 4, words, 8, strings, 1, numbers);
+
+    {
+        const json_parser_result_t result = json_parse_to_tape(9, "[1,2,3,4]", &tape, (json_parser_options_t) {});
+        ASSERT_INT(JSON_PARSE_HANDLER_ERROR, result.code);
+        ASSERT_INT(JSON_CONTEXT_NUMBER, result.context);
+        ASSERT_INT(JSON_ERROR_OUT_OF_MEMORY, result.error);
+    }
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, json_parse_to_tape(8, "[true,1]", &tape, (json_parser_options_t) {}).code);
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, json_parse_to_tape(5, "\"abc\"", &tape, (json_parser_options_t) {}).code);
+    ASSERT_STR("abc", json_tape_string(&tape, 0).value);
+
+    {
+        const json_parser_result_t result = json_parse_to_tape(6, "\"abcd\"", &tape, (json_parser_options_t) {});
+        ASSERT_INT(JSON_PARSE_HANDLER_ERROR, result.code);
+        ASSERT_INT(JSON_CONTEXT_STRING, result.context);
+    }
+
+    {
+        const json_parser_result_t result = json_parse_to_tape(9, "[[[[1]]]]", &tape, (json_parser_options_t) {});
+        ASSERT_INT(JSON_PARSE_HANDLER_ERROR, result.code);
+        ASSERT_INT(JSON_CONTEXT_NUMBER, result.context);
+    }
+}
+
+TEST(worst_case_sizes) {
+    const char* inputs[] = { "[[],[],[]]", "[1,2,3,4,5]", "[\"\",\"\",\"\"]", "{\"\":\"\",\"\":\"\"}", "\"\"", "0" };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        const size_t length = strlen(inputs[i]);
+        uint64_t words[JSON_TAPE_SIZE(length)];
+        char strings[JSON_TAPE_STRINGS_SIZE(length)];
+        json_tape_number_t numbers[JSON_TAPE_NUMBERS_SIZE(length)];
+        json_tape_t tape;
+
+        json_tape_init(&tape, JSON_TAPE_SIZE(length), words, JSON_TAPE_STRINGS_SIZE(length), strings, JSON_TAPE_NUMBERS_SIZE(length), numbers);
+        ASSERT_INT(JSON_PARSE_SUCCESS, json_parse_to_tape(length, inputs[i], &tape, (json_parser_options_t) {}).code);
+    }
+}
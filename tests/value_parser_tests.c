@@ -2,11 +2,18 @@
 // Created by vincent on 08/12/2025.
 //
 
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "tests.h"
+#include "../formater/formater.h"
+#include "../parser/file.h"
 #include "../parser/value_parser.h"
+#include "../type/arena_pool.h"
 
 TEST_CASE(value_parser)
 
@@ -33,8 +40,8 @@ TEST(parse_number) {
     {
         json_value_parser_result_t result = parse_json("123");
         ASSERT_INT(JSON_PARSE_SUCCESS, result.result.code);
-        ASSERT_INT(JSON_NUMBER, result.value->type);
-        ASSERT_DOUBLE(123.0, result.value->number_value, 0.0);
+        ASSERT_INT(JSON_INTEGER, result.value->type);
+        ASSERT_INT(123, result.value->integer_value);
     }
 
     {
@@ -47,8 +54,55 @@ TEST(parse_number) {
     {
         json_value_parser_result_t result = parse_json("-42");
         ASSERT_INT(JSON_PARSE_SUCCESS, result.result.code);
+        ASSERT_INT(JSON_INTEGER, result.value->type);
+        ASSERT_INT(-42, result.value->integer_value);
+    }
+
+    {
+        json_value_parser_result_t result = parse_json("-1.25e-3");
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.result.code);
         ASSERT_INT(JSON_NUMBER, result.value->type);
-        ASSERT_DOUBLE(-42, result.value->number_value, 0.0);
+        ASSERT_DOUBLE(-0.00125, result.value->number_value, 0.0);
+    }
+
+    {
+        json_value_parser_result_t result = parse_json("9223372036854775807");
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.result.code);
+        ASSERT_INT(JSON_INTEGER, result.value->type);
+        ASSERT_TRUE(result.value->integer_value == INT64_MAX);
+    }
+
+    {
+        json_value_parser_result_t result = parse_json("-9223372036854775808");
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.result.code);
+        ASSERT_INT(JSON_INTEGER, result.value->type);
+        ASSERT_TRUE(result.value->integer_value == INT64_MIN);
+    }
+
+    {
+        // Above 2^53, but still exact
+        json_value_parser_result_t result = parse_json("9007199254740993");
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.result.code);
+        ASSERT_INT(JSON_INTEGER, result.value->type);
+        ASSERT_TRUE(result.value->integer_value == 9007199254740993LL);
+    }
+
+    {
+        // Out of int64_t range, or with fraction or exponent: fallback to double
+        const char* numbers[] = { "9223372036854775808", "-9223372036854775809", "1.0", "1e3", "-0" };
+
+        for (size_t i = 0; i < sizeof(numbers) / sizeof(numbers[0]); ++i) {
+            json_value_parser_result_t result = parse_json(numbers[i]);
+            ASSERT_INT(JSON_PARSE_SUCCESS, result.result.code);
+            ASSERT_INT(JSON_NUMBER, result.value->type);
+            ASSERT_DOUBLE(strtod(numbers[i], nullptr), result.value->number_value, 0.0);
+        }
+    }
+
+    {
+        json_value_parser_result_t result = parse_json("012");
+        ASSERT_TRUE(result.result.code != JSON_PARSE_SUCCESS);
+        ASSERT_TRUE(result.value == nullptr);
     }
 }
 
@@ -112,8 +166,8 @@ TEST(parse_array_simple) {
         ASSERT_TRUE(first != nullptr);
         ASSERT_INT(0, first->key_int);
         ASSERT_NULL(first->key_str);
-        ASSERT_INT(JSON_NUMBER, first->value->type);
-        ASSERT_DOUBLE(123.0, first->value->number_value, 0.0);
+        ASSERT_INT(JSON_INTEGER, first->value->type);
+        ASSERT_INT(123, first->value->integer_value);
 
         json_member_entry_t* second = first->next;
         ASSERT_TRUE(second != nullptr);
@@ -146,8 +200,8 @@ TEST(parse_object_simple) {
         ASSERT_TRUE(property != nullptr);
         ASSERT_INT(3, property->key_int);
         ASSERT_STRN("foo", property->key_str, property->key_int);
-        ASSERT_INT(JSON_NUMBER, property->value->type);
-        ASSERT_DOUBLE(42.0, property->value->number_value, 0.0);
+        ASSERT_INT(JSON_INTEGER, property->value->type);
+        ASSERT_INT(42, property->value->integer_value);
         ASSERT_NULL(property->next);
         ASSERT_TRUE(property == result.value->object_value.tail);
     }
@@ -181,8 +235,8 @@ TEST(parse_complex_json) {
     ASSERT_TRUE(age_prop != nullptr);
     ASSERT_INT(3, age_prop->key_int);
     ASSERT_STRN("age", age_prop->key_str, age_prop->key_int);
-    ASSERT_INT(JSON_NUMBER, age_prop->value->type);
-    ASSERT_DOUBLE(30.0, age_prop->value->number_value, 0.0);
+    ASSERT_INT(JSON_INTEGER, age_prop->value->type);
+    ASSERT_INT(30, age_prop->value->integer_value);
 
     json_member_entry_t* married_prop = age_prop->next;
     ASSERT_TRUE(married_prop != nullptr);
@@ -229,8 +283,8 @@ TEST(parse_complex_json) {
     ASSERT_TRUE(zip_prop != nullptr);
     ASSERT_INT(3, zip_prop->key_int);
     ASSERT_STRN("zip", zip_prop->key_str, zip_prop->key_int);
-    ASSERT_INT(JSON_NUMBER, zip_prop->value->type);
-    ASSERT_DOUBLE(75000.0, zip_prop->value->number_value, 0.0);
+    ASSERT_INT(JSON_INTEGER, zip_prop->value->type);
+    ASSERT_INT(75000, zip_prop->value->integer_value);
     ASSERT_NULL(zip_prop->next);
     ASSERT_TRUE(zip_prop == address_prop->value->object_value.tail);
 
@@ -250,14 +304,47 @@ TEST(parse_complex_json) {
     ASSERT_TRUE(second_score != nullptr);
     ASSERT_INT(1, second_score->key_int);
     ASSERT_NULL(second_score->key_str);
-    ASSERT_INT(JSON_NUMBER, second_score->value->type);
-    ASSERT_DOUBLE(-314.0, second_score->value->number_value, 0.0);
+    ASSERT_INT(JSON_INTEGER, second_score->value->type);
+    ASSERT_INT(-314, second_score->value->integer_value);
     ASSERT_NULL(second_score->next);
     ASSERT_TRUE(second_score == scores_prop->value->array_value.tail);
 
     ASSERT_TRUE(result.value->object_value.tail == scores_prop);
     ASSERT_NULL(scores_prop->next);
 }
+
+TEST(arena_reset_reuses_pools) {
+    ASSERT_INT(JSON_PARSE_SUCCESS, parse_json("{\"a\": [1, \"text\"]}").result.code);
+    ASSERT_TRUE(test_arena->value_pool_used > 0);
+
+    json_arena_reset(test_arena);
+    ASSERT_INT(0, test_arena->string_pool_used);
+    ASSERT_INT(0, test_arena->value_pool_used);
+    ASSERT_INT(0, test_arena->key_pool_used);
+
+    // The next document starts at the beginning of the pools
+    const json_value_parser_result_t result = parse_json("\"b\"");
+    ASSERT_INT(JSON_PARSE_SUCCESS, result.result.code);
+    ASSERT_TRUE(result.value == &test_arena->value_pool[0]);
+    ASSERT_TRUE(result.value->string_value.value == test_arena->string_pool);
+}
+
+TEST(parse_error_before_root_value) {
+    // The parser error is reported when it occurs before the root value is created
+    const json_value_parser_result_t unterminated = parse_json("\"abc");
+    ASSERT_INT(JSON_PARSE_ERROR_UNEXPECTED_END, unterminated.result.code);
+    ASSERT_INT(JSON_CONTEXT_STRING, unterminated.result.context);
+    ASSERT_NULL(unterminated.value);
+
+    const json_value_parser_result_t invalid = parse_json("  x");
+    ASSERT_INT(JSON_PARSE_ERROR_INVALID_SYNTAX, invalid.result.code);
+    ASSERT_INT(2, invalid.result.position);
+    ASSERT_NULL(invalid.value);
+
+    const json_value_parser_result_t empty = parse_json("  ");
+    ASSERT_INT(JSON_ERROR_EMPTY_VALUE, empty.result.error);
+    ASSERT_NULL(empty.value);
+}
 //
 // TEST(parse_error) {
 //     {
@@ -407,3 +494,606 @@ TEST(parse_complex_json) {
 //     ASSERT_INT(2565, result.position);
 //     ASSERT_STR("Maximum structure size exceeded:  at position 2565 while parsing object value", json_parse_error_message(result));
 // }
+
+TEST(format_integer) {
+    const char* json = "[0, 7, -7, 42, 1234567890123, -9223372036854775808, 9223372036854775807]";
+    json_value_parser_result_t result = parse_json(json);
+    ASSERT_INT(JSON_PARSE_SUCCESS, result.result.code);
+
+    char buffer[128];
+    json_formater_result_t formated = json_format_value(result.value, buffer, sizeof(buffer));
+    ASSERT_INT(JSON_FORMATER_SUCCESS, formated.code);
+    ASSERT_STRN(json, formated.result.buffer, formated.result.length);
+    ASSERT_INT(strlen(json), formated.result.length);
+
+    // Not enough space for the last digit
+    formated = json_format_value(result.value, buffer, strlen(json) - 3);
+    ASSERT_INT(JSON_FORMATER_ERROR_BUFFER_TOO_SMALL, formated.code);
+}
+
+static json_arena_t* create_arena(const size_t value_pool_size) {
+    const size_t arena_size = json_arena_size(4096, value_pool_size, value_pool_size);
+    json_arena_t* arena = (json_arena_t*) malloc(arena_size);
+    json_arena_init(arena, arena_size, 4096, value_pool_size, value_pool_size);
+
+    return arena;
+}
+
+TEST(parse_parallel_matches_parse_value) {
+    const char* inputs[] = {
+        "[{\"id\": 1, \"name\": \"a, [b]\"}, {\"id\": 2, \"tags\": [1, 2, {\"x\": \"\\\"]\"}]}, null, true, \"c,d\", 1.5, [], {}, -3]",
+        "  [1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20]  trailing",
+        "[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, ]",
+        "[[1, 2], [3, 4], [5, 6], [7, 8], [9, 10], [11, 12], [13, 14], [15, 16]]",
+        "[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20x]",
+        "[1, 2, 3, 4, 5, 6, 7, 8, 9 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20]",
+        "[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, \"14, 15, 16, 17, 18, 19, 20]",
+        "[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20}",
+        "[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, {\"a\": 1], 17, 18, 19, 20]",
+        "[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20",
+        "[1, 2, 3, 4, 5, 6, 7, 8, 9, 10,, 12, 13, 14, 15, 16, 17, 18, 19, 20]",
+        "[[[[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]]], [[[[[[[[[[[[[[[[[[[[[2]]]]]]]]]]]]]]]]]]]]]",
+        "{\"a\": [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16]}",
+        "[]",
+        "[1]",
+        "42",
+    };
+    const size_t struct_sizes[] = { 0, 38, 39, 8 };
+    const size_t value_pool_sizes[] = { 64, 8 };
+    // The second stack size is too small for the deepest input
+    const size_t stack_sizes[] = { 40, 10 };
+    json_value_t* stack[40];
+    json_value_t* stacks[JSON_VALUE_PARSER_STACKS_SIZE(4, 40)];
+    char expected[1024];
+    char actual[1024];
+
+    for (size_t input = 0; input < sizeof(inputs) / sizeof(inputs[0]); ++input) {
+        for (size_t struct_size = 0; struct_size < sizeof(struct_sizes) / sizeof(struct_sizes[0]); ++struct_size) {
+            for (size_t pool_size = 0; pool_size < sizeof(value_pool_sizes) / sizeof(value_pool_sizes[0]); ++pool_size) {
+                for (size_t worker_count = 1; worker_count <= 4; ++worker_count) {
+                    for (size_t stack_size = 0; stack_size < sizeof(stack_sizes) / sizeof(stack_sizes[0]); ++stack_size) {
+                        const json_parser_options_t options = { .max_depth = 40, .max_struct_size = struct_sizes[struct_size] };
+                        const size_t length = strlen(inputs[input]);
+                        json_arena_t* arenas[4] = { create_arena(64), create_arena(value_pool_sizes[pool_size]), create_arena(64), create_arena(64) };
+                        json_arena_t* reference_arena = create_arena(64);
+
+                        const json_value_parser_result_t reference = json_parse_value(length, inputs[input], reference_arena, stack_sizes[stack_size], stack, json_default_parser_options(options));
+                        const json_value_parser_result_t result = json_parse_value_parallel(length, inputs[input], worker_count, arenas, stack_sizes[stack_size], stacks, options);
+
+                        ASSERT_INT(reference.result.code, result.result.code);
+                        ASSERT_INT(reference.result.context, result.result.context);
+                        ASSERT_INT(reference.result.error, result.result.error);
+                        ASSERT_INT(reference.result.position, result.result.position);
+
+                        if (reference.result.code == JSON_PARSE_SUCCESS) {
+                            const json_formater_result_t expected_format = json_format_value(reference.value, expected, sizeof(expected));
+                            const json_formater_result_t actual_format = json_format_value(result.value, actual, sizeof(actual));
+                            ASSERT_STRN(expected, actual, expected_format.result.length);
+                            ASSERT_INT(expected_format.result.length, actual_format.result.length);
+
+                            if (result.value->type == JSON_ARRAY) {
+                                int key = 0;
+
+                                for (const json_member_entry_t* member = result.value->array_value.head; member != nullptr; member = member->next) {
+                                    ASSERT_INT(key++, member->key_int);
+                                    ASSERT_TRUE(member->next != nullptr || member == result.value->array_value.tail);
+                                }
+
+                                ASSERT_INT(reference.value->array_value.length, key);
+                                ASSERT_INT(key, result.value->array_value.length);
+                            }
+                        }
+
+                        for (size_t i = 0; i < 4; ++i) {
+                            free(arenas[i]);
+                        }
+
+                        free(reference_arena);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(parse_parallel_uses_all_arenas) {
+    const char* json = "[[1, 2], [3, 4], [5, 6], [7, 8], [9, 10], [11, 12], [13, 14], [15, 16]]";
+    json_arena_t* arenas[4] = { create_arena(64), create_arena(64), create_arena(64), create_arena(64) };
+    json_value_t* stacks[JSON_VALUE_PARSER_STACKS_SIZE(4, 32)];
+
+    const json_value_parser_result_t result = json_parse_value_parallel(strlen(json), json, 4, arenas, 32, stacks, (json_parser_options_t) { .max_depth = 32 });
+    ASSERT_INT(JSON_PARSE_SUCCESS, result.result.code);
+    ASSERT_INT(8, result.value->array_value.length);
+    ASSERT_TRUE(result.value == &arenas[0]->value_pool[0]);
+
+    // The root array and the 24 values of the elements, spread over all the arenas
+    size_t value_count = 0;
+
+    for (size_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(arenas[i]->value_pool_used > 0);
+        value_count += arenas[i]->value_pool_used;
+    }
+
+    ASSERT_INT(25, value_count);
+
+    for (size_t i = 0; i < 4; ++i) {
+        free(arenas[i]);
+    }
+}
+
+TEST(parse_value_file) {
+    const char* json = "{\"name\": \"caf\\u00e9\", \"tags\": [\"a\", \"b\"], \"n\": 12}";
+    char path[] = "/tmp/json_test_XXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_TRUE(fd >= 0);
+    ASSERT_INT(strlen(json), write(fd, json, strlen(json)));
+    close(fd);
+
+    const size_t arena_size = json_arena_size(1024, 64, 64);
+    json_arena_t* arena = malloc(arena_size);
+    json_arena_init(arena, arena_size, 1024, 64, 64);
+    json_value_t* stack[32];
+
+    const json_value_parser_result_t result = json_parse_value_file(path, arena, 32, stack, json_default_parser_options((json_parser_options_t) {}));
+    unlink(path);
+
+    // The strings are copied in the arena, so the value outlives the mapping
+    const json_value_parser_result_t expected = parse_json(json);
+    char expected_formatted[256];
+    char formatted[256];
+    const json_formater_result_t expected_format = json_format_value(expected.value, expected_formatted, sizeof(expected_formatted));
+    const json_formater_result_t format = json_format_value(result.value, formatted, sizeof(formatted));
+
+    ASSERT_INT(JSON_PARSE_SUCCESS, result.result.code);
+    ASSERT_INT(JSON_FORMATER_SUCCESS, format.code);
+    ASSERT_INT(expected_format.result.length, format.result.length);
+    ASSERT_STRN(expected_formatted, formatted, format.result.length);
+
+    const json_value_parser_result_t missing_result = json_parse_value_file("/tmp/json_test_missing_file", arena, 32, stack, json_default_parser_options((json_parser_options_t) {}));
+    ASSERT_INT(JSON_ERROR_IO_FAILURE, missing_result.result.error);
+    ASSERT_NULL(missing_result.value);
+
+    free(arena);
+}
+
+static json_value_parser_result_t parse_json_in_arena(const char* json, const size_t string_pool_size, const size_t value_pool_size, const size_t key_pool_size) {
+    const size_t arena_size = json_arena_size(string_pool_size, value_pool_size, key_pool_size);
+    json_value_t* stack[32];
+
+    free(test_arena);
+    test_arena = (json_arena_t*) malloc(arena_size);
+    json_arena_init(test_arena, arena_size, string_pool_size, value_pool_size, key_pool_size);
+
+    return json_parse_value(strlen(json), json, test_arena, 32, stack, json_default_parser_options((json_parser_options_t) { .max_depth = 32 }));
+}
+
+TEST(measure_exact_arena_sizes) {
+    const struct {
+        const char* json;
+        size_t string_pool_size;
+        size_t value_pool_size;
+        size_t key_pool_size;
+    } cases[] = {
+        { "123", 0, 1, 0 },
+        { "  \"abc\"  ", 3, 1, 0 },
+        { "\"a\\\"b\\u00e9\\\\\"", 9, 1, 0 },
+        { "[]", 0, 1, 0 },
+        { "[1, true, null, -2.5e3, \"x\", [], {}]", 1, 8, 7 },
+        { "{\"a\": 1, \"bc\": {\"d\": [1, 2]}, \"e\\\"f\": \"\"}", 7, 7, 6 },
+        { "{\"name\": \"Alice\", \"\": 1}", 10, 3, 2 },
+        { "{\"a\": \"b\", \"\": {\"\": []}}", 3, 4, 3 },
+        { "[1,2,]", 0, 3, 2 },
+        { "[1, 2] [3, 4, 5]", 0, 3, 2 },
+        { "{\"a\":{\"b\":{\"c\":\"}]\\\"\"}}}", 6, 4, 3 },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        const json_measure_result_t measure = json_measure(strlen(cases[i].json), cases[i].json);
+
+        if (measure.string_pool_size != cases[i].string_pool_size || measure.value_pool_size != cases[i].value_pool_size || measure.key_pool_size != cases[i].key_pool_size) {
+            fprintf(stderr, "[INFO] Input: %s\n", cases[i].json);
+        }
+
+        ASSERT_INT(JSON_PARSE_SUCCESS, measure.result.code);
+        ASSERT_INT(cases[i].string_pool_size, measure.string_pool_size);
+        ASSERT_INT(cases[i].value_pool_size, measure.value_pool_size);
+        ASSERT_INT(cases[i].key_pool_size, measure.key_pool_size);
+
+        ASSERT_INT(JSON_PARSE_SUCCESS, parse_json_in_arena(cases[i].json, measure.string_pool_size, measure.value_pool_size, measure.key_pool_size).result.code);
+        // An empty key after the last string needs a free byte in the string pool
+        ASSERT_INT(measure.string_pool_size, test_arena->string_pool_used + (test_arena->string_pool_used < measure.string_pool_size));
+        ASSERT_INT(measure.value_pool_size, test_arena->value_pool_used);
+        ASSERT_INT(measure.key_pool_size, test_arena->key_pool_used);
+        // The pools following an odd sized string pool are aligned
+        ASSERT_INT(0, (uintptr_t) test_arena->value_pool % alignof(json_value_t));
+        ASSERT_INT(0, (uintptr_t) test_arena->key_pool % alignof(json_member_entry_t));
+
+        // The sizes are the minimal ones
+        if (measure.string_pool_size > 0) {
+            const json_value_parser_result_t result = parse_json_in_arena(cases[i].json, measure.string_pool_size - 1, measure.value_pool_size, measure.key_pool_size);
+            ASSERT_INT(JSON_ERROR_OUT_OF_MEMORY, result.result.error);
+        }
+
+        if (measure.key_pool_size > 0) {
+            const json_value_parser_result_t result = parse_json_in_arena(cases[i].json, measure.string_pool_size, measure.value_pool_size, measure.key_pool_size - 1);
+            ASSERT_INT(JSON_ERROR_OUT_OF_MEMORY, result.result.error);
+        }
+
+        const json_value_parser_result_t result = parse_json_in_arena(cases[i].json, measure.string_pool_size, measure.value_pool_size - 1, measure.key_pool_size);
+        ASSERT_INT(JSON_ERROR_OUT_OF_MEMORY, result.result.error);
+    }
+
+    ASSERT_INT(JSON_ERROR_NULL_POINTER, json_measure(0, nullptr).result.error);
+
+    // Invalid documents are not checked, the errors are reported by the parser
+    const char* invalid_inputs[] = { "", "\"abc", "[1, \"a", "}}", "{\"a\"", "[1 2]", "{\"a\": 1" };
+
+    for (size_t i = 0; i < sizeof(invalid_inputs) / sizeof(invalid_inputs[0]); ++i) {
+        const json_measure_result_t measure = json_measure(strlen(invalid_inputs[i]), invalid_inputs[i]);
+        ASSERT_INT(JSON_PARSE_SUCCESS, measure.result.code);
+        ASSERT_TRUE(parse_json_in_arena(invalid_inputs[i], measure.string_pool_size, measure.value_pool_size, measure.key_pool_size).result.code != JSON_PARSE_SUCCESS);
+    }
+
+    // Escape sequences and literals split between two blocks
+    for (size_t padding = 0; padding < 80; ++padding) {
+        char json[256];
+        const int length = snprintf(json, sizeof(json), "{\"%.*s\": \"\\\\\\\"\\n\", \"b\": [true, \"\\\\\", -1.5e3]}", (int) padding, "................................................................................");
+        const json_measure_result_t measure = json_measure((size_t) length, json);
+
+        ASSERT_INT(JSON_PARSE_SUCCESS, parse_json_in_arena(json, measure.string_pool_size, measure.value_pool_size, measure.key_pool_size).result.code);
+        ASSERT_INT(padding + 5, measure.string_pool_size);
+        ASSERT_INT(measure.string_pool_size, test_arena->string_pool_used);
+        ASSERT_INT(6, measure.value_pool_size);
+        ASSERT_INT(5, measure.key_pool_size);
+    }
+}
+
+typedef struct {
+    size_t allocations;
+    size_t releases;
+    size_t allocated_bytes;
+} test_allocator_stats_t;
+
+static void* test_allocate(void* context, const size_t size) {
+    test_allocator_stats_t* stats = context;
+    ++stats->allocations;
+    stats->allocated_bytes += size;
+
+    return malloc(size);
+}
+
+static void test_release(void* context, void* block, const size_t size) {
+    test_allocator_stats_t* stats = context;
+    ++stats->releases;
+    stats->allocated_bytes -= size;
+
+    free(block);
+}
+
+TEST(parse_value_chained_arena) {
+    const char* json = "{\"name\": \"caf\\u00e9 \\\"au lait\\\"\", \"tags\": [\"a\", \"b\", [true, null, -1.5]], \"empty\": {}, \"\": \"\", \"n\": 12}";
+    const json_value_parser_result_t expected = parse_json(json);
+    char expected_formatted[256];
+    const json_formater_result_t expected_format = json_format_value(expected.value, expected_formatted, sizeof(expected_formatted));
+    ASSERT_INT(JSON_FORMATER_SUCCESS, expected_format.code);
+
+    test_allocator_stats_t stats = { 0, 0, 0 };
+    const json_arena_allocator_t allocator = { test_allocate, test_release, &stats, 128 };
+    const size_t arena_size = sizeof(json_arena_t) + sizeof(json_arena_block_t) + 256;
+    json_arena_t* arena = malloc(arena_size);
+    json_value_t* stack[32];
+
+    ASSERT_TRUE(!json_arena_init_chained(arena, sizeof(json_arena_t), allocator));
+    ASSERT_TRUE(json_arena_init_chained(arena, arena_size, allocator));
+
+    // The first block is too small: the arena grows instead of failing
+    for (size_t run = 0; run < 2; ++run) {
+        json_arena_reset(arena);
+
+        const json_value_parser_result_t result = json_parse_value(strlen(json), json, arena, 32, stack, json_default_parser_options((json_parser_options_t) {}));
+        char formatted[256];
+        const json_formater_result_t format = json_format_value(result.value, formatted, sizeof(formatted));
+
+        ASSERT_INT(JSON_PARSE_SUCCESS, result.result.code);
+        ASSERT_INT(JSON_FORMATER_SUCCESS, format.code);
+        ASSERT_INT(expected_format.result.length, format.result.length);
+        ASSERT_STRN(expected_formatted, formatted, format.result.length);
+        ASSERT_INT(test_arena->string_pool_used, arena->string_pool_used);
+        ASSERT_INT(test_arena->value_pool_used, arena->value_pool_used);
+        ASSERT_INT(test_arena->key_pool_used, arena->key_pool_used);
+    }
+
+    // The blocks of the first run are reused by the second one
+    const size_t allocations = stats.allocations;
+    ASSERT_TRUE(allocations > 1);
+    ASSERT_INT(0, stats.releases);
+
+    // A string larger than the block size gets its own block
+    char large_string[512];
+    memset(large_string, 'x', sizeof(large_string));
+    large_string[0] = '"';
+    large_string[sizeof(large_string) - 1] = '"';
+
+    json_arena_reset(arena);
+    const json_value_parser_result_t large_result = json_parse_value(sizeof(large_string), large_string, arena, 32, stack, json_default_parser_options((json_parser_options_t) {}));
+    ASSERT_INT(JSON_PARSE_SUCCESS, large_result.result.code);
+    ASSERT_INT(sizeof(large_string) - 2, large_result.value->string_value.length);
+    ASSERT_STRN(large_string + 1, large_result.value->string_value.value, sizeof(large_string) - 2);
+    ASSERT_INT(allocations + 1, stats.allocations);
+
+    json_arena_release(arena);
+    ASSERT_INT(stats.allocations, stats.releases);
+    ASSERT_INT(0, stats.allocated_bytes);
+    ASSERT_INT(0, arena->value_pool_used);
+
+    // Without allocator, the arena is limited to its first block
+    ASSERT_TRUE(json_arena_init_chained(arena, arena_size, (json_arena_allocator_t) { nullptr, nullptr, nullptr, 0 }));
+    ASSERT_INT(JSON_ERROR_OUT_OF_MEMORY, json_parse_value(strlen(json), json, arena, 32, stack, json_default_parser_options((json_parser_options_t) {})).result.error);
+
+    json_arena_reset(arena);
+    const json_value_parser_result_t small_result = json_parse_value(strlen("[1, \"ab\"]"), "[1, \"ab\"]", arena, 32, stack, json_default_parser_options((json_parser_options_t) {}));
+    ASSERT_INT(JSON_PARSE_SUCCESS, small_result.result.code);
+    ASSERT_INT(2, small_result.value->array_value.length);
+
+    free(arena);
+}
+
+TEST(arena_mark_rollback) {
+    const char* json = "{\"name\": \"caf\\u00e9\", \"tags\": [\"a\", \"b\"], \"n\": 12}";
+    const char* invalid_json = "{\"name\": \"other\", \"tags\": [\"c\", \"d\", }";
+    test_allocator_stats_t stats = { 0, 0, 0 };
+    const size_t pools_size = json_arena_size(1024, 64, 64);
+    const size_t chained_size = sizeof(json_arena_t) + sizeof(json_arena_block_t) + 128;
+    json_arena_t* arenas[2] = { malloc(pools_size), malloc(chained_size) };
+    json_value_t* stack[32];
+
+    json_arena_init(arenas[0], pools_size, 1024, 64, 64);
+    json_arena_init_chained(arenas[1], chained_size, (json_arena_allocator_t) { test_allocate, test_release, &stats, 256 });
+
+    for (size_t i = 0; i < 2; ++i) {
+        json_arena_t* arena = arenas[i];
+        const json_value_parser_result_t kept = json_parse_value(strlen(json), json, arena, 32, stack, json_default_parser_options((json_parser_options_t) {}));
+        ASSERT_INT(JSON_PARSE_SUCCESS, kept.result.code);
+
+        char expected[256];
+        const json_formater_result_t expected_format = json_format_value(kept.value, expected, sizeof(expected));
+        ASSERT_INT(JSON_FORMATER_SUCCESS, expected_format.code);
+
+        const json_arena_mark_t mark = json_arena_mark(arena);
+        size_t allocations = 0;
+
+        for (size_t run = 0; run < 100; ++run) {
+            const json_value_parser_result_t failed = json_parse_value(strlen(invalid_json), invalid_json, arena, 32, stack, json_default_parser_options((json_parser_options_t) {}));
+            ASSERT_INT(JSON_PARSE_ERROR_INVALID_SYNTAX, failed.result.code);
+            ASSERT_TRUE(arena->value_pool_used > mark.value_pool_used);
+
+            json_arena_rollback(arena, mark);
+            ASSERT_INT(mark.string_pool_used, arena->string_pool_used);
+            ASSERT_INT(mark.value_pool_used, arena->value_pool_used);
+            ASSERT_INT(mark.key_pool_used, arena->key_pool_used);
+
+            // A discarded document
+            ASSERT_INT(JSON_PARSE_SUCCESS, json_parse_value(strlen(json), json, arena, 32, stack, json_default_parser_options((json_parser_options_t) {})).result.code);
+            json_arena_rollback(arena, mark);
+
+            if (run == 0) {
+                allocations = stats.allocations;
+            }
+        }
+
+        // The blocks chained after the mark by the first run are reused by the next ones
+        ASSERT_INT(allocations, stats.allocations);
+
+        // The values created before the mark are not overwritten
+        char formatted[256];
+        const json_formater_result_t format = json_format_value(kept.value, formatted, sizeof(formatted));
+        ASSERT_INT(expected_format.result.length, format.result.length);
+        ASSERT_STRN(expected, formatted, format.result.length);
+
+        json_arena_reset(arena);
+        ASSERT_INT(0, arena->string_pool_used);
+        ASSERT_INT(0, arena->value_pool_used);
+        ASSERT_INT(0, arena->key_pool_used);
+    }
+
+    json_arena_release(arenas[1]);
+    ASSERT_INT(0, stats.allocated_bytes);
+
+    free(arenas[0]);
+    free(arenas[1]);
+}
+
+TEST(arena_pool_reuse_arenas) {
+    test_allocator_stats_t stats = { 0, 0, 0 };
+    json_arena_pool_slot_t slots[2];
+    json_arena_pool_t pool;
+    const json_arena_allocator_t allocator = { test_allocate, test_release, &stats, 256 };
+    json_value_t* stack[32];
+
+    ASSERT_TRUE(!json_arena_pool_init(&pool, (json_arena_pool_options_t) { .mode = JSON_ARENA_POOLS }, 2, slots));
+    ASSERT_TRUE(!json_arena_pool_init(&pool, (json_arena_pool_options_t) { .allocator = allocator, .mode = JSON_ARENA_CHAINED, .arena_size = 8 }, 2, slots));
+
+    const json_arena_pool_options_t options[] = {
+        { .allocator = allocator, .mode = JSON_ARENA_POOLS, .string_pool_size = 64, .value_pool_size = 16, .key_pool_size = 16 },
+        { .allocator = allocator, .mode = JSON_ARENA_CHAINED, .arena_size = sizeof(json_arena_t) + sizeof(json_arena_block_t) + 64 },
+    };
+
+    for (size_t i = 0; i < 2; ++i) {
+        ASSERT_TRUE(json_arena_pool_init(&pool, options[i], 2, slots));
+
+        json_arena_t* first = json_arena_pool_acquire(&pool);
+        ASSERT_TRUE(first != nullptr);
+        ASSERT_INT(options[i].mode, first->mode);
+        ASSERT_INT(JSON_PARSE_SUCCESS, json_parse_value(strlen("{\"a\": [1, 2, \"b\"]}"), "{\"a\": [1, 2, \"b\"]}", first, 32, stack, json_default_parser_options((json_parser_options_t) {})).result.code);
+        json_arena_pool_release(&pool, first);
+
+        // The released arena is given back, empty
+        json_arena_t* second = json_arena_pool_acquire(&pool);
+        ASSERT_TRUE(second == first);
+        ASSERT_INT(0, second->value_pool_used);
+        ASSERT_INT(0, second->string_pool_used);
+
+        json_arena_t* arenas[3] = { second, json_arena_pool_acquire(&pool), json_arena_pool_acquire(&pool) };
+        ASSERT_TRUE(arenas[1] != nullptr && arenas[2] != nullptr && arenas[1] != arenas[2]);
+
+        // The pool only keeps two idle arenas
+        for (size_t j = 0; j < 3; ++j) {
+            json_arena_pool_release(&pool, arenas[j]);
+        }
+
+        const json_arena_pool_stats_t pool_stats = json_arena_pool_stats(&pool);
+        ASSERT_INT(1, pool_stats.hits);
+        ASSERT_INT(3, pool_stats.misses);
+        ASSERT_INT(1, pool_stats.evictions);
+
+        json_arena_pool_destroy(&pool);
+        ASSERT_INT(stats.allocations, stats.releases);
+        ASSERT_INT(0, stats.allocated_bytes);
+    }
+}
+
+typedef struct {
+    json_arena_pool_t* pool;
+    size_t failures;
+} test_arena_pool_worker_t;
+
+static void* test_arena_pool_worker(void* data) {
+    test_arena_pool_worker_t* worker = data;
+    const char* json = "{\"id\": 42, \"name\": \"caf\\u00e9\", \"tags\": [\"a\", \"b\", \"c\"], \"nested\": {\"x\": [1, 2, 3]}}";
+    json_value_t* stack[32];
+
+    for (size_t i = 0; i < 2000; ++i) {
+        json_arena_t* arena = json_arena_pool_acquire(worker->pool);
+
+        if (arena == nullptr) {
+            ++worker->failures;
+            continue;
+        }
+
+        const json_value_parser_result_t result = json_parse_value(strlen(json), json, arena, 32, stack, json_default_parser_options((json_parser_options_t) {}));
+
+        if (result.result.code != JSON_PARSE_SUCCESS || result.value->object_value.length != 4) {
+            ++worker->failures;
+        }
+
+        json_arena_pool_release(worker->pool, arena);
+    }
+
+    return nullptr;
+}
+
+TEST(arena_pool_concurrent_threads) {
+    constexpr size_t thread_count = 8;
+    json_arena_pool_slot_t slots[thread_count];
+    json_arena_pool_t pool;
+    pthread_t threads[thread_count];
+    test_arena_pool_worker_t workers[thread_count];
+
+    const json_arena_pool_options_t options = {
+        .allocator = json_arena_page_allocator(4096, true),
+        .mode = JSON_ARENA_CHAINED,
+        .arena_size = 4096,
+    };
+
+    ASSERT_TRUE(json_arena_pool_init(&pool, options, thread_count, slots));
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers[i] = (test_arena_pool_worker_t) { &pool, 0 };
+        ASSERT_INT(0, pthread_create(&threads[i], nullptr, test_arena_pool_worker, &workers[i]));
+    }
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        pthread_join(threads[i], nullptr);
+        ASSERT_INT(0, workers[i].failures);
+    }
+
+    // Each thread holds at most one arena at a time
+    const json_arena_pool_stats_t stats = json_arena_pool_stats(&pool);
+    ASSERT_INT(thread_count * 2000, stats.hits + stats.misses);
+    ASSERT_TRUE(stats.misses - stats.evictions <= thread_count);
+
+    json_arena_pool_destroy(&pool);
+}
+
+TEST(parse_value_borrowed) {
+    const char* json = "{\"name\": \"Alice\", \"quote\": \"a \\\"b\\\"\", \"esc\\\\key\": [\"x\", \"\"], \"n\": 1}";
+    const json_value_parser_result_t expected = parse_json(json);
+    char expected_formatted[256];
+    const json_formater_result_t expected_format = json_format_value(expected.value, expected_formatted, sizeof(expected_formatted));
+    ASSERT_INT(JSON_FORMATER_SUCCESS, expected_format.code);
+
+    const size_t arena_size = json_arena_size(64, 16, 16);
+    json_arena_t* arena = malloc(arena_size);
+    json_arena_init(arena, arena_size, 64, 16, 16);
+    json_value_t* stack[32];
+
+    const json_value_parser_result_t result = json_parse_value_borrowed(strlen(json), json, arena, 32, stack, json_default_parser_options((json_parser_options_t) {}));
+    ASSERT_INT(JSON_PARSE_SUCCESS, result.result.code);
+
+    char formatted[256];
+    const json_formater_result_t format = json_format_value(result.value, formatted, sizeof(formatted));
+    ASSERT_INT(expected_format.result.length, format.result.length);
+    ASSERT_STRN(expected_formatted, formatted, format.result.length);
+
+    // Only the escaped key and string are decoded in the arena
+    ASSERT_INT(strlen("a \"b\"") + strlen("esc\\key"), arena->string_pool_used);
+
+    const json_member_entry_t* name = result.value->object_value.head;
+    ASSERT_TRUE(name->key_str == json + 2);
+    ASSERT_TRUE(name->value->string_value.value == json + 10);
+    ASSERT_INT(5, name->value->string_value.length);
+
+    const json_member_entry_t* quote = name->next;
+    ASSERT_TRUE(quote->key_str == json + 19);
+    ASSERT_TRUE(quote->value->string_value.value == arena->string_pool);
+
+    const json_member_entry_t* escaped_key = quote->next;
+    ASSERT_TRUE(escaped_key->key_str == arena->string_pool + strlen("a \"b\""));
+    ASSERT_STRN("x", escaped_key->value->array_value.head->value->string_value.value, 1);
+    ASSERT_TRUE(escaped_key->value->array_value.head->value->string_value.value == strchr(json, 'x'));
+
+    free(arena);
+}
+
+TEST(parse_value_in_situ) {
+    const char* json = "{\"name\": \"Alice\", \"quote\": \"a \\\"b\\\"\\t\", \"esc\\\\key\": [\"x\\u00e9\", \"\"], \"n\": 1}";
+    const json_value_parser_result_t expected = parse_json(json);
+    char expected_formatted[256];
+    const json_formater_result_t expected_format = json_format_value(expected.value, expected_formatted, sizeof(expected_formatted));
+    ASSERT_INT(JSON_FORMATER_SUCCESS, expected_format.code);
+
+    // The string pool is not needed
+    const size_t arena_size = json_arena_size(0, 16, 16);
+    json_arena_t* arena = malloc(arena_size);
+    json_arena_init(arena, arena_size, 0, 16, 16);
+    json_value_t* stack[32];
+    char buffer[256];
+    strcpy(buffer, json);
+
+    const json_value_parser_result_t result = json_parse_value_in_situ(strlen(buffer), buffer, arena, 32, stack, json_default_parser_options((json_parser_options_t) {}));
+    ASSERT_INT(JSON_PARSE_SUCCESS, result.result.code);
+    ASSERT_INT(0, arena->string_pool_used);
+
+    char formatted[256];
+    const json_formater_result_t format = json_format_value(result.value, formatted, sizeof(formatted));
+    ASSERT_INT(expected_format.result.length, format.result.length);
+    ASSERT_STRN(expected_formatted, formatted, format.result.length);
+
+    // All the strings point into the buffer, decoded in place after their opening quote
+    const json_member_entry_t* name = result.value->object_value.head;
+    ASSERT_TRUE(name->value->string_value.value == buffer + 10);
+
+    const json_member_entry_t* quote = name->next;
+    ASSERT_TRUE(quote->value->string_value.value == buffer + 28);
+    ASSERT_INT(6, quote->value->string_value.length);
+    ASSERT_STRN("a \"b\"\t", quote->value->string_value.value, 6);
+
+    const json_member_entry_t* escaped_key = quote->next;
+    ASSERT_TRUE(escaped_key->key_str == buffer + 41);
+    ASSERT_INT(7, escaped_key->key_int);
+    ASSERT_STRN("esc\\key", escaped_key->key_str, 7);
+    ASSERT_TRUE(escaped_key->value->array_value.head->value->string_value.value >= buffer);
+    ASSERT_TRUE(escaped_key->value->array_value.head->value->string_value.value < buffer + sizeof(buffer));
+
+    free(arena);
+}
@@ -0,0 +1,187 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "arena_pool.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+bool json_arena_pool_init(json_arena_pool_t* pool, const json_arena_pool_options_t options, const size_t slot_count, json_arena_pool_slot_t slots[slot_count]) {
+    if (options.allocator.allocate == nullptr || (slot_count > 0 && slots == nullptr)) {
+        return false;
+    }
+
+    size_t arena_size;
+
+    if (options.mode == JSON_ARENA_CHAINED) {
+        if (options.arena_size < sizeof(json_arena_t) + sizeof(json_arena_block_t)) {
+            return false;
+        }
+
+        arena_size = options.arena_size;
+    } else {
+        arena_size = json_arena_size(options.string_pool_size, options.value_pool_size, options.key_pool_size);
+    }
+
+    pool->options = options;
+    pool->arena_size = arena_size;
+    pool->slot_count = slot_count;
+    pool->slots = slots;
+
+    for (size_t i = 0; i < slot_count; ++i) {
+        atomic_init(&slots[i].arena, nullptr);
+    }
+
+    atomic_init(&pool->hits, 0);
+    atomic_init(&pool->misses, 0);
+    atomic_init(&pool->evictions, 0);
+
+    return true;
+}
+
+/**
+ * The first slot searched by the calling thread: the slot of the CPU running it, so threads running at the same time
+ * start on different slots when there are as many slots as CPUs. If the CPU is unknown, the thread identifier is hashed,
+ * and two threads can then start on the same slot.
+ */
+static size_t json_arena_pool_thread_slot(const json_arena_pool_t* pool) {
+    const int cpu = sched_getcpu();
+
+    if (cpu >= 0) {
+        return (size_t) cpu % pool->slot_count;
+    }
+
+    const uint64_t hash = (uint64_t) pthread_self() * 0x9E3779B97F4A7C15ULL;
+
+    return (size_t) (hash >> 32) % pool->slot_count;
+}
+
+static void json_arena_pool_free(const json_arena_pool_t* pool, json_arena_t* arena) {
+    json_arena_release(arena);
+
+    if (pool->options.allocator.release != nullptr) {
+        pool->options.allocator.release(pool->options.allocator.context, arena, pool->arena_size);
+    }
+}
+
+json_arena_t* json_arena_pool_acquire(json_arena_pool_t* pool) {
+    if (pool->slot_count > 0) {
+        const size_t start = json_arena_pool_thread_slot(pool);
+
+        for (size_t i = 0; i < pool->slot_count; ++i) {
+            json_arena_pool_slot_t* slot = &pool->slots[(start + i) % pool->slot_count];
+
+            // Check before taking the slot, so empty slots are only read, and their cache line stays shared
+            if (atomic_load_explicit(&slot->arena, memory_order_relaxed) == nullptr) {
+                continue;
+            }
+
+            json_arena_t* arena = atomic_exchange_explicit(&slot->arena, nullptr, memory_order_acquire);
+
+            if (arena != nullptr) {
+                atomic_fetch_add_explicit(&pool->hits, 1, memory_order_relaxed);
+                return arena;
+            }
+        }
+    }
+
+    atomic_fetch_add_explicit(&pool->misses, 1, memory_order_relaxed);
+
+    // The arena is initialized by the thread which will use it, so its first pages are local to this thread
+    json_arena_t* arena = pool->options.allocator.allocate(pool->options.allocator.context, pool->arena_size);
+
+    if (arena == nullptr) {
+        return nullptr;
+    }
+
+    if (pool->options.mode == JSON_ARENA_CHAINED) {
+        json_arena_init_chained(arena, pool->arena_size, pool->options.allocator);
+    } else {
+        json_arena_init(arena, pool->arena_size, pool->options.string_pool_size, pool->options.value_pool_size, pool->options.key_pool_size);
+    }
+
+    return arena;
+}
+
+void json_arena_pool_release(json_arena_pool_t* pool, json_arena_t* arena) {
+    if (arena == nullptr) {
+        return;
+    }
+
+    json_arena_reset(arena);
+
+    if (pool->slot_count > 0) {
+        const size_t start = json_arena_pool_thread_slot(pool);
+
+        for (size_t i = 0; i < pool->slot_count; ++i) {
+            json_arena_pool_slot_t* slot = &pool->slots[(start + i) % pool->slot_count];
+            json_arena_t* expected = nullptr;
+
+            if (
+                atomic_load_explicit(&slot->arena, memory_order_relaxed) == nullptr
+                && atomic_compare_exchange_strong_explicit(&slot->arena, &expected, arena, memory_order_release, memory_order_relaxed)
+            ) {
+                return;
+            }
+        }
+    }
+
+    atomic_fetch_add_explicit(&pool->evictions, 1, memory_order_relaxed);
+    json_arena_pool_free(pool, arena);
+}
+
+json_arena_pool_stats_t json_arena_pool_stats(const json_arena_pool_t* pool) {
+    return (json_arena_pool_stats_t) {
+        .hits = atomic_load_explicit(&pool->hits, memory_order_relaxed),
+        .misses = atomic_load_explicit(&pool->misses, memory_order_relaxed),
+        .evictions = atomic_load_explicit(&pool->evictions, memory_order_relaxed),
+    };
+}
+
+void json_arena_pool_destroy(json_arena_pool_t* pool) {
+    for (size_t i = 0; i < pool->slot_count; ++i) {
+        json_arena_t* arena = atomic_exchange_explicit(&pool->slots[i].arena, nullptr, memory_order_acquire);
+
+        if (arena != nullptr) {
+            json_arena_pool_free(pool, arena);
+        }
+    }
+}
+
+static void* json_arena_page_allocate(void* context, const size_t size) {
+    (void) context;
+
+    void* block = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    return block == MAP_FAILED ? nullptr : block;
+}
+
+static void* json_arena_huge_page_allocate(void* context, const size_t size) {
+    void* block = json_arena_page_allocate(context, size);
+
+#ifdef MADV_HUGEPAGE
+    if (block != nullptr) {
+        // Only a hint: the pages are still usable if it is rejected
+        madvise(block, size, MADV_HUGEPAGE);
+    }
+#endif
+
+    return block;
+}
+
+static void json_arena_page_release(void* context, void* block, const size_t size) {
+    (void) context;
+    munmap(block, size);
+}
+
+json_arena_allocator_t json_arena_page_allocator(const size_t block_size, const bool huge_pages) {
+    return (json_arena_allocator_t) {
+        .allocate = huge_pages ? json_arena_huge_page_allocate : json_arena_page_allocate,
+        .release = json_arena_page_release,
+        .context = nullptr,
+        .block_size = block_size,
+    };
+}
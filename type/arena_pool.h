@@ -0,0 +1,126 @@
+#ifndef JSON_TYPES_ARENA_POOL_H
+#define JSON_TYPES_ARENA_POOL_H
+
+#include <stdatomic.h>
+
+#include "factory.h"
+
+/**
+ * A slot of the pool free list, holding an idle arena or nullptr.
+ * Each slot is on its own cache line, so threads releasing and acquiring arenas on different slots do not contend.
+ */
+typedef struct {
+    alignas(64) _Atomic(json_arena_t*) arena;
+} json_arena_pool_slot_t;
+
+/**
+ * Description of the arenas created by a pool.
+ */
+typedef struct {
+    /**
+     * Allocate the memory of the arenas, and the blocks of chained arenas. The allocate function is required.
+     */
+    json_arena_allocator_t allocator;
+
+    json_arena_mode_t mode;
+
+    /**
+     * Pools mode only: the pool sizes of each arena, see `json_arena_init()`
+     */
+    size_t string_pool_size;
+    size_t value_pool_size;
+    size_t key_pool_size;
+
+    /**
+     * Chained mode only: the size of each arena, see `json_arena_init_chained()`
+     */
+    size_t arena_size;
+} json_arena_pool_options_t;
+
+typedef struct {
+    json_arena_pool_options_t options;
+
+    /**
+     * The memory size of each arena
+     */
+    size_t arena_size;
+
+    size_t slot_count;
+    json_arena_pool_slot_t* slots;
+
+    /**
+     * Number of arenas taken from the free list
+     */
+    atomic_size_t hits;
+
+    /**
+     * Number of arenas allocated because the free list was empty
+     */
+    atomic_size_t misses;
+
+    /**
+     * Number of arenas freed because the free list was full
+     */
+    atomic_size_t evictions;
+} json_arena_pool_t;
+
+typedef struct {
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+} json_arena_pool_stats_t;
+
+/**
+ * Initialize a pool of arenas shared by several threads.
+ *
+ * Idle arenas are kept in a fixed array of slots, acquired and released with atomic operations only, so the pool is lock-free.
+ * Each thread starts its search at the slot of the CPU it runs on, so threads on different CPUs do not contend on the same
+ * slot, and a thread which releases an arena usually gets the same one back, while its memory is still in the caches.
+ * Use at least as many slots as CPUs: with fewer slots, several CPUs share each slot.
+ *
+ * The pool does not bind memory to NUMA nodes: new arenas are initialized by the thread acquiring them, and the kernel
+ * places their pages on the node of the first thread touching them. An arena released by a thread can then be acquired
+ * by a thread of another node, and keeps its pages on the first node.
+ *
+ * @param slot_count The maximal number of idle arenas. Usually the largest of the number of threads and the number of CPUs.
+ * @param slots The free list of the pool.
+ * @return false if the options are invalid: no allocate function, or arena sizes rejected by the arena initialization.
+ */
+bool json_arena_pool_init(json_arena_pool_t* pool, json_arena_pool_options_t options, size_t slot_count, json_arena_pool_slot_t slots[slot_count]);
+
+/**
+ * Get an empty arena from the pool, or allocate a new one if there is no idle arena.
+ * Can be called from any thread.
+ *
+ * @return The arena, or nullptr if the allocation failed.
+ */
+json_arena_t* json_arena_pool_acquire(json_arena_pool_t* pool);
+
+/**
+ * Give back an arena acquired from the pool. The arena is reset, and freed if the pool already holds slot_count idle arenas.
+ * Can be called from any thread. All the values of the arena become invalid.
+ */
+void json_arena_pool_release(json_arena_pool_t* pool, json_arena_t* arena);
+
+/**
+ * Get the counters of the pool. The counters are read one by one, so they may not be consistent with each other
+ * while other threads use the pool.
+ */
+json_arena_pool_stats_t json_arena_pool_stats(const json_arena_pool_t* pool);
+
+/**
+ * Free all the idle arenas of the pool. The acquired arenas must be released before.
+ * Must not be called concurrently with other functions of the pool.
+ */
+void json_arena_pool_destroy(json_arena_pool_t* pool);
+
+/**
+ * An allocator mapping anonymous pages with mmap(), to use with a pool or a chained arena.
+ * With huge_pages, the kernel is asked to back the blocks with transparent huge pages, reducing TLB misses on large arenas.
+ * This is only a hint: the allocation does not fail if huge pages are not available.
+ *
+ * @param block_size The minimal size of the blocks of chained arenas.
+ */
+json_arena_allocator_t json_arena_page_allocator(size_t block_size, bool huge_pages);
+
+#endif //JSON_TYPES_ARENA_POOL_H
@@ -4,11 +4,20 @@
 
 #include "factory.h"
 
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+
+/**
+ * The memory taken by the string pool: it is padded so the value and key pools following it are aligned.
+ */
+static size_t json_arena_string_pool_span(const size_t string_pool_size) {
+    return (string_pool_size + alignof(json_value_t) - 1) / alignof(json_value_t) * alignof(json_value_t);
+}
 
 size_t json_arena_size(const size_t string_pool_size, const size_t value_pool_size, const size_t key_pool_size) {
     return sizeof(json_arena_t)
-        + string_pool_size * sizeof(char)
+        + json_arena_string_pool_span(string_pool_size * sizeof(char))
         + value_pool_size * sizeof(json_value_t)
         + key_pool_size * sizeof(json_member_entry_t)
     ;
@@ -21,11 +30,13 @@ bool json_arena_init(json_arena_t* arena, const size_t arena_size, const size_t
 
     char* buffer = (char*) arena + sizeof(json_arena_t);
 
+    arena->mode = JSON_ARENA_POOLS;
+
     arena->string_pool = buffer;
     arena->string_pool_size = string_pool_size;
     arena->string_pool_used = 0;
 
-    buffer += string_pool_size * sizeof(char);
+    buffer += json_arena_string_pool_span(string_pool_size * sizeof(char));
     arena->value_pool = (json_value_t*) buffer;
     arena->value_pool_size = value_pool_size;
     arena->value_pool_used = 0;
@@ -35,10 +46,161 @@ bool json_arena_init(json_arena_t* arena, const size_t arena_size, const size_t
     arena->key_pool_size = key_pool_size;
     arena->key_pool_used = 0;
 
+    arena->allocator = (json_arena_allocator_t) { nullptr, nullptr, nullptr, 0 };
+    arena->first_block = nullptr;
+    arena->current_block = nullptr;
+    arena->bump = nullptr;
+
+    return true;
+}
+
+static char* json_arena_block_data(json_arena_block_t* block) {
+    return (char*) block + sizeof(json_arena_block_t);
+}
+
+bool json_arena_init_chained(json_arena_t* arena, const size_t arena_size, const json_arena_allocator_t allocator) {
+    if (arena_size < sizeof(json_arena_t) + sizeof(json_arena_block_t)) {
+        return false;
+    }
+
+    json_arena_block_t* first_block = (json_arena_block_t*) ((char*) arena + sizeof(json_arena_t));
+
+    // The links are stored in the blocks, so a copy of the arena structure can be restored without losing blocks
+    first_block->next = nullptr;
+    first_block->size = arena_size - sizeof(json_arena_t) - sizeof(json_arena_block_t);
+
+    *arena = (json_arena_t) {
+        .mode = JSON_ARENA_CHAINED,
+        .allocator = allocator,
+        .first_block = first_block,
+        .current_block = first_block,
+        .bump = json_arena_block_data(first_block),
+    };
+
     return true;
 }
 
+void json_arena_reset(json_arena_t* arena) {
+    arena->string_pool_used = 0;
+    arena->value_pool_used = 0;
+    arena->key_pool_used = 0;
+
+    if (arena->mode == JSON_ARENA_CHAINED) {
+        arena->current_block = arena->first_block;
+        arena->bump = json_arena_block_data(arena->first_block);
+    }
+}
+
+json_arena_mark_t json_arena_mark(const json_arena_t* arena) {
+    return (json_arena_mark_t) {
+        .string_pool_used = arena->string_pool_used,
+        .value_pool_used = arena->value_pool_used,
+        .key_pool_used = arena->key_pool_used,
+        .block = arena->current_block,
+        .bump = arena->bump,
+    };
+}
+
+void json_arena_rollback(json_arena_t* arena, const json_arena_mark_t mark) {
+    arena->string_pool_used = mark.string_pool_used;
+    arena->value_pool_used = mark.value_pool_used;
+    arena->key_pool_used = mark.key_pool_used;
+
+    if (arena->mode == JSON_ARENA_CHAINED) {
+        // The following blocks stay linked after the marked one
+        arena->current_block = mark.block;
+        arena->bump = mark.bump;
+    }
+}
+
+void json_arena_release(json_arena_t* arena) {
+    if (arena->mode == JSON_ARENA_CHAINED) {
+        json_arena_block_t* block = arena->first_block->next;
+
+        while (block != nullptr) {
+            json_arena_block_t* next = block->next;
+
+            if (arena->allocator.release != nullptr) {
+                arena->allocator.release(arena->allocator.context, block, sizeof(json_arena_block_t) + block->size);
+            }
+
+            block = next;
+        }
+
+        arena->first_block->next = nullptr;
+    }
+
+    json_arena_reset(arena);
+}
+
+/**
+ * Move the bump region of a chained arena to the next block having at least the given number of bytes.
+ * The following block is reused if it is large enough, else a new one is allocated and inserted before it.
+ */
+static bool json_arena_next_block(json_arena_t* arena, const size_t size) {
+    json_arena_block_t* next = arena->current_block->next;
+
+    if (next == nullptr || next->size < size) {
+        if (arena->allocator.allocate == nullptr || size > SIZE_MAX - sizeof(json_arena_block_t)) {
+            return false;
+        }
+
+        const size_t block_size = sizeof(json_arena_block_t) + size > arena->allocator.block_size
+            ? sizeof(json_arena_block_t) + size
+            : arena->allocator.block_size
+        ;
+        json_arena_block_t* block = arena->allocator.allocate(arena->allocator.context, block_size);
+
+        if (block == nullptr) {
+            return false;
+        }
+
+        block->next = next;
+        block->size = block_size - sizeof(json_arena_block_t);
+        arena->current_block->next = block;
+        next = block;
+    }
+
+    arena->current_block = next;
+    arena->bump = json_arena_block_data(next);
+
+    return true;
+}
+
+/**
+ * Get an aligned free area of the given size in the bump region of a chained arena, without allocating it:
+ * move the bump pointer after the used bytes to allocate them.
+ */
+static char* json_arena_reserve(json_arena_t* arena, const size_t size, const size_t alignment) {
+    for (;;) {
+        char* end = json_arena_block_data(arena->current_block) + arena->current_block->size;
+        const size_t padding = (alignment - (uintptr_t) arena->bump % alignment) % alignment;
+
+        if ((size_t) (end - arena->bump) >= padding && (size_t) (end - arena->bump) - padding >= size) {
+            return arena->bump + padding;
+        }
+
+        if (size > SIZE_MAX - alignment || !json_arena_next_block(arena, size + alignment)) {
+            return nullptr;
+        }
+    }
+}
+
 static json_value_t* json_arena_push_value(json_arena_t* arena, const json_value_t value) {
+    if (arena->mode == JSON_ARENA_CHAINED) {
+        json_value_t* slot = (json_value_t*) json_arena_reserve(arena, sizeof(json_value_t), alignof(json_value_t));
+
+        if (slot == nullptr) {
+            return nullptr;
+        }
+
+        arena->bump = (char*) (slot + 1);
+        ++arena->value_pool_used;
+        *slot = value;
+
+        return slot;
+    }
+
     if (arena->value_pool_used >= arena->value_pool_size) {
         return nullptr;
     }
@@ -49,6 +211,31 @@ static json_value_t* json_arena_push_value(json_arena_t* arena, const json_value
     return &arena->value_pool[index];
 }
 
+static json_member_entry_t* json_arena_push_member(json_arena_t* arena, const json_member_entry_t member) {
+    if (arena->mode == JSON_ARENA_CHAINED) {
+        json_member_entry_t* slot = (json_member_entry_t*) json_arena_reserve(arena, sizeof(json_member_entry_t), alignof(json_member_entry_t));
+
+        if (slot == nullptr) {
+            return nullptr;
+        }
+
+        arena->bump = (char*) (slot + 1);
+        ++arena->key_pool_used;
+        *slot = member;
+
+        return slot;
+    }
+
+    if (arena->key_pool_used >= arena->key_pool_size) {
+        return nullptr;
+    }
+
+    const size_t index = arena->key_pool_used++;
+    arena->key_pool[index] = member;
+
+    return &arena->key_pool[index];
+}
+
 json_value_t* json_create_null_value(json_arena_t* arena) {
     return json_arena_push_value(arena, (json_value_t) { .type = JSON_NULL });
 }
@@ -67,63 +254,109 @@ json_value_t* json_create_number_value(json_arena_t* arena, const double value)
     });
 }
 
+json_value_t* json_create_integer_value(json_arena_t* arena, const int64_t value) {
+    return json_arena_push_value(arena, (json_value_t) {
+        .type = JSON_INTEGER,
+        .integer_value = value,
+    });
+}
+
 typedef struct {
     const ssize_t length;
     char* value;
 } json_internal_parsed_string_t;
 
-static json_internal_parsed_string_t json_arena_parse_raw_string(json_arena_t* arena, const char* str, size_t str_length) {
-    // @todo assert for surounding quotes
-    bool is_escaped = false;
-    const size_t start_index = arena->string_pool_used;
-    ssize_t length = 0;
+static char json_decode_escaped_char(const char escaped_char) {
+    // @todo handle unicode escape sequences
+    switch (escaped_char) {
+        case 'n':
+            return '\n';
+        case 'r':
+            return '\r';
+        case 't':
+            return '\t';
+        case 'b':
+            return '\b';
+        case 'f':
+            return '\f';
+        case '0':
+            return '\0';
+        default:
+            // Keep the character as is for other escape sequences
+            return escaped_char;
+    }
+}
 
+ssize_t json_decode_raw_string(const char* raw, const size_t raw_length, char* output, const size_t output_size) {
+    // @todo assert for surounding quotes
     // Skip the surrounding quotes
-    for (size_t i = 1; i < str_length - 1; ++i) {
-        if (arena->string_pool_used >= arena->string_pool_size) {
-            return (json_internal_parsed_string_t) { .length = -1, .value = nullptr };
+    const size_t end = raw_length - 1;
+    size_t length = 0;
+
+    for (size_t i = 1; i < end;) {
+        // Copy the characters up to the next escape sequence at once
+        const char* backslash = memchr(raw + i, '\\', end - i);
+        const size_t chunk_length = (backslash == nullptr ? end : (size_t) (backslash - raw)) - i;
+
+        if (chunk_length > output_size - length) {
+            return -1;
         }
 
-        char current_char = str[i];
+        // The output may overlap the input when the string is decoded in place
+        memmove(output + length, raw + i, chunk_length);
+        length += chunk_length;
+        i += chunk_length + 1;
 
-        if (!is_escaped && current_char == '\\') {
-            is_escaped = true;
-            continue;
+        if (i > end) {
+            break;
         }
 
-        if (is_escaped) {
-            // @todo handle unicode escape sequences
-            switch (current_char) {
-                case 'n':
-                    current_char = '\n';
-                    break;
-                case 'r':
-                    current_char = '\r';
-                    break;
-                case 't':
-                    current_char = '\t';
-                    break;
-                case 'b':
-                    current_char = '\b';
-                    break;
-                case 'f':
-                    current_char = '\f';
-                    break;
-                case '0':
-                    current_char = '\0';
-                    break;
-                default:
-                    // Keep the character as is for other escape sequences
-                    break;
-            }
+        if (length >= output_size) {
+            return -1;
+        }
 
-            is_escaped = false;
+        if (i < end) {
+            output[length++] = json_decode_escaped_char(raw[i++]);
         }
+    }
+
+    return (ssize_t) length;
+}
+
+static json_internal_parsed_string_t json_arena_parse_raw_string(json_arena_t* arena, const char* str, const size_t str_length) {
+    if (arena->mode == JSON_ARENA_CHAINED) {
+        // The decoded string is never longer than the raw one without its quotes
+        const size_t max_length = str_length > 2 ? str_length - 2 : 0;
+        char* output = json_arena_reserve(arena, max_length, 1);
+
+        if (output == nullptr) {
+            return (json_internal_parsed_string_t) { .length = -1, .value = nullptr };
+        }
+
+        const ssize_t length = json_decode_raw_string(str, str_length, output, max_length);
+
+        if (length < 0) {
+            return (json_internal_parsed_string_t) { .length = -1, .value = nullptr };
+        }
+
+        arena->bump = output + length;
+        arena->string_pool_used += (size_t) length;
+
+        return (json_internal_parsed_string_t) {
+            .length = length,
+            .value = output,
+        };
+    }
+
+    const size_t start_index = arena->string_pool_used;
+    const ssize_t length = json_decode_raw_string(str, str_length, &arena->string_pool[start_index], arena->string_pool_size - start_index);
 
-        arena->string_pool[arena->string_pool_used++] = current_char;
-        ++length;
+    if (length < 0) {
+        return (json_internal_parsed_string_t) { .length = -1, .value = nullptr };
     }
 
+    arena->string_pool_used += (size_t) length;
+
     return (json_internal_parsed_string_t) {
         .length = length,
         .value = &arena->string_pool[start_index],
@@ -146,6 +379,20 @@ json_value_t* json_create_string_value(json_arena_t* arena, const char* str, con
     });
 }
 
+json_value_t* json_create_borrowed_string_value(json_arena_t* arena, const char* value, const size_t length) {
+    if (value == nullptr) {
+        return nullptr;
+    }
+
+    return json_arena_push_value(arena, (json_value_t) {
+        .type = JSON_STRING,
+        .string_value = {
+            .length = length,
+            .value = (char*) value,
+        },
+    });
+}
+
 json_value_t* json_create_empty_array(json_arena_t* arena) {
     return json_arena_push_value(arena, (json_value_t) {
         .type = JSON_ARRAY,
@@ -170,27 +417,20 @@ json_value_t* json_create_empty_object(json_arena_t* arena) {
 
 json_member_entry_t* json_create_array_member(json_arena_t* arena, const int key, json_value_t* value) {
     // @todo assert value is in arena
-    if (arena->key_pool_used >= arena->key_pool_size) {
-        return nullptr;
-    }
-
-    const size_t index = arena->key_pool_used++;
-    arena->key_pool[index] = (json_member_entry_t) {
+    return json_arena_push_member(arena, (json_member_entry_t) {
         .key_int = key,
         .key_str = nullptr,
         .value = value,
         .next = nullptr,
-    };
-
-    return &arena->key_pool[index];
+    });
 }
 
 json_member_entry_t* json_create_object_member(json_arena_t* arena, const char* key, size_t key_length) {
-    if (key == nullptr || arena->string_pool_used >= arena->string_pool_size) {
+    if (key == nullptr) {
         return nullptr;
     }
 
-    if (arena->key_pool_used >= arena->key_pool_size) {
+    if (arena->mode == JSON_ARENA_POOLS && (arena->string_pool_used >= arena->string_pool_size || arena->key_pool_used >= arena->key_pool_size)) {
         return nullptr;
     }
 
@@ -200,13 +440,23 @@ json_member_entry_t* json_create_object_member(json_arena_t* arena, const char*
         return nullptr;
     }
 
-    const size_t index = arena->key_pool_used++;
-    arena->key_pool[index] = (json_member_entry_t) {
+    return json_arena_push_member(arena, (json_member_entry_t) {
         .key_int = (int) keystr.length,
         .key_str = keystr.value,
         .value = nullptr,
         .next = nullptr,
-    };
+    });
+}
 
-    return &arena->key_pool[index];
+json_member_entry_t* json_create_borrowed_object_member(json_arena_t* arena, const char* key, const size_t key_length) {
+    if (key == nullptr) {
+        return nullptr;
+    }
+
+    return json_arena_push_member(arena, (json_member_entry_t) {
+        .key_int = (int) key_length,
+        .key_str = (char*) key,
+        .value = nullptr,
+        .next = nullptr,
+    });
 }
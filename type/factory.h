@@ -5,9 +5,66 @@
 #ifndef JSON_TYPES_FACTORY_H
 #define JSON_TYPES_FACTORY_H
 
+#include <sys/types.h>
+
 #include "types.h"
 
+typedef enum: uint8_t {
+    /**
+     * The arena is split in three fixed pools, one for strings, one for values and one for object and array members.
+     * The allocation fails when the needed pool is full, even if the other ones are not.
+     */
+    JSON_ARENA_POOLS,
+
+    /**
+     * Strings, values and members are allocated from a single bump region, which is extended by blocks
+     * requested to the allocator when it is exhausted.
+     */
+    JSON_ARENA_CHAINED,
+} json_arena_mode_t;
+
+/**
+ * Header of a memory block of a chained arena, followed by its data.
+ * The blocks are kept when the arena is reset, and reused in order, so only `json_arena_release()` frees them.
+ */
+typedef struct json_arena_block_t {
+    struct json_arena_block_t* next;
+
+    /**
+     * The number of bytes following the header
+     */
+    size_t size;
+} json_arena_block_t;
+
+/**
+ * Source of the blocks of a chained arena.
+ */
+typedef struct {
+    /**
+     * Allocate a block of the given size, or return nullptr on failure.
+     * If this function is nullptr, the arena cannot grow, and fails once its initial region is exhausted.
+     */
+    void* (*allocate)(void* context, size_t size);
+
+    /**
+     * Free a block returned by allocate, with its size.
+     */
+    void (*release)(void* context, void* block, size_t size);
+
+    /**
+     * Passed as is to the allocate and release functions
+     */
+    void* context;
+
+    /**
+     * The minimal size of the allocated blocks, including their header. Larger blocks are allocated for larger strings.
+     */
+    size_t block_size;
+} json_arena_allocator_t;
+
 typedef struct {
+    json_arena_mode_t mode;
+
     char* string_pool;
     size_t string_pool_size;
     size_t string_pool_used;
@@ -19,24 +76,112 @@ typedef struct {
     json_member_entry_t* key_pool;
     size_t key_pool_size;
     size_t key_pool_used;
+
+    // Chained mode only: the pool sizes are 0, and the used counters are only statistics
+
+    json_arena_allocator_t allocator;
+
+    /**
+     * The block following the arena structure, first of the chain
+     */
+    json_arena_block_t* first_block;
+    json_arena_block_t* current_block;
+
+    /**
+     * The next free byte of the current block
+     */
+    char* bump;
 } json_arena_t;
 
 /**
  * Compute the expected size of a json arena given the sizes of its pools.
+ * The string pool is padded to the alignment of the values, so any string pool size can be used.
  */
 size_t json_arena_size(size_t string_pool_size, size_t value_pool_size, size_t key_pool_size);
 
 // @todo error for incohérent sizes
 bool json_arena_init(json_arena_t* arena, size_t arena_size, size_t string_pool_size, size_t value_pool_size, size_t key_pool_size);
 
+/**
+ * Initialize a chained arena, which allocates strings, values and members from a single bump region.
+ * The memory following the arena structure is the first block: when it is exhausted, new blocks of at least
+ * `allocator.block_size` bytes are requested to the allocator, so the parsing only fails if the allocator does.
+ *
+ * @param arena_size The size of the memory of the arena, including the arena structure and the first block header.
+ * @param allocator The source of the next blocks. Its allocate function can be nullptr to use only the first block.
+ * @return false if the arena size cannot hold the arena structure and a block header.
+ */
+bool json_arena_init_chained(json_arena_t* arena, size_t arena_size, json_arena_allocator_t allocator);
+
+/**
+ * Release all the values and strings of the arena, so it can be reused for another document.
+ * All the values previously created with this arena become invalid.
+ * The blocks of a chained arena are kept, to be reused by the next allocations.
+ */
+void json_arena_reset(json_arena_t* arena);
+
+/**
+ * Position of an arena, to undo the allocations made after it with `json_arena_rollback()`.
+ */
+typedef struct {
+    size_t string_pool_used;
+    size_t value_pool_used;
+    size_t key_pool_used;
+
+    // Chained mode only
+    json_arena_block_t* block;
+    char* bump;
+} json_arena_mark_t;
+
+/**
+ * Get the current position of the arena.
+ */
+json_arena_mark_t json_arena_mark(const json_arena_t* arena);
+
+/**
+ * Release all the values and strings allocated since the mark, in constant time, e.g. after a failed or discarded parse.
+ * The values created after the mark become invalid, the ones created before stay valid.
+ * The blocks of a chained arena are kept, to be reused by the next allocations.
+ *
+ * @param mark A mark of this arena, taken after its last reset.
+ */
+void json_arena_rollback(json_arena_t* arena, json_arena_mark_t mark);
+
+/**
+ * Reset the arena, and free the blocks allocated for a chained arena, keeping only its first block.
+ * The arena memory itself is not freed.
+ */
+void json_arena_release(json_arena_t* arena);
+
+/**
+ * Decode the escape sequences of a raw JSON string, including its surrounding quotes, into the output buffer.
+ * The output is not null-terminated. It can start right after the opening quote of the raw string, to decode it in place,
+ * as the decoded content is never longer than the raw one.
+ *
+ * @return The length of the decoded string, or -1 if the output buffer is too small.
+ */
+ssize_t json_decode_raw_string(const char* raw, size_t raw_length, char* output, size_t output_size);
+
 json_value_t* json_create_null_value(json_arena_t* arena);
 json_value_t* json_create_bool_value(json_arena_t* arena, bool value);
 json_value_t* json_create_number_value(json_arena_t* arena, double value);
+json_value_t* json_create_integer_value(json_arena_t* arena, int64_t value);
 json_value_t* json_create_string_value(json_arena_t* arena, const char* str, size_t length);
+
+/**
+ * Create a string value pointing to already decoded content, without the surrounding quotes.
+ * The content is not copied into the arena, so it must outlive the value, and must not be modified through it.
+ */
+json_value_t* json_create_borrowed_string_value(json_arena_t* arena, const char* value, size_t length);
 json_value_t* json_create_empty_array(json_arena_t* arena);
 json_value_t* json_create_empty_object(json_arena_t* arena);
 json_member_entry_t* json_create_array_member(json_arena_t* arena, int key, json_value_t* value);
 json_member_entry_t* json_create_object_member(json_arena_t* arena, const char* key, size_t key_length);
+
+/**
+ * Create an object member with a key pointing to already decoded content, like `json_create_borrowed_string_value()`.
+ */
+json_member_entry_t* json_create_borrowed_object_member(json_arena_t* arena, const char* key, size_t key_length);
 // json_value_t json_create_object_value(const json_string_t* keys, const json_value_t* values, size_t length);
 
 #endif //JSON_TYPES_FACTORY_H
\ No newline at end of file
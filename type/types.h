@@ -15,6 +15,7 @@ typedef enum {
     JSON_STRING,
     JSON_ARRAY,
     JSON_OBJECT,
+    JSON_INTEGER,
 } json_type_enum_t;
 
 struct json_value_t;
@@ -65,6 +66,7 @@ typedef struct json_value_t {
     union {
         bool bool_value;
         double number_value;
+        int64_t integer_value;
         json_string_t string_value;
         json_array_t array_value;
         json_object_t object_value;